@@ -1,15 +1,20 @@
 #ifndef ABBONATI_H
 #define ABBONATI_H
 
+#include <stdint.h>
+#include <time.h>
+
 #define MAX_CARATTERI 50 // Dimensione massima per i campi stringa
 
 // Struttura dell'abbonato
 typedef struct abbonato 
 {
     char *chiave; // Stringa univoca per identificare l'abbonato
+    uint64_t hash; // Hash a 64 bit della chiave, calcolato una sola volta all'inserimento
     char nomeutente[MAX_CARATTERI]; // Nome utente
     char password[MAX_CARATTERI]; // Password
     int lezioni_rimanenti; // Numero di lezioni rimanenti
+    time_t ultima_attivita; // Ultimo accesso, prenotazione, ricarica o disdetta
     struct abbonato *prossimo; // Puntatore al prossimo abbonato
 } abbonato;
 
@@ -0,0 +1,536 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "abbonati.h"
+#include "hash.h"
+#include "utile_hash.h"
+#include "abbonati_bin.h"
+
+#define MAGIA "SFITBIN1" // Primi 8 byte di ogni archivio
+#define VERSIONE 1
+#define SLOT_MINIMI 16 // Slot minimi dell'indice (sempre una potenza di due)
+#define MASSIMO_NOME_FILE 256
+
+_Static_assert(sizeof(record_abbonato) == 128, "record_abbonato deve occupare 128 byte");
+
+// Intestazione di 64 byte all'inizio del file. Gli interi sono nell'ordine dei byte della macchina
+struct intestazione
+{
+	char magia[8];
+	uint32_t versione;
+	uint32_t dimensione_record; // sizeof(record_abbonato) al momento della scrittura
+	uint64_t numero_record;
+	uint64_t numero_slot; // Slot dell'indice, potenza di due
+	uint64_t inizio_record; // Posizione nel file del primo record
+	uint64_t inizio_indice; // Posizione nel file del primo slot dell'indice
+	uint64_t dimensione_testo; // Dimensione e data di modifica (in nanosecondi) del file di testo
+	int64_t modifica_testo; // da cui l'archivio è stato scritto, entrambe 0 se non c'è
+};
+
+// Archivio aperto
+struct c_archivio
+{
+	int descrittore;
+	void *mappa;
+	size_t dimensione;
+	record_abbonato *record;
+	uint64_t numero_record;
+	uint32_t *indice; // 0 = slot vuoto, altrimenti posizione del record più uno
+	uint64_t maschera; // numero_slot - 1
+	uint8_t *esclusi; // Un byte per record, 1 se la riserva non lo restituisce più; NULL finché nessuno è escluso
+	uint64_t rimasti; // Record non esclusi
+};
+
+// Contenuto di un archivio preparato in memoria da converti_testo_in_bin
+struct archivio_in_costruzione
+{
+	record_abbonato *record;
+	uint64_t numero_record;
+	uint32_t *indice;
+	uint64_t maschera;
+};
+
+static int intestazione_valida(const struct intestazione *t, size_t dimensione);
+static void aggiungi_record(abbonato *corrente, void *archivio);
+static int stato_testo(const char *nome_testo, uint64_t *dimensione, int64_t *modifica);
+static void copia_record(const record_abbonato *r, abbonato *copia);
+static int escludi_record(archivio_abbonati a, const record_abbonato *r);
+static int preleva_archivio(void *archivio, const char *chiave, abbonato *copia);
+static int escludi_archivio(void *archivio, const char *chiave);
+static void visita_archivio(void *archivio, void (*visita)(abbonato *, void *), void *dati);
+static int rimasti_archivio(void *archivio);
+
+/* Funzione: apri_archivio
+*
+* Apre un archivio binario degli abbonati mappandolo in memoria
+*
+* Descrizione:
+* Il file viene mappato per intero con MAP_SHARED: le ricerche leggono record e indice
+* direttamente dalla page cache e le scritture sui record finiscono nel file senza
+* bisogno di riscriverlo. Prima di usarlo vengono controllati l'intestazione e che
+* record e indice stiano dentro il file, così un file troncato o estraneo non viene letto
+* oltre la fine della mappa
+*
+* Parametri:
+* nome_file: nome del file .bin
+*
+* Pre-condizione:
+* nome_file è un puntatore a stringa non nullo
+*
+* Post-condizione:
+* Restituisce l'archivio aperto, NULL se il file non esiste o non è un archivio valido
+*
+* Side-effect:
+* Apre il file e lo mappa in memoria in lettura e scrittura
+*/
+archivio_abbonati apri_archivio(const char *nome_file)
+{
+	int descrittore = open(nome_file, O_RDWR);
+	if (descrittore < 0)
+		return NULL;
+
+	struct stat info;
+	if (fstat(descrittore, &info) != 0 || (size_t)info.st_size < sizeof(struct intestazione))
+	{
+		close(descrittore);
+		return NULL;
+	}
+
+	size_t dimensione = info.st_size;
+	void *mappa = mmap(NULL, dimensione, PROT_READ | PROT_WRITE, MAP_SHARED, descrittore, 0);
+	if (mappa == MAP_FAILED)
+	{
+		close(descrittore);
+		return NULL;
+	}
+
+	const struct intestazione *t = mappa;
+	archivio_abbonati a = malloc(sizeof(struct c_archivio));
+	if (!intestazione_valida(t, dimensione) || a == NULL)
+	{
+		free(a);
+		munmap(mappa, dimensione);
+		close(descrittore);
+		return NULL;
+	}
+
+	a->descrittore = descrittore;
+	a->mappa = mappa;
+	a->dimensione = dimensione;
+	a->record = (record_abbonato *)((char *)mappa + t->inizio_record);
+	a->numero_record = t->numero_record;
+	a->indice = (uint32_t *)((char *)mappa + t->inizio_indice);
+	a->maschera = t->numero_slot - 1;
+	a->esclusi = NULL;
+	a->rimasti = a->numero_record;
+	return a;
+}
+
+/* Funzione: cerca_archivio
+*
+* Cerca nell'indice dell'archivio il record con il nome utente indicato
+*
+* Descrizione:
+* L'indice è a indirizzamento aperto con sondaggio lineare e viene riempito al più per metà,
+* quindi una ricerca legge in media poco più di uno slot. Come nella tabella hash,
+* strcmp viene chiamata solo sui record il cui hash memorizzato coincide con quello cercato.
+* L'hash è sempre hash_chiave, indipendentemente da imposta_funzione_hash, perché fa parte del formato
+*
+* Post-condizione:
+* Restituisce il puntatore al record nel file mappato, NULL se non presente
+*/
+record_abbonato *cerca_archivio(archivio_abbonati a, const char *nomeutente)
+{
+	uint64_t hash = hash_chiave(nomeutente);
+	uint64_t i = hash & a->maschera;
+
+	// Al più un giro dell'indice, anche se il file è stato danneggiato e non ha slot vuoti
+	for (uint64_t passi = 0; passi <= a->maschera; passi++, i = (i + 1) & a->maschera)
+	{
+		uint32_t slot = a->indice[i];
+		if (slot == 0 || slot > a->numero_record)
+			return NULL;
+
+		record_abbonato *r = &a->record[slot - 1];
+		if (r->hash == hash && strncmp(r->nomeutente, nomeutente, MAX_CARATTERI) == 0)
+			return r;
+	}
+	return NULL;
+}
+
+/* Funzione: aggiorna_lezioni_archivio
+*
+* Aggiorna sul posto le lezioni rimanenti di un record e la data dell'ultima attività
+*/
+void aggiorna_lezioni_archivio(record_abbonato *r, int lezioni_rimanenti, time_t ultima_attivita)
+{
+	r->lezioni_rimanenti = lezioni_rimanenti;
+	r->ultima_attivita = ultima_attivita;
+}
+
+/* Funzione: archivio_aggiornato
+*
+* Controlla se l'archivio è stato scritto dalla versione attuale del file di testo
+*
+* Descrizione:
+* Confronta dimensione e data di modifica del file di testo con quelle registrate
+* nell'intestazione da salva_archivio. Un archivio senza file di origine non è mai aggiornato
+*/
+int archivio_aggiornato(archivio_abbonati a, const char *nome_testo)
+{
+	const struct intestazione *t = a->mappa;
+	uint64_t dimensione;
+	int64_t modifica;
+	if (!stato_testo(nome_testo, &dimensione, &modifica))
+		return 0;
+
+	return t->modifica_testo != 0 && t->dimensione_testo == dimensione && t->modifica_testo == modifica;
+}
+
+/* Funzione: riserva_archivio
+*
+* Restituisce la riserva con cui una tabella hash legge gli abbonati dall'archivio solo quando servono
+*
+* Descrizione:
+* Nessun record viene copiato: preleva cerca il nome nell'indice mappato e copia solo quel record,
+* visita scorre i record in ordine saltando gli esclusi. Gli esclusi sono segnati in un byte
+* per record allocato al primo bisogno, quindi collegare la riserva non legge l'archivio
+*/
+riserva_hash riserva_archivio(archivio_abbonati a)
+{
+	riserva_hash riserva = { a, preleva_archivio, escludi_archivio, visita_archivio, rimasti_archivio };
+	return riserva;
+}
+
+/* Funzione: numero_archivio
+*
+* Restituisce il numero di record dell'archivio
+*/
+int numero_archivio(archivio_abbonati a)
+{
+	return a->numero_record;
+}
+
+/* Funzione: chiudi_archivio
+*
+* Scrive su disco le modifiche e chiude l'archivio
+*
+* Descrizione:
+* msync attende che le pagine modificate siano scritte nel file prima di togliere la mappa
+*/
+void chiudi_archivio(archivio_abbonati a)
+{
+	if (a == NULL)
+		return;
+
+	msync(a->mappa, a->dimensione, MS_SYNC);
+	munmap(a->mappa, a->dimensione);
+	close(a->descrittore);
+	free(a->esclusi);
+	free(a);
+}
+
+/* Funzione: converti_testo_in_bin
+*
+* Crea un archivio binario a partire dal file di testo degli abbonati
+*
+* Descrizione:
+* Il file di testo viene caricato con carica_abbonati (che scarta i nomi duplicati)
+* e la tabella viene scritta con salva_archivio
+*
+* Post-condizione:
+* Restituisce il numero di abbonati scritti, -1 in caso di errore
+*
+* Side-effect:
+* Lettura e scrittura su file
+*/
+int converti_testo_in_bin(const char *nome_testo, const char *nome_bin)
+{
+	// carica_abbonati crea una tabella vuota se il file manca: qui è un errore
+	FILE *prova = fopen(nome_testo, "r");
+	if (prova == NULL)
+		return -1;
+	fclose(prova);
+
+	tabella_hash h = carica_abbonati(nome_testo);
+	if (h == NULL)
+		return -1;
+
+	int scritti = salva_archivio(h, nome_bin, nome_testo);
+	distruggi_hash(h);
+	return scritti;
+}
+
+/* Funzione: salva_archivio
+*
+* Scrive un archivio binario con gli abbonati di una tabella hash
+*
+* Descrizione:
+* I record vengono scritti nell'ordine di visita e ognuno viene inserito nell'indice,
+* dimensionato alla più piccola potenza di due che sia almeno il doppio dei record.
+* Nell'intestazione vengono registrate dimensione e data di modifica di nome_testo,
+* che archivio_aggiornato confronta poi con quelle attuali.
+* Il risultato viene scritto in nome_bin.tmp e rinominato solo a scrittura completata
+*
+* Post-condizione:
+* Restituisce il numero di abbonati scritti, -1 in caso di errore
+*
+* Side-effect:
+* Scrittura su file, allocazione temporanea di record e indice
+*/
+int salva_archivio(tabella_hash h, const char *nome_bin, const char *nome_testo)
+{
+	struct archivio_in_costruzione c;
+	uint64_t numero_slot = SLOT_MINIMI;
+	while (numero_slot < 2 * (uint64_t)numero_abbonati_hash(h))
+		numero_slot *= 2;
+	c.record = calloc(numero_abbonati_hash(h) + 1, sizeof(record_abbonato));
+	c.indice = calloc(numero_slot, sizeof(uint32_t));
+	c.numero_record = 0;
+	c.maschera = numero_slot - 1;
+	if (c.record == NULL || c.indice == NULL)
+	{
+		free(c.record);
+		free(c.indice);
+		return -1;
+	}
+	visita_hash(h, aggiungi_record, &c);
+
+	struct intestazione t;
+	memset(&t, 0, sizeof(t));
+	memcpy(t.magia, MAGIA, sizeof(t.magia));
+	t.versione = VERSIONE;
+	t.dimensione_record = sizeof(record_abbonato);
+	t.numero_record = c.numero_record;
+	t.numero_slot = numero_slot;
+	t.inizio_record = sizeof(struct intestazione);
+	t.inizio_indice = t.inizio_record + c.numero_record * sizeof(record_abbonato);
+	if (nome_testo != NULL)
+		stato_testo(nome_testo, &t.dimensione_testo, &t.modifica_testo);
+
+	// Scrive in un file temporaneo e lo sostituisce all'archivio solo se è completo
+	char temporaneo[MASSIMO_NOME_FILE];
+	snprintf(temporaneo, sizeof(temporaneo), "%s.tmp", nome_bin);
+	FILE *file = fopen(temporaneo, "wb");
+	int scritto = file != NULL &&
+		fwrite(&t, sizeof(t), 1, file) == 1 &&
+		fwrite(c.record, sizeof(record_abbonato), c.numero_record, file) == c.numero_record &&
+		fwrite(c.indice, sizeof(uint32_t), numero_slot, file) == numero_slot;
+	if (file != NULL && fclose(file) != 0)
+		scritto = 0;
+
+	free(c.record);
+	free(c.indice);
+
+	if (!scritto || rename(temporaneo, nome_bin) != 0)
+	{
+		remove(temporaneo);
+		return -1;
+	}
+	return t.numero_record;
+}
+
+/* Funzione: converti_bin_in_testo
+*
+* Scrive il file di testo degli abbonati a partire da un archivio binario
+*
+* Descrizione:
+* I record vengono scritti nell'ordine in cui compaiono nell'archivio,
+* nello stesso formato usato da salva_abbonati
+*
+* Post-condizione:
+* Restituisce il numero di abbonati scritti, -1 in caso di errore
+*/
+int converti_bin_in_testo(const char *nome_bin, const char *nome_testo)
+{
+	archivio_abbonati a = apri_archivio(nome_bin);
+	if (a == NULL)
+		return -1;
+
+	FILE *file = fopen(nome_testo, "w");
+	if (file == NULL)
+	{
+		chiudi_archivio(a);
+		return -1;
+	}
+
+	for (uint64_t i = 0; i < a->numero_record; i++)
+	{
+		const record_abbonato *r = &a->record[i];
+		fprintf(file, "%.*s;%.*s;%d;%lld\n", MAX_CARATTERI, r->nomeutente, MAX_CARATTERI, r->password,
+			r->lezioni_rimanenti, (long long)r->ultima_attivita);
+	}
+
+	int numero = a->numero_record;
+	int errore = fclose(file) != 0;
+	chiudi_archivio(a);
+	return errore ? -1 : numero;
+}
+
+/* Funzione: intestazione_valida
+*
+* Controlla che l'intestazione descriva un archivio di questa versione contenuto nel file
+*
+* Post-condizione:
+* Restituisce 1 se magia, versione e dimensione dei record coincidono, se il numero di slot
+* è una potenza di due maggiore del numero di record e se record e indice stanno nel file
+*/
+static int intestazione_valida(const struct intestazione *t, size_t dimensione)
+{
+	if (memcmp(t->magia, MAGIA, sizeof(t->magia)) != 0 || t->versione != VERSIONE ||
+		t->dimensione_record != sizeof(record_abbonato))
+		return 0;
+
+	if (t->numero_slot == 0 || (t->numero_slot & (t->numero_slot - 1)) != 0 ||
+		t->numero_record >= t->numero_slot || t->numero_slot > UINT32_MAX)
+		return 0;
+
+	if (t->inizio_record < sizeof(struct intestazione) || t->inizio_record % sizeof(uint64_t) != 0 ||
+		t->inizio_indice % sizeof(uint32_t) != 0 || t->inizio_record > dimensione ||
+		t->inizio_indice > dimensione)
+		return 0;
+
+	return t->numero_record <= (dimensione - t->inizio_record) / sizeof(record_abbonato) &&
+		t->numero_slot <= (dimensione - t->inizio_indice) / sizeof(uint32_t);
+}
+
+/* Funzione: aggiungi_record
+*
+* Copia un abbonato nel prossimo record libero e lo inserisce nell'indice (usata con visita_hash)
+*/
+static void aggiungi_record(abbonato *corrente, void *archivio)
+{
+	struct archivio_in_costruzione *c = archivio;
+	record_abbonato *r = &c->record[c->numero_record];
+
+	// I record sono azzerati: i byte dopo il terminatore non portano nel file resti di memoria
+	memcpy(r->nomeutente, corrente->nomeutente, strnlen(corrente->nomeutente, MAX_CARATTERI - 1));
+	memcpy(r->password, corrente->password, strnlen(corrente->password, MAX_CARATTERI - 1));
+	r->lezioni_rimanenti = corrente->lezioni_rimanenti;
+	r->ultima_attivita = corrente->ultima_attivita;
+	r->hash = hash_chiave(r->nomeutente);
+
+	uint64_t i = r->hash & c->maschera;
+	while (c->indice[i] != 0)
+		i = (i + 1) & c->maschera;
+	c->indice[i] = ++c->numero_record;
+}
+
+/* Funzione: stato_testo
+*
+* Legge dimensione e data di modifica, in nanosecondi, del file di testo degli abbonati
+*
+* Post-condizione:
+* Restituisce 1 se il file esiste, altrimenti 0 e lascia invariati i valori
+*/
+static int stato_testo(const char *nome_testo, uint64_t *dimensione, int64_t *modifica)
+{
+	struct stat info;
+	if (stat(nome_testo, &info) != 0)
+		return 0;
+
+	*dimensione = info.st_size;
+	*modifica = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+	return 1;
+}
+
+/* Funzione: copia_record
+*
+* Copia un record dell'archivio in un abbonato, con nome e password sempre terminati
+*/
+static void copia_record(const record_abbonato *r, abbonato *copia)
+{
+	memcpy(copia->nomeutente, r->nomeutente, MAX_CARATTERI);
+	copia->nomeutente[MAX_CARATTERI - 1] = '\0';
+	memcpy(copia->password, r->password, MAX_CARATTERI);
+	copia->password[MAX_CARATTERI - 1] = '\0';
+	copia->lezioni_rimanenti = r->lezioni_rimanenti;
+	copia->ultima_attivita = (time_t)r->ultima_attivita;
+	copia->hash = r->hash;
+	copia->chiave = copia->nomeutente;
+	copia->prossimo = NULL;
+}
+
+/* Funzione: escludi_record
+*
+* Segna il record come escluso dalla riserva, allocando i segni al primo bisogno
+*
+* Post-condizione:
+* Restituisce 1 se il record non era già escluso, 0 se lo era o se l'allocazione è fallita
+*/
+static int escludi_record(archivio_abbonati a, const record_abbonato *r)
+{
+	if (a->esclusi == NULL)
+	{
+		a->esclusi = calloc(a->numero_record, 1);
+		if (a->esclusi == NULL)
+			return 0;
+	}
+
+	uint64_t i = r - a->record;
+	if (a->esclusi[i])
+		return 0;
+	a->esclusi[i] = 1;
+	a->rimasti--;
+	return 1;
+}
+
+/* Funzione: preleva_archivio
+*
+* Copia il record con il nome indicato e lo esclude dalla riserva (usata da riserva_archivio)
+*/
+static int preleva_archivio(void *archivio, const char *chiave, abbonato *copia)
+{
+	archivio_abbonati a = archivio;
+	const record_abbonato *r = cerca_archivio(a, chiave);
+	if (r == NULL || !escludi_record(a, r))
+		return 0;
+
+	copia_record(r, copia);
+	return 1;
+}
+
+/* Funzione: escludi_archivio
+*
+* Esclude dalla riserva il record con il nome indicato (usata da riserva_archivio)
+*/
+static int escludi_archivio(void *archivio, const char *chiave)
+{
+	archivio_abbonati a = archivio;
+	const record_abbonato *r = cerca_archivio(a, chiave);
+	return r != NULL && escludi_record(a, r);
+}
+
+/* Funzione: visita_archivio
+*
+* Passa a visita una copia temporanea di ogni record non escluso (usata da riserva_archivio)
+*/
+static void visita_archivio(void *archivio, void (*visita)(abbonato *, void *), void *dati)
+{
+	archivio_abbonati a = archivio;
+	for (uint64_t i = 0; i < a->numero_record; i++)
+	{
+		if (a->esclusi != NULL && a->esclusi[i])
+			continue;
+
+		abbonato copia;
+		copia_record(&a->record[i], &copia);
+		visita(&copia, dati);
+	}
+}
+
+/* Funzione: rimasti_archivio
+*
+* Restituisce il numero di record non esclusi (usata da riserva_archivio)
+*/
+static int rimasti_archivio(void *archivio)
+{
+	archivio_abbonati a = archivio;
+	return a->rimasti;
+}
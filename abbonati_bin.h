@@ -0,0 +1,169 @@
+#ifndef ABBONATI_BIN_H
+#define ABBONATI_BIN_H
+
+#include <stdint.h>
+#include "abbonati.h"
+#include "hash.h"
+
+// Archivio binario degli abbonati (abbonati.bin) mappato in memoria
+typedef struct c_archivio *archivio_abbonati;
+
+// Record di dimensione fissa dell'archivio: 128 byte, letti e scritti direttamente nel file mappato
+typedef struct record_abbonato
+{
+	uint64_t hash; // hash_chiave(nomeutente), confrontato prima di strcmp
+	int64_t ultima_attivita; // Secondi dall'epoch
+	int32_t lezioni_rimanenti;
+	char nomeutente[MAX_CARATTERI];
+	char password[MAX_CARATTERI];
+	char riservato[8]; // Porta il record a 128 byte
+} record_abbonato;
+
+/* Funzione: apri_archivio
+*
+* Apre un archivio binario degli abbonati mappandolo in memoria
+*
+* Parametri:
+* nome_file: nome del file .bin
+*
+* Pre-condizione:
+* nome_file è un puntatore a stringa non nullo
+*
+* Post-condizione:
+* Restituisce l'archivio aperto, NULL se il file non esiste o non è un archivio valido.
+* L'apertura non legge i record: le pagine vengono caricate dal sistema al primo accesso
+*
+* Side-effect:
+* Apre il file e lo mappa in memoria in lettura e scrittura
+*/
+archivio_abbonati apri_archivio(const char *nome_file);
+
+/* Funzione: cerca_archivio
+*
+* Cerca nell'indice dell'archivio il record con il nome utente indicato
+*
+* Parametri:
+* a: archivio in cui cercare
+* nomeutente: nome utente da cercare
+*
+* Pre-condizione:
+* a è un archivio aperto, nomeutente è una stringa non nulla
+*
+* Post-condizione:
+* Restituisce il puntatore al record nel file mappato, NULL se non presente.
+* Il puntatore resta valido fino a chiudi_archivio
+*/
+record_abbonato *cerca_archivio(archivio_abbonati a, const char *nomeutente);
+
+/* Funzione: aggiorna_lezioni_archivio
+*
+* Aggiorna sul posto le lezioni rimanenti di un record e la data dell'ultima attività
+*
+* Pre-condizione:
+* r è stato restituito da cerca_archivio su un archivio ancora aperto
+*
+* Side-effect:
+* Scrive nella pagina mappata: il sistema la riporta nel file, al più tardi a chiudi_archivio
+*/
+void aggiorna_lezioni_archivio(record_abbonato *r, int lezioni_rimanenti, time_t ultima_attivita);
+
+/* Funzione: archivio_aggiornato
+*
+* Controlla se l'archivio è stato scritto dalla versione attuale del file di testo
+*
+* Parametri:
+* a: archivio aperto
+* nome_testo: file di testo degli abbonati
+*
+* Post-condizione:
+* Restituisce 1 se dimensione e data di modifica di nome_testo coincidono con quelle
+* registrate da salva_archivio, altrimenti 0 (anche se nome_testo non esiste)
+*/
+int archivio_aggiornato(archivio_abbonati a, const char *nome_testo);
+
+/* Funzione: riserva_archivio
+*
+* Restituisce la riserva con cui una tabella hash legge gli abbonati dall'archivio solo quando servono
+*
+* Parametri:
+* a: archivio aperto
+*
+* Pre-condizione:
+* a è un archivio aperto, collegato a una sola tabella con collega_riserva_hash
+*
+* Post-condizione:
+* La tabella collegata copia un record alla prima ricerca del suo nome; i record copiati
+* o rimossi dalla tabella restano esclusi finché l'archivio è aperto.
+* L'archivio va chiuso solo dopo stacca_riserva_hash o distruggi_hash sulla tabella
+*
+* Side-effect:
+* Alla prima esclusione alloca un byte per record
+*/
+riserva_hash riserva_archivio(archivio_abbonati a);
+
+/* Funzione: numero_archivio
+*
+* Restituisce il numero di record dell'archivio
+*/
+int numero_archivio(archivio_abbonati a);
+
+/* Funzione: chiudi_archivio
+*
+* Scrive su disco le modifiche e chiude l'archivio
+*
+* Pre-condizione:
+* a è un archivio aperto oppure NULL
+*
+* Post-condizione:
+* I puntatori restituiti da cerca_archivio non sono più validi
+*/
+void chiudi_archivio(archivio_abbonati a);
+
+/* Funzione: converti_testo_in_bin
+*
+* Crea un archivio binario a partire dal file di testo degli abbonati
+*
+* Parametri:
+* nome_testo: file nel formato "nomeutente;password;lezioni[;ultima_attivita]"
+* nome_bin: archivio da creare o sostituire
+*
+* Post-condizione:
+* Restituisce il numero di abbonati scritti, -1 in caso di errore
+*
+* Side-effect:
+* Scrive un file temporaneo e lo rinomina in nome_bin, così un archivio aperto da altri
+* non viene mai visto scritto a metà
+*/
+int converti_testo_in_bin(const char *nome_testo, const char *nome_bin);
+
+/* Funzione: salva_archivio
+*
+* Scrive un archivio binario con gli abbonati di una tabella hash
+*
+* Parametri:
+* h: tabella da scrivere
+* nome_bin: archivio da creare o sostituire
+* nome_testo: file di testo con lo stesso contenuto, registrato per archivio_aggiornato; NULL se non c'è
+*
+* Post-condizione:
+* Restituisce il numero di abbonati scritti, -1 in caso di errore
+*
+* Side-effect:
+* Scrive un file temporaneo e lo rinomina in nome_bin
+*/
+int salva_archivio(tabella_hash h, const char *nome_bin, const char *nome_testo);
+
+/* Funzione: converti_bin_in_testo
+*
+* Scrive il file di testo degli abbonati a partire da un archivio binario
+*
+* Parametri:
+* nome_bin: archivio da leggere
+* nome_testo: file di testo da creare o sostituire
+*
+* Post-condizione:
+* Restituisce il numero di abbonati scritti, -1 in caso di errore
+*/
+int converti_bin_in_testo(const char *nome_bin, const char *nome_testo);
+
+#endif
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "arena.h"
+
+#define ALLINEAMENTO _Alignof(max_align_t) // Ogni allocazione è allineata per qualunque tipo
+
+// Blocco di memoria da cui vengono ritagliate le allocazioni
+struct blocco
+{
+	struct blocco *prossimo;
+	size_t usati;
+	size_t capacita;
+	_Alignas(max_align_t) unsigned char dati[];
+};
+
+// Struttura dell'arena
+struct c_arena
+{
+	struct blocco *corrente; // Blocco in uso, in testa alla lista dei blocchi
+	size_t dimensione_blocco;
+	size_t byte_totali;
+};
+
+/* Funzione: nuova_arena
+*
+* Crea un'arena vuota da cui allocare memoria con un semplice avanzamento di puntatore
+*
+* Descrizione:
+* Il primo blocco viene allocato alla prima richiesta, così un'arena mai usata costa
+* solo la sua struttura principale
+*
+* Parametri:
+* dimensione_blocco: byte richiesti al sistema ogni volta che il blocco corrente si esaurisce
+*
+* Pre-condizione:
+* dimensione_blocco>0
+*
+* Post-condizione:
+* Restituisce un'arena vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per la struttura dell'arena
+*/
+arena nuova_arena(size_t dimensione_blocco)
+{
+	arena a = malloc(sizeof(struct c_arena));
+	if (a == NULL)
+		return NULL;
+
+	a->corrente = NULL;
+	a->dimensione_blocco = dimensione_blocco;
+	a->byte_totali = 0;
+	return a;
+}
+
+/* Funzione: alloca_arena
+*
+* Riserva 'dimensione' byte nell'arena
+*
+* Descrizione:
+* La dimensione viene arrotondata all'allineamento. Se il blocco corrente non ha spazio
+* sufficiente ne viene allocato uno nuovo, grande almeno quanto la richiesta; lo spazio
+* rimasto libero nel blocco precedente non viene più usato
+*
+* Pre-condizione:
+* a è un'arena valida
+*
+* Post-condizione:
+* Restituisce un puntatore allineato per qualunque tipo, valido fino a distruggi_arena,
+* oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Può allocare un nuovo blocco
+*/
+void *alloca_arena(arena a, size_t dimensione)
+{
+	dimensione = (dimensione + ALLINEAMENTO - 1) & ~(size_t)(ALLINEAMENTO - 1);
+
+	struct blocco *b = a->corrente;
+	if (b == NULL || b->capacita - b->usati < dimensione)
+	{
+		size_t capacita = dimensione > a->dimensione_blocco ? dimensione : a->dimensione_blocco;
+		b = malloc(sizeof(struct blocco) + capacita);
+		if (b == NULL)
+			return NULL;
+
+		b->usati = 0;
+		b->capacita = capacita;
+		b->prossimo = a->corrente;
+		a->corrente = b;
+		a->byte_totali += capacita;
+	}
+
+	void *p = b->dati + b->usati;
+	b->usati += dimensione;
+	return p;
+}
+
+/* Funzione: copia_stringa_arena
+*
+* Copia la stringa s (terminatore compreso) nell'arena
+*
+* Pre-condizione:
+* a è un'arena valida, s è una stringa terminata da \0
+*
+* Post-condizione:
+* Restituisce la copia oppure NULL se l'allocazione fallisce
+*/
+char *copia_stringa_arena(arena a, const char *s)
+{
+	size_t lunghezza = strlen(s) + 1;
+	char *copia = alloca_arena(a, lunghezza);
+	if (copia != NULL)
+		memcpy(copia, s, lunghezza);
+	return copia;
+}
+
+/* Funzione: byte_arena
+*
+* Restituisce i byte richiesti al sistema dall'arena (somma delle capacità dei blocchi)
+*/
+size_t byte_arena(arena a)
+{
+	return a->byte_totali;
+}
+
+/* Funzione: distruggi_arena
+*
+* Libera l'arena e tutta la memoria allocata da essa
+*
+* Pre-condizione:
+* a è un'arena valida oppure NULL
+*
+* Side-effect:
+* Libera un blocco alla volta: il costo dipende dal numero di blocchi, non dalle allocazioni
+*/
+void distruggi_arena(arena a)
+{
+	if (a == NULL)
+		return;
+
+	struct blocco *b = a->corrente;
+	while (b != NULL)
+	{
+		struct blocco *prossimo = b->prossimo;
+		free(b);
+		b = prossimo;
+	}
+	free(a);
+}
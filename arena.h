@@ -0,0 +1,72 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+typedef struct c_arena *arena;
+
+/* Funzione: nuova_arena
+*
+* Crea un'arena vuota da cui allocare memoria con un semplice avanzamento di puntatore
+*
+* Parametri:
+* dimensione_blocco: byte richiesti al sistema ogni volta che il blocco corrente si esaurisce
+*
+* Pre-condizione:
+* dimensione_blocco>0
+*
+* Post-condizione:
+* Restituisce un'arena vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per la struttura dell'arena
+*/
+arena nuova_arena(size_t dimensione_blocco);
+
+/* Funzione: alloca_arena
+*
+* Riserva 'dimensione' byte nell'arena
+*
+* Pre-condizione:
+* a è un'arena valida
+*
+* Post-condizione:
+* Restituisce un puntatore allineato per qualunque tipo, valido fino a distruggi_arena,
+* oppure NULL se l'allocazione fallisce. La memoria non viene mai liberata singolarmente
+*
+* Side-effect:
+* Può allocare un nuovo blocco
+*/
+void *alloca_arena(arena a, size_t dimensione);
+
+/* Funzione: copia_stringa_arena
+*
+* Copia la stringa s (terminatore compreso) nell'arena
+*
+* Pre-condizione:
+* a è un'arena valida, s è una stringa terminata da \0
+*
+* Post-condizione:
+* Restituisce la copia oppure NULL se l'allocazione fallisce
+*/
+char *copia_stringa_arena(arena a, const char *s);
+
+/* Funzione: byte_arena
+*
+* Restituisce i byte richiesti al sistema dall'arena (somma delle capacità dei blocchi)
+*/
+size_t byte_arena(arena a);
+
+/* Funzione: distruggi_arena
+*
+* Libera l'arena e tutta la memoria allocata da essa
+*
+* Pre-condizione:
+* a è un'arena valida oppure NULL
+*
+* Side-effect:
+* Libera un blocco alla volta: il costo dipende dal numero di blocchi, non dalle allocazioni
+*/
+void distruggi_arena(arena a);
+
+#endif
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "partecipante.h"
+#include "attesa.h"
+
+// Struttura della lista d'attesa
+struct c_attesa
+{
+	partecipante *vet; // Buffer circolare, NULL finché nessuno si mette in attesa
+	int primo; // Posizione in vet del primo partecipante da servire
+	int numero;
+	int capienza;
+};
+
+/* Funzione: nuova_attesa
+*
+* Crea una lista d'attesa vuota che può contenere al più 'capienza' partecipanti
+*
+* Descrizione:
+* La maggior parte delle lezioni non si riempie mai: il buffer non viene allocato
+* finché qualcuno non si mette in attesa
+*/
+lista_attesa nuova_attesa(int capienza)
+{
+	lista_attesa attesa = malloc(sizeof(struct c_attesa));
+	if (attesa == NULL)
+		return NULL;
+
+	attesa->vet = NULL;
+	attesa->primo = 0;
+	attesa->numero = 0;
+	attesa->capienza = capienza;
+	return attesa;
+}
+
+/* Funzione: accoda_attesa
+*
+* Mette un partecipante in fondo alla lista d'attesa
+*
+* Descrizione:
+* Scrive nella posizione che segue l'ultimo partecipante, tornando all'inizio del buffer
+* quando ne raggiunge la fine
+*/
+int accoda_attesa(lista_attesa attesa, partecipante persona)
+{
+	if (attesa->numero == attesa->capienza || persona == NESSUN_PARTECIPANTE)
+		return 0;
+
+	if (attesa->vet == NULL)
+	{
+		attesa->vet = malloc(attesa->capienza * sizeof(partecipante));
+		if (attesa->vet == NULL)
+			return 0;
+	}
+
+	attesa->vet[(attesa->primo + attesa->numero) % attesa->capienza] = persona;
+	attesa->numero++;
+	return 1;
+}
+
+/* Funzione: preleva_attesa
+*
+* Toglie e restituisce il primo partecipante della lista d'attesa
+*
+* Descrizione:
+* Avanza l'inizio del buffer circolare: nessun elemento viene spostato
+*/
+partecipante preleva_attesa(lista_attesa attesa)
+{
+	if (attesa->numero == 0)
+		return NESSUN_PARTECIPANTE;
+
+	partecipante persona = attesa->vet[attesa->primo];
+	attesa->primo = (attesa->primo + 1) % attesa->capienza;
+	attesa->numero--;
+	return persona;
+}
+
+/* Funzione: rimuovi_attesa
+*
+* Toglie un partecipante dalla lista d'attesa, in qualunque posizione si trovi
+*
+* Descrizione:
+* Sposta indietro di una posizione del buffer circolare tutti quelli che lo seguivano
+*/
+int rimuovi_attesa(lista_attesa attesa, partecipante persona)
+{
+	for (int i = 0; i < attesa->numero; i++)
+	{
+		if (elemento_attesa(attesa, i) == persona)
+		{
+			for (int j = i; j < attesa->numero - 1; j++)
+				attesa->vet[(attesa->primo + j) % attesa->capienza] =
+					attesa->vet[(attesa->primo + j + 1) % attesa->capienza];
+			attesa->numero--;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Funzione: elemento_attesa
+*
+* Restituisce il partecipante in posizione 'posizione' della lista, senza toglierlo
+*/
+partecipante elemento_attesa(lista_attesa attesa, int posizione)
+{
+	if (posizione < 0 || posizione >= attesa->numero)
+		return NESSUN_PARTECIPANTE;
+
+	return attesa->vet[(attesa->primo + posizione) % attesa->capienza];
+}
+
+/* Funzione: contiene_attesa
+*
+* Controlla se un partecipante è nella lista d'attesa
+*
+* Descrizione:
+* La lista è piccola e limitata dalla sua capienza: basta scorrerla
+*/
+int contiene_attesa(lista_attesa attesa, partecipante persona)
+{
+	for (int i = 0; i < attesa->numero; i++)
+	{
+		if (elemento_attesa(attesa, i) == persona)
+			return 1;
+	}
+	return 0;
+}
+
+/* Funzione: dimensione_attesa
+*
+* Restituisce il numero di partecipanti in attesa
+*/
+int dimensione_attesa(lista_attesa attesa)
+{
+	return attesa->numero;
+}
+
+/* Funzione: capienza_attesa
+*
+* Restituisce il numero massimo di partecipanti che la lista può contenere
+*/
+int capienza_attesa(lista_attesa attesa)
+{
+	return attesa->capienza;
+}
+
+/* Funzione: distruggi_attesa
+*
+* Libera la lista d'attesa
+*/
+void distruggi_attesa(lista_attesa attesa)
+{
+	if (attesa == NULL)
+		return;
+
+	free(attesa->vet);
+	free(attesa);
+}
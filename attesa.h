@@ -0,0 +1,111 @@
+#ifndef ATTESA_H
+#define ATTESA_H
+
+#include "partecipante.h"
+
+typedef struct c_attesa *lista_attesa;
+
+/* Funzione: nuova_attesa
+*
+* Crea una lista d'attesa vuota che può contenere al più 'capienza' partecipanti
+*
+* Descrizione:
+* La lista è una coda FIFO su un buffer circolare: chi si mette in attesa per primo
+* è il primo a ricevere un posto liberato. Il buffer viene allocato al primo inserimento
+*
+* Parametri:
+* capienza: numero massimo di partecipanti in attesa
+*
+* Pre-condizione:
+* capienza>0
+*
+* Post-condizione:
+* Restituisce una lista vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per la lista
+*/
+lista_attesa nuova_attesa(int capienza);
+
+/* Funzione: accoda_attesa
+*
+* Mette un partecipante in fondo alla lista d'attesa
+*
+* Parametri:
+* attesa: la lista in cui inserire il partecipante
+* persona: il partecipante da inserire, come restituito da interna_nome
+*
+* Pre-condizione:
+* 'attesa' è una lista inizializzata
+*
+* Post-condizione:
+* Restituisce 1 se il partecipante è stato accodato, 0 se la lista è piena,
+* se persona è NESSUN_PARTECIPANTE o se manca memoria
+*/
+int accoda_attesa(lista_attesa attesa, partecipante persona);
+
+/* Funzione: preleva_attesa
+*
+* Toglie e restituisce il primo partecipante della lista d'attesa
+*
+* Pre-condizione:
+* 'attesa' è una lista inizializzata
+*
+* Post-condizione:
+* Restituisce il partecipante in testa oppure NESSUN_PARTECIPANTE se la lista è vuota
+*/
+partecipante preleva_attesa(lista_attesa attesa);
+
+/* Funzione: rimuovi_attesa
+*
+* Toglie un partecipante dalla lista d'attesa, in qualunque posizione si trovi
+*
+* Descrizione:
+* Chi era dietro di lui avanza di una posizione: l'ordine di arrivo degli altri non cambia
+*
+* Post-condizione:
+* Restituisce 1 se il partecipante è stato tolto, 0 se non era in attesa
+*/
+int rimuovi_attesa(lista_attesa attesa, partecipante persona);
+
+/* Funzione: elemento_attesa
+*
+* Restituisce il partecipante in posizione 'posizione' della lista, senza toglierlo
+*
+* Post-condizione:
+* Restituisce il partecipante (0 è il primo a essere servito) oppure NESSUN_PARTECIPANTE
+* se posizione è fuori dalla lista
+*/
+partecipante elemento_attesa(lista_attesa attesa, int posizione);
+
+/* Funzione: contiene_attesa
+*
+* Controlla se un partecipante è nella lista d'attesa
+*
+* Post-condizione:
+* Restituisce 1 se persona è in attesa, altrimenti 0
+*/
+int contiene_attesa(lista_attesa attesa, partecipante persona);
+
+/* Funzione: dimensione_attesa
+*
+* Restituisce il numero di partecipanti in attesa
+*/
+int dimensione_attesa(lista_attesa attesa);
+
+/* Funzione: capienza_attesa
+*
+* Restituisce il numero massimo di partecipanti che la lista può contenere
+*/
+int capienza_attesa(lista_attesa attesa);
+
+/* Funzione: distruggi_attesa
+*
+* Libera la lista d'attesa
+*
+* Pre-condizione:
+* 'attesa' è una lista inizializzata oppure NULL
+*/
+void distruggi_attesa(lista_attesa attesa);
+
+#endif
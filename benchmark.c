@@ -0,0 +1,1273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "abbonati.h"
+#include "hash.h"
+#include "utile_hash.h"
+#include "abbonati_bin.h"
+#include "hash_concorrente.h"
+#include "coda.h"
+#include "nomi.h"
+#include "utile_coda.h"
+#include "benchmark.h"
+
+#define ABBONATI_BENCHMARK 200000 // Abbonati inseriti nelle tabelle di prova
+#define RICERCHE_BENCHMARK 1000000 // Login simulati
+#define PERCENTUALE_MANCATI 10 // Login con un nome non registrato, in percentuale
+#define LUNGHEZZA_NOME 24 // Spazio per i nomi generati ("utente" / "ospite" + numero)
+#define CHIAVI_DISTRIBUZIONE 99999 // Nomi generati per ogni schema nel benchmark delle funzioni hash
+#define RIPETIZIONI_HASH 20 // Passate sulle chiavi per misurare la velocità delle funzioni hash
+#define FILE_TESTO_BENCHMARK "benchmark_abbonati.txt" // File temporanei del benchmark di avvio
+#define FILE_BIN_BENCHMARK "benchmark_abbonati.bin"
+#define OPERAZIONI_CONCORRENTI 4000000 // Operazioni totali, divise tra i thread, per ogni misura
+#define OGNI_QUANTE_PRENOTAZIONI 10 // Un login riuscito su tanti preleva anche una lezione
+#define ABBONATI_PERFETTO 1000000 // Abbonati del benchmark dell'indice a hash perfetto
+#define ISCRIZIONI_PERFETTO 50000 // Iscrizioni successive alla costruzione, finite nel trabocco
+#define LEZIONI_SALVATAGGIO 20000 // Lezioni del calendario salvato dal benchmark di salva_lezioni
+#define ISCRITTI_SALVATAGGIO 30 // Iscritti di ogni lezione del calendario di prova
+#define NOMI_SALVATAGGIO 5000 // Partecipanti diversi da cui sono scelti gli iscritti
+#define RIPETIZIONI_SALVATAGGIO 5 // Salvataggi misurati per ogni versione
+#define FILE_LEZIONI_BENCHMARK "benchmark_lezioni.txt" // File temporaneo del benchmark di salva_lezioni
+#define RICERCHE_PRENOTAZIONI 200 // Partecipanti cercati in tutto il calendario per ogni versione
+#define PASSATE_PULIZIA 40 // Lezioni già svolte del calendario di prova di pulisci_lezioni_passate
+#define FILE_STORICO_BENCHMARK "benchmark_storico.txt" // File temporaneo del benchmark di pulisci_lezioni_passate
+#define CHIAMATE_GENERAZIONE 200000 // Chiamate misurate di genera_lezioni su un calendario già generato
+
+// Lavoro assegnato a un thread del benchmark concorrente
+struct lavoro_thread
+{
+	tabella_concorrente tabella;
+	char (*login)[LUNGHEZZA_NOME];
+	int inizio; // Primo login della sequenza per questo thread
+	int operazioni;
+	int trovati;
+};
+
+static double secondi(void);
+static uint32_t casuale(uint32_t *stato);
+static char (*genera_login(int ricerche, int abbonati))[LUNGHEZZA_NOME];
+static void misura_login(const char *nome, motore_hash motore, int bloom, char (*login)[LUNGHEZZA_NOME]);
+static void misura_perfetto(const char *nome, motore_hash motore, char (*login)[LUNGHEZZA_NOME]);
+static double tempo_login(tabella_hash h, char (*login)[LUNGHEZZA_NOME], int *trovati);
+static uint64_t hash_fnv1a(const char *chiave);
+static void stampa_distribuzione(const char *etichetta, uint64_t *hash, int n, uint64_t slot, int potenza_di_due);
+static int confronta_hash(const void *a, const void *b);
+static void *esegui_login_concorrenti(void *argomento);
+static void salva_con_copie(lezione *lezioni, int n, const char *nome_file);
+static void carica_una_alla_volta(coda calendario, const char *nome_file);
+static void riempi_lezione(lezione *l, int i, uint32_t *stato);
+static void svuota_calendario(coda calendario);
+static int conta_con_strcmp(char (*posti)[LUNGHEZZA_PARTECIPANTE], int lezioni, const char *nome);
+static int conta_con_ciclo(const partecipante *iscritti, int lezioni, partecipante persona);
+static void pulisci_con_giro(coda calendario, const char *nome_file);
+static coda calendario_da_pulire(int passate);
+static void genera_tutti_i_giorni(coda calendario);
+
+/* Funzione: benchmark_hash_login
+*
+* Confronta il motore a catene e quello a indirizzamento aperto su un traffico di login
+*
+* Descrizione:
+* Prepara una volta sola la sequenza di nomi da cercare, in modo che entrambe le tabelle
+* ricevano esattamente lo stesso traffico, poi misura i due motori uno dopo l'altro,
+* prima senza e poi con il filtro di Bloom davanti alle ricerche.
+*
+* Side-effect:
+* - Alloca memoria per le tabelle di prova
+* - Stampa a video i risultati
+*/
+void benchmark_hash_login(void)
+{
+	printf("\n--- Benchmark: tabella hash su traffico di login ---\n");
+	printf("%d abbonati, %d login (%d%% con nome non registrato)\n\n",
+		ABBONATI_BENCHMARK, RICERCHE_BENCHMARK, PERCENTUALE_MANCATI);
+
+	char (*login)[LUNGHEZZA_NOME] = genera_login(RICERCHE_BENCHMARK, ABBONATI_BENCHMARK);
+	if (login == NULL)
+	{
+		printf("Memoria insufficiente per il benchmark.\n");
+		return;
+	}
+
+	misura_login("Catene", HASH_CATENE, 0, login);
+	misura_login("Indirizzamento aperto", HASH_APERTO, 0, login);
+	misura_login("Catene + Bloom", HASH_CATENE, 1, login);
+	misura_login("Aperto + Bloom", HASH_APERTO, 1, login);
+
+	free(login);
+}
+
+/* Funzione: benchmark_avvio_abbonati
+*
+* Confronta il caricamento del file di testo degli abbonati con l'apertura dell'archivio binario
+*
+* Descrizione:
+* Scrive un file di testo con ABBONATI_BENCHMARK abbonati e lo converte in archivio binario,
+* poi misura per entrambi il tempo prima di poter servire il primo login e il tempo medio
+* dei login successivi. L'ultima riga misura l'avvio usato dal registro quando l'archivio
+* è aggiornato: una tabella hash vuota collegata all'archivio con riserva_archivio, che copia
+* un abbonato alla prima ricerca del suo nome. I due file vengono cancellati alla fine.
+*
+* Side-effect:
+* - Crea e cancella file nella cartella corrente
+* - Stampa a video i risultati
+*/
+void benchmark_avvio_abbonati(void)
+{
+	printf("\n--- Benchmark: avvio da abbonati.txt e da abbonati.bin ---\n");
+	printf("%d abbonati, %d login (%d%% con nome non registrato)\n\n",
+		ABBONATI_BENCHMARK, RICERCHE_BENCHMARK, PERCENTUALE_MANCATI);
+
+	// File di testo nel formato di salva_abbonati
+	FILE *file = fopen(FILE_TESTO_BENCHMARK, "w");
+	if (file == NULL)
+	{
+		printf("Impossibile creare %s.\n", FILE_TESTO_BENCHMARK);
+		return;
+	}
+	for (int i = 0; i < ABBONATI_BENCHMARK; i++)
+		fprintf(file, "utente%d;password;12;%d\n", i, i);
+	fclose(file);
+
+	char (*login)[LUNGHEZZA_NOME] = genera_login(RICERCHE_BENCHMARK, ABBONATI_BENCHMARK);
+	if (login == NULL || converti_testo_in_bin(FILE_TESTO_BENCHMARK, FILE_BIN_BENCHMARK) < 0)
+	{
+		printf("Preparazione del benchmark non riuscita.\n");
+		free(login);
+		remove(FILE_TESTO_BENCHMARK);
+		return;
+	}
+
+	// Testo: fgets e strtok su ogni riga, poi ricerche nella tabella
+	double inizio = secondi();
+	tabella_hash h = carica_abbonati(FILE_TESTO_BENCHMARK);
+	double caricamento = secondi() - inizio;
+	int trovati = 0;
+	inizio = secondi();
+	for (int i = 0; i < RICERCHE_BENCHMARK; i++)
+		if (cerca_hash(login[i], h) != NULL)
+			trovati++;
+	double ricerca = secondi() - inizio;
+	printf("%-24s avvio: %8.2f ms   login: %7.1f ns/ricerca   (trovati %d)\n",
+		"abbonati.txt", caricamento * 1e3, ricerca * 1e9 / RICERCHE_BENCHMARK, trovati);
+	distruggi_hash(h);
+
+	// Binario: mmap del file e ricerche direttamente sull'indice mappato
+	inizio = secondi();
+	archivio_abbonati a = apri_archivio(FILE_BIN_BENCHMARK);
+	caricamento = secondi() - inizio;
+	if (a != NULL)
+	{
+		trovati = 0;
+		inizio = secondi();
+		for (int i = 0; i < RICERCHE_BENCHMARK; i++)
+			if (cerca_archivio(a, login[i]) != NULL)
+				trovati++;
+		ricerca = secondi() - inizio;
+		printf("%-24s avvio: %8.2f ms   login: %7.1f ns/ricerca   (trovati %d)\n",
+			"abbonati.bin", caricamento * 1e3, ricerca * 1e9 / RICERCHE_BENCHMARK, trovati);
+		chiudi_archivio(a);
+	}
+
+	// Registro: tabella vuota che copia dai record mappati solo gli abbonati cercati
+	inizio = secondi();
+	a = apri_archivio(FILE_BIN_BENCHMARK);
+	h = a != NULL ? nuova_hash(16) : NULL;
+	if (h != NULL)
+		collega_riserva_hash(h, riserva_archivio(a));
+	caricamento = secondi() - inizio;
+	if (h != NULL)
+	{
+		trovati = 0;
+		inizio = secondi();
+		for (int i = 0; i < RICERCHE_BENCHMARK; i++)
+			if (cerca_hash(login[i], h) != NULL)
+				trovati++;
+		ricerca = secondi() - inizio;
+		printf("%-24s avvio: %8.2f ms   login: %7.1f ns/ricerca   (trovati %d)\n",
+			"abbonati.bin + tabella", caricamento * 1e3, ricerca * 1e9 / RICERCHE_BENCHMARK, trovati);
+		distruggi_hash(h);
+	}
+	chiudi_archivio(a);
+
+	free(login);
+	remove(FILE_TESTO_BENCHMARK);
+	remove(FILE_BIN_BENCHMARK);
+}
+
+/* Funzione: benchmark_hash_concorrente
+*
+* Misura come crescono le ricerche al secondo sulla tabella concorrente aumentando i thread
+*
+* Descrizione:
+* Riempie una tabella_concorrente con ABBONATI_BENCHMARK abbonati, poi per 1, 2, 4, ... thread
+* (fino al numero di processori disponibili, e almeno 2) divide tra i thread OPERAZIONI_CONCORRENTI
+* login presi dalla stessa sequenza del benchmark delle tabelle. Un login riuscito ogni
+* OGNI_QUANTE_PRENOTAZIONI preleva anche una lezione con preleva_lezione_concorrente e la restituisce
+* con modifica_lezioni_concorrente, così il saldo finale di ogni abbonato resta invariato.
+* Per ogni numero di thread stampa le operazioni al secondo e l'accelerazione rispetto a un thread.
+*
+* Side-effect:
+* - Crea thread e alloca memoria per la tabella di prova
+* - Stampa a video i risultati
+*/
+void benchmark_hash_concorrente(void)
+{
+	long processori = sysconf(_SC_NPROCESSORS_ONLN);
+	int massimo = processori > 2 ? processori : 2;
+
+	printf("\n--- Benchmark: tabella concorrente con piu' thread ---\n");
+	printf("%d abbonati, %d login per misura (%d%% con nome non registrato), %ld processori\n\n",
+		ABBONATI_BENCHMARK, OPERAZIONI_CONCORRENTI, PERCENTUALE_MANCATI, processori);
+
+	char (*login)[LUNGHEZZA_NOME] = genera_login(RICERCHE_BENCHMARK, ABBONATI_BENCHMARK);
+	tabella_concorrente t = nuova_concorrente(ABBONATI_BENCHMARK, HASH_APERTO);
+	struct lavoro_thread *lavori = malloc(massimo * sizeof(struct lavoro_thread));
+	pthread_t *thread = malloc(massimo * sizeof(pthread_t));
+	if (login == NULL || t == NULL || lavori == NULL || thread == NULL)
+	{
+		printf("Memoria insufficiente per il benchmark.\n");
+		free(login);
+		distruggi_concorrente(t);
+		free(lavori);
+		free(thread);
+		return;
+	}
+
+	for (int i = 0; i < ABBONATI_BENCHMARK; i++)
+	{
+		abbonato nuovo;
+		snprintf(nuovo.nomeutente, MAX_CARATTERI, "utente%d", i);
+		strcpy(nuovo.password, "password");
+		nuovo.lezioni_rimanenti = 12;
+		nuovo.ultima_attivita = 0;
+		nuovo.chiave = nuovo.nomeutente;
+		inserisci_concorrente(nuovo, t);
+	}
+
+	double base = 0;
+	for (int n = 1; n <= massimo; n = (n * 2 > massimo && n < massimo) ? massimo : n * 2)
+	{
+		double inizio = secondi();
+		int avviati = 0;
+		for (int i = 0; i < n; i++)
+		{
+			lavori[i].tabella = t;
+			lavori[i].login = login;
+			lavori[i].inizio = (int)((long)RICERCHE_BENCHMARK * i / n);
+			lavori[i].operazioni = OPERAZIONI_CONCORRENTI / n;
+			lavori[i].trovati = 0;
+			if (pthread_create(&thread[i], NULL, esegui_login_concorrenti, &lavori[i]) != 0)
+				break;
+			avviati++;
+		}
+
+		int trovati = 0;
+		for (int i = 0; i < avviati; i++)
+		{
+			pthread_join(thread[i], NULL);
+			trovati += lavori[i].trovati;
+		}
+		double durata = secondi() - inizio;
+		if (avviati < n)
+		{
+			printf("Impossibile avviare %d thread.\n", n);
+			break;
+		}
+
+		double al_secondo = (double)lavori[0].operazioni * n / durata;
+		if (n == 1)
+			base = al_secondo;
+		printf("%3d thread: %8.2f milioni di login/s   accelerazione %5.2fx   (trovati %d)\n",
+			n, al_secondo / 1e6, al_secondo / base, trovati);
+	}
+
+	free(login);
+	free(lavori);
+	free(thread);
+	distruggi_concorrente(t);
+}
+
+/* Funzione: benchmark_hash_perfetto
+*
+* Misura costruzione e ricerche dell'indice a hash perfetto su un milione di abbonati
+*
+* Descrizione:
+* Per ogni motore confronta i login sulla sola tabella, sull'indice appena costruito e
+* sull'indice con ISCRIZIONI_PERFETTO iscrizioni nel trabocco, e misura la ricostruzione
+* che le ripiega nell'indice.
+*
+* Side-effect:
+* - Alloca memoria per le tabelle di prova
+* - Stampa a video i risultati
+*/
+void benchmark_hash_perfetto(void)
+{
+	printf("\n--- Benchmark: indice a hash perfetto per i login ---\n");
+	printf("%d abbonati, %d login (%d%% con nome non registrato)\n\n",
+		ABBONATI_PERFETTO, RICERCHE_BENCHMARK, PERCENTUALE_MANCATI);
+
+	char (*login)[LUNGHEZZA_NOME] = genera_login(RICERCHE_BENCHMARK, ABBONATI_PERFETTO);
+	if (login == NULL)
+	{
+		printf("Memoria insufficiente per il benchmark.\n");
+		return;
+	}
+
+	misura_perfetto("Catene", HASH_CATENE, login);
+	misura_perfetto("Indirizzamento aperto", HASH_APERTO, login);
+
+	free(login);
+}
+
+/* Funzione: benchmark_salva_lezioni
+*
+* Confronta salva_lezioni con la vecchia scrittura degli iscritti tramite pile di appoggio
+*
+* Descrizione:
+* Costruisce un calendario di LEZIONI_SALVATAGGIO lezioni con ISCRITTI_SALVATAGGIO iscritti ciascuna,
+* poi salva lo stesso calendario RIPETIZIONI_SALVATAGGIO volte con salva_con_copie, che svuota
+* ogni pila in una pila temporanea e la riempie di nuovo, e altrettante con salva_lezioni,
+* che legge gli iscritti sul posto con elemento_pila. Il file viene cancellato alla fine.
+*
+* Side-effect:
+* - Alloca memoria per il calendario di prova, crea e cancella un file nella cartella corrente
+* - Stampa a video i risultati
+*/
+void benchmark_salva_lezioni(void)
+{
+	printf("\n--- Benchmark: salvataggio del calendario ---\n");
+	printf("%d lezioni, %d iscritti per lezione, %d salvataggi per versione\n\n",
+		LEZIONI_SALVATAGGIO, ISCRITTI_SALVATAGGIO, RIPETIZIONI_SALVATAGGIO);
+
+	coda calendario = nuova_coda();
+	lezione *lezioni = malloc(LEZIONI_SALVATAGGIO * sizeof(lezione));
+	if (calendario == NULL || lezioni == NULL)
+	{
+		printf("Memoria insufficiente per il benchmark.\n");
+		free(calendario);
+		free(lezioni);
+		return;
+	}
+
+	// Le lezioni del calendario e quelle dell'array condividono le stesse pile
+	uint32_t stato = 2463534242u;
+	for (int i = 0; i < LEZIONI_SALVATAGGIO; i++)
+	{
+		riempi_lezione(&lezioni[i], i, &stato);
+		inserisci_lezione(lezioni[i], calendario);
+	}
+
+	double inizio = secondi();
+	for (int r = 0; r < RIPETIZIONI_SALVATAGGIO; r++)
+		salva_con_copie(lezioni, LEZIONI_SALVATAGGIO, FILE_LEZIONI_BENCHMARK);
+	double copie = (secondi() - inizio) / RIPETIZIONI_SALVATAGGIO;
+
+	inizio = secondi();
+	for (int r = 0; r < RIPETIZIONI_SALVATAGGIO; r++)
+		salva_lezioni(calendario, FILE_LEZIONI_BENCHMARK);
+	double sul_posto = (secondi() - inizio) / RIPETIZIONI_SALVATAGGIO;
+
+	printf("%-24s %8.2f ms/salvataggio\n", "Pile di appoggio", copie * 1e3);
+	printf("%-24s %8.2f ms/salvataggio   (%.2fx)\n", "Lettura sul posto", sul_posto * 1e3, copie / sul_posto);
+
+	svuota_calendario(calendario);
+	free(lezioni);
+	remove(FILE_LEZIONI_BENCHMARK);
+}
+
+/* Funzione: benchmark_carica_lezioni
+*
+* Confronta carica_lezioni con il vecchio caricamento che inseriva gli iscritti uno alla volta
+*
+* Descrizione:
+* Salva un calendario di LEZIONI_SALVATAGGIO lezioni al completo, con ISCRITTI_SALVATAGGIO
+* iscritti ciascuna, poi lo ricarica RIPETIZIONI_SALVATAGGIO volte con carica_una_alla_volta,
+* che chiama inserisci_pila per ogni nome, e altrettante con carica_lezioni, che passa
+* gli iscritti di ogni lezione a inserisci_blocco_pila. I nomi sono già registrati
+* da nomi.c in entrambe le versioni. Il file viene cancellato alla fine.
+*
+* Side-effect:
+* - Alloca memoria per i calendari di prova, crea e cancella un file nella cartella corrente
+* - Stampa a video i risultati
+*/
+void benchmark_carica_lezioni(void)
+{
+	printf("\n--- Benchmark: caricamento del calendario ---\n");
+	printf("%d lezioni al completo, %d iscritti per lezione, %d caricamenti per versione\n\n",
+		LEZIONI_SALVATAGGIO, ISCRITTI_SALVATAGGIO, RIPETIZIONI_SALVATAGGIO);
+
+	coda calendario = nuova_coda();
+	if (calendario == NULL)
+	{
+		printf("Memoria insufficiente per il benchmark.\n");
+		return;
+	}
+	uint32_t stato = 2463534242u;
+	for (int i = 0; i < LEZIONI_SALVATAGGIO; i++)
+	{
+		lezione l;
+		riempi_lezione(&l, i, &stato);
+		inserisci_lezione(l, calendario);
+	}
+	salva_lezioni(calendario, FILE_LEZIONI_BENCHMARK);
+	svuota_calendario(calendario);
+
+	double tempi[2] = { 0, 0 };
+	for (int r = 0; r < RIPETIZIONI_SALVATAGGIO; r++)
+	{
+		for (int versione = 0; versione < 2; versione++)
+		{
+			calendario = nuova_coda();
+			double inizio = secondi();
+			if (versione == 0)
+				carica_una_alla_volta(calendario, FILE_LEZIONI_BENCHMARK);
+			else
+				carica_lezioni(calendario, FILE_LEZIONI_BENCHMARK);
+			tempi[versione] += secondi() - inizio;
+			svuota_calendario(calendario);
+		}
+	}
+
+	double iscritti = (double)LEZIONI_SALVATAGGIO * ISCRITTI_SALVATAGGIO;
+	double una = tempi[0] / RIPETIZIONI_SALVATAGGIO;
+	double blocco = tempi[1] / RIPETIZIONI_SALVATAGGIO;
+	printf("%-24s %8.2f ms/caricamento   %6.1f M iscritti/s\n", "Uno alla volta", una * 1e3, iscritti / una / 1e6);
+	printf("%-24s %8.2f ms/caricamento   %6.1f M iscritti/s   (%.2fx)\n", "A blocchi", blocco * 1e3,
+		iscritti / blocco / 1e6, una / blocco);
+
+	remove(FILE_LEZIONI_BENCHMARK);
+}
+
+/* Funzione: benchmark_pulisci_lezioni
+*
+* Confronta l'archiviazione delle lezioni passate che scorreva tutto il calendario
+* con quella attuale, che toglie solo le lezioni passate dalla testa della coda ordinata
+*
+* Descrizione:
+* Ogni misura parte da un calendario nuovo di LEZIONI_SALVATAGGIO lezioni al completo,
+* in due casi: PASSATE_PULIZIA lezioni già svolte e le altre ancora da svolgere,
+* oppure nessuna lezione svolta, come quando il programma viene riavviato lo stesso giorno.
+* Viene misurata solo la chiamata di pulizia, non la costruzione del calendario.
+*
+* Side-effect:
+* - Alloca memoria per i calendari di prova, crea e cancella un file nella cartella corrente
+* - Stampa a video i risultati
+*/
+void benchmark_pulisci_lezioni(void)
+{
+	printf("\n--- Benchmark: archiviazione delle lezioni passate ---\n");
+	printf("%d lezioni al completo, %d iscritti per lezione, %d pulizie per versione\n",
+		LEZIONI_SALVATAGGIO, ISCRITTI_SALVATAGGIO, RIPETIZIONI_SALVATAGGIO);
+
+	const int passate[2] = { PASSATE_PULIZIA, 0 };
+	for (int caso = 0; caso < 2; caso++)
+	{
+		printf("\n%d lezioni passate:\n", passate[caso]);
+
+		double tempi[2] = { 0, 0 };
+		for (int r = 0; r < RIPETIZIONI_SALVATAGGIO; r++)
+		{
+			for (int versione = 0; versione < 2; versione++)
+			{
+				coda calendario = calendario_da_pulire(passate[caso]);
+				if (calendario == NULL)
+				{
+					printf("Memoria insufficiente per il benchmark.\n");
+					return;
+				}
+
+				double inizio = secondi();
+				if (versione == 0)
+					pulisci_con_giro(calendario, FILE_STORICO_BENCHMARK);
+				else
+					pulisci_lezioni_passate(calendario, FILE_STORICO_BENCHMARK);
+				tempi[versione] += secondi() - inizio;
+
+				if (dimensione_coda(calendario) != LEZIONI_SALVATAGGIO - passate[caso])
+					printf("Errore: %d lezioni rimaste invece di %d\n", dimensione_coda(calendario),
+						LEZIONI_SALVATAGGIO - passate[caso]);
+				svuota_calendario(calendario);
+			}
+		}
+
+		double giro = tempi[0] / RIPETIZIONI_SALVATAGGIO;
+		double testa = tempi[1] / RIPETIZIONI_SALVATAGGIO;
+		printf("%-24s %8.3f ms/pulizia\n", "Giro della coda", giro * 1e3);
+		printf("%-24s %8.3f ms/pulizia   (%.0fx)\n", "Solo dalla testa", testa * 1e3, giro / testa);
+	}
+
+	remove(FILE_STORICO_BENCHMARK);
+}
+
+/* Funzione: benchmark_genera_lezioni
+*
+* Confronta genera_lezioni, che salta i giorni fino al giorno già generato, con la versione
+* che ricontrollava ogni volta tutti i 30 giorni
+*
+* Descrizione:
+* Il calendario viene generato una volta sola; le chiamate misurate sono quelle successive,
+* come quella prima di ogni ingresso singolo, che non devono aggiungere nessuna lezione.
+*
+* Side-effect:
+* - Alloca memoria per il calendario di prova
+* - Stampa a video i risultati
+*/
+void benchmark_genera_lezioni(void)
+{
+	printf("\n--- Benchmark: generazione delle lezioni ---\n");
+	printf("%d chiamate su un calendario già generato\n\n", CHIAMATE_GENERAZIONE);
+
+	coda calendario = nuova_coda();
+	if (calendario == NULL)
+	{
+		printf("Memoria insufficiente per il benchmark.\n");
+		return;
+	}
+	genera_lezioni(calendario);
+	int generate = dimensione_coda(calendario);
+
+	double tempi[2] = { 0, 0 };
+	for (int versione = 0; versione < 2; versione++)
+	{
+		double inizio = secondi();
+		for (int i = 0; i < CHIAMATE_GENERAZIONE; i++)
+		{
+			if (versione == 0)
+				genera_tutti_i_giorni(calendario);
+			else
+				genera_lezioni(calendario);
+		}
+		tempi[versione] = secondi() - inizio;
+	}
+
+	double tutti = tempi[0] / CHIAMATE_GENERAZIONE;
+	double nuovi = tempi[1] / CHIAMATE_GENERAZIONE;
+	printf("%-24s %8.3f us/chiamata\n", "Tutti i 30 giorni", tutti * 1e6);
+	printf("%-24s %8.3f us/chiamata   (%.1fx)\n", "Dal giorno generato", nuovi * 1e6, tutti / nuovi);
+	if (dimensione_coda(calendario) != generate)
+		printf("Errore: %d lezioni invece di %d\n", dimensione_coda(calendario), generate);
+
+	svuota_calendario(calendario);
+}
+
+/* Funzione: secondi
+*
+* Restituisce il tempo di un orologio monotono, in secondi
+*/
+static double secondi(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/* Funzione: casuale
+*
+* Generatore xorshift32: sequenze ripetibili senza dipendere da rand()
+*/
+static uint32_t casuale(uint32_t *stato)
+{
+	uint32_t x = *stato;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*stato = x;
+	return x;
+}
+
+/* Funzione: genera_login
+*
+* Genera la sequenza di nomi cercati durante il benchmark
+*
+* Post-condizione:
+* Restituisce un array di 'ricerche' nomi (da liberare con free), NULL se manca memoria
+*/
+static char (*genera_login(int ricerche, int abbonati))[LUNGHEZZA_NOME]
+{
+	char (*login)[LUNGHEZZA_NOME] = malloc((size_t)ricerche * LUNGHEZZA_NOME);
+	if (login == NULL)
+		return NULL;
+
+	uint32_t stato = 2463534242u;
+	for (int i = 0; i < ricerche; i++)
+	{
+		uint32_t r = casuale(&stato);
+		if (r % 100 < PERCENTUALE_MANCATI)
+			snprintf(login[i], LUNGHEZZA_NOME, "ospite%u", casuale(&stato) % abbonati);
+		else
+			snprintf(login[i], LUNGHEZZA_NOME, "utente%u", casuale(&stato) % abbonati);
+	}
+	return login;
+}
+
+/* Funzione: misura_login
+*
+* Riempie una tabella con il motore indicato e misura inserimenti e login
+*
+* Descrizione:
+* Se bloom è diverso da zero il filtro viene attivato dopo il caricamento, come fa il registro
+* degli abbonati, e dopo i login ne vengono stampate le statistiche
+*
+* Side-effect:
+* Stampa a video i tempi misurati
+*/
+static void misura_login(const char *nome, motore_hash motore, int bloom, char (*login)[LUNGHEZZA_NOME])
+{
+	tabella_hash h = nuova_hash_motore(10, motore);
+	if (h == NULL)
+	{
+		printf("%s: memoria insufficiente.\n", nome);
+		return;
+	}
+
+	// Caricamento degli abbonati
+	double inizio = secondi();
+	for (int i = 0; i < ABBONATI_BENCHMARK; i++)
+	{
+		abbonato nuovo;
+		snprintf(nuovo.nomeutente, MAX_CARATTERI, "utente%d", i);
+		strcpy(nuovo.password, "password");
+		nuovo.lezioni_rimanenti = 12;
+		nuovo.chiave = nuovo.nomeutente;
+		h = inserisci_hash(nuovo, h);
+	}
+	double inserimento = secondi() - inizio;
+
+	if (bloom && !attiva_bloom_hash(h))
+		printf("%s: filtro di Bloom non disponibile.\n", nome);
+
+	// Traffico di login
+	int trovati = 0;
+	inizio = secondi();
+	for (int i = 0; i < RICERCHE_BENCHMARK; i++)
+		if (cerca_hash(login[i], h) != NULL)
+			trovati++;
+	double ricerca = secondi() - inizio;
+
+	printf("%-22s inserimento: %7.1f ns/abbonato   login: %7.1f ns/ricerca   (trovati %d)\n",
+		nome, inserimento * 1e9 / ABBONATI_BENCHMARK, ricerca * 1e9 / RICERCHE_BENCHMARK, trovati);
+
+	statistiche_bloom s;
+	if (statistiche_bloom_hash(h, &s))
+		printf("%-22s filtro: %.1f%% delle ricerche respinte, %.3f%% di falsi positivi sulle chiavi assenti\n",
+			"", s.tasso_respinte * 100, s.tasso_falsi_positivi * 100);
+
+	distruggi_hash(h);
+}
+
+/* Funzione: benchmark_funzioni_hash
+*
+* Misura velocità e distribuzione delle funzioni hash sui nomi utente tipici
+*
+* Descrizione:
+* Le funzioni vengono usate attraverso il tipo funzione_hash, lo stesso accettato da
+* imposta_funzione_hash. Per ciascuna vengono riportati, su CHIAVI_DISTRIBUZIONE nomi:
+* la percentuale di slot vuoti (con hash uniforme circa il 37% a carico 1), la catena più lunga,
+* la lunghezza media della catena vista da una ricerca riuscita (circa 2 a carico 1) e il numero
+* di collisioni sull'intero valore a 64 bit.
+*
+* Side-effect:
+* - Alloca memoria temporanea per gli hash calcolati
+* - Stampa a video i risultati
+*/
+void benchmark_funzioni_hash(void)
+{
+	const char *schemi[] = { "utente%d", "Abbonato_Test%d", "Utente_Test%d" };
+	const char *nomi_funzioni[] = { "polinomiale 31", "FNV-1a 64", "hash_chiave" };
+	funzione_hash funzioni[] = { hash_polinomiale, hash_fnv1a, hash_chiave };
+	int n = CHIAVI_DISTRIBUZIONE;
+
+	char (*chiavi)[LUNGHEZZA_NOME] = malloc((size_t)n * LUNGHEZZA_NOME);
+	uint64_t *hash = malloc((size_t)n * sizeof(uint64_t));
+	if (chiavi == NULL || hash == NULL)
+	{
+		printf("Memoria insufficiente per il benchmark.\n");
+		free(chiavi);
+		free(hash);
+		return;
+	}
+
+	uint64_t potenza = 1;
+	while (potenza < (uint64_t)n)
+		potenza *= 2;
+
+	printf("\n--- Benchmark: funzioni hash sui nomi utente ---\n");
+	printf("%d chiavi per schema; slot = numero di chiavi (modulo) oppure %llu (maschera)\n",
+		n, (unsigned long long)potenza);
+
+	for (size_t s = 0; s < sizeof(schemi) / sizeof(schemi[0]); s++)
+	{
+		for (int i = 0; i < n; i++)
+			snprintf(chiavi[i], LUNGHEZZA_NOME, schemi[s], i + 1);
+
+		printf("\nSchema \"%s\"\n", schemi[s]);
+		for (size_t f = 0; f < sizeof(funzioni) / sizeof(funzioni[0]); f++)
+		{
+			// Velocità: più passate sulle stesse chiavi
+			uint64_t somma = 0;
+			double inizio = secondi();
+			for (int r = 0; r < RIPETIZIONI_HASH; r++)
+				for (int i = 0; i < n; i++)
+					somma += funzioni[f](chiavi[i]);
+			double durata = secondi() - inizio;
+
+			for (int i = 0; i < n; i++)
+				hash[i] = funzioni[f](chiavi[i]);
+
+			printf("  %-15s %5.1f ns/chiave (controllo %llx)\n", nomi_funzioni[f],
+				durata * 1e9 / ((double)n * RIPETIZIONI_HASH), (unsigned long long)(somma & 0xfff));
+			stampa_distribuzione("modulo", hash, n, n, 0);
+			stampa_distribuzione("maschera", hash, n, potenza, 1);
+
+			// Collisioni sull'intero valore a 64 bit
+			qsort(hash, n, sizeof(uint64_t), confronta_hash);
+			int collisioni = 0;
+			for (int i = 1; i < n; i++)
+				if (hash[i] == hash[i - 1])
+					collisioni++;
+			printf("    collisioni a 64 bit: %d\n", collisioni);
+		}
+	}
+
+	free(chiavi);
+	free(hash);
+}
+
+/* Funzione: hash_fnv1a
+*
+* FNV-1a a 64 bit, un byte alla volta: termine di paragone per hash_chiave
+*/
+static uint64_t hash_fnv1a(const char *chiave)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	while (*chiave)
+	{
+		h ^= (unsigned char)*chiave++;
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+/* Funzione: stampa_distribuzione
+*
+* Stampa come si distribuiscono gli hash su 'slot' posizioni
+*
+* Parametri:
+* etichetta: descrizione della riduzione usata
+* hash: hash delle chiavi
+* n: numero di chiavi
+* slot: numero di posizioni
+* potenza_di_due: 1 per ridurre con la maschera dei bit bassi (slot potenza di due), 0 per il modulo
+*/
+static void stampa_distribuzione(const char *etichetta, uint64_t *hash, int n, uint64_t slot, int potenza_di_due)
+{
+	int *catene = calloc(slot, sizeof(int));
+	if (catene == NULL)
+		return;
+
+	for (int i = 0; i < n; i++)
+		catene[potenza_di_due ? (hash[i] & (slot - 1)) : (hash[i] % slot)]++;
+
+	uint64_t vuoti = 0;
+	int massima = 0;
+	double quadrati = 0;
+	for (uint64_t i = 0; i < slot; i++)
+	{
+		if (catene[i] == 0)
+			vuoti++;
+		if (catene[i] > massima)
+			massima = catene[i];
+		quadrati += (double)catene[i] * catene[i];
+	}
+
+	printf("    %-9s slot vuoti %5.1f%%  catena massima %5d  catena media per ricerca %6.2f\n",
+		etichetta, 100.0 * vuoti / slot, massima, quadrati / n);
+	free(catene);
+}
+
+/* Funzione: confronta_hash
+*
+* Confronto tra due uint64_t per qsort
+*/
+static int confronta_hash(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+/* Funzione: esegui_login_concorrenti
+*
+* Corpo di un thread del benchmark concorrente: esegue i login assegnati a partire dalla sua posizione
+*/
+static void *esegui_login_concorrenti(void *argomento)
+{
+	struct lavoro_thread *lavoro = argomento;
+	int posizione = lavoro->inizio;
+
+	for (int i = 0; i < lavoro->operazioni; i++)
+	{
+		char *nome = lavoro->login[posizione];
+		abbonato utente;
+		if (cerca_concorrente(nome, lavoro->tabella, &utente) &&
+			++lavoro->trovati % OGNI_QUANTE_PRENOTAZIONI == 0 &&
+			preleva_lezione_concorrente(nome, lavoro->tabella))
+			modifica_lezioni_concorrente(nome, lavoro->tabella, 1, NULL);
+
+		if (++posizione == RICERCHE_BENCHMARK)
+			posizione = 0;
+	}
+	return NULL;
+}
+
+/* Funzione: misura_perfetto
+*
+* Riempie una tabella con il motore indicato e misura i login prima e dopo la costruzione dell'indice
+*
+* Side-effect:
+* Stampa a video i tempi misurati
+*/
+static void misura_perfetto(const char *nome, motore_hash motore, char (*login)[LUNGHEZZA_NOME])
+{
+	tabella_hash h = nuova_hash_motore(10, motore);
+	if (h == NULL)
+	{
+		printf("%s: memoria insufficiente.\n", nome);
+		return;
+	}
+
+	abbonato nuovo;
+	strcpy(nuovo.password, "password");
+	nuovo.lezioni_rimanenti = 12;
+	nuovo.ultima_attivita = 0;
+	for (int i = 0; i < ABBONATI_PERFETTO; i++)
+	{
+		snprintf(nuovo.nomeutente, MAX_CARATTERI, "utente%d", i);
+		nuovo.chiave = nuovo.nomeutente;
+		h = inserisci_hash(nuovo, h);
+	}
+
+	int trovati;
+	double tabella = tempo_login(h, login, &trovati);
+	printf("%s\n  %-24s login %7.1f ns/ricerca   (trovati %d)\n", nome, "solo tabella:", tabella * 1e9, trovati);
+
+	double inizio = secondi();
+	if (!costruisci_perfetto_hash(h))
+	{
+		printf("  costruzione dell'indice non riuscita.\n");
+		distruggi_hash(h);
+		return;
+	}
+	double costruzione = secondi() - inizio;
+	double indice = tempo_login(h, login, &trovati);
+	printf("  %-24s login %7.1f ns/ricerca   (trovati %d)   costruzione %8.2f ms\n",
+		"indice perfetto:", indice * 1e9, trovati, costruzione * 1e3);
+
+	// Iscrizioni dopo la costruzione: finiscono nel trabocco
+	for (int i = 0; i < ISCRIZIONI_PERFETTO; i++)
+	{
+		snprintf(nuovo.nomeutente, MAX_CARATTERI, "iscritto%d", i);
+		nuovo.chiave = nuovo.nomeutente;
+		h = inserisci_hash(nuovo, h);
+	}
+	double trabocco = tempo_login(h, login, &trovati);
+	char etichetta[32];
+	snprintf(etichetta, sizeof(etichetta), "con %d nel trabocco:", ISCRIZIONI_PERFETTO);
+	printf("  %-24s login %7.1f ns/ricerca   (trovati %d)\n", etichetta, trabocco * 1e9, trovati);
+
+	inizio = secondi();
+	costruisci_perfetto_hash(h);
+	printf("  %-24s %8.2f ms\n", "ricostruzione:", (secondi() - inizio) * 1e3);
+
+	distruggi_hash(h);
+}
+
+/* Funzione: tempo_login
+*
+* Esegue i login di prova sulla tabella e restituisce il tempo medio per ricerca, in secondi
+*/
+static double tempo_login(tabella_hash h, char (*login)[LUNGHEZZA_NOME], int *trovati)
+{
+	*trovati = 0;
+	double inizio = secondi();
+	for (int i = 0; i < RICERCHE_BENCHMARK; i++)
+		if (cerca_hash(login[i], h) != NULL)
+			(*trovati)++;
+	return (secondi() - inizio) / RICERCHE_BENCHMARK;
+}
+
+/* Funzione: salva_con_copie
+*
+* Scrive le lezioni nel formato di salva_lezioni leggendo gli iscritti come faceva in passato:
+* ogni pila viene svuotata in una pila temporanea e poi riempita di nuovo
+*
+* Descrizione:
+* Tenuta solo come termine di paragone per benchmark_salva_lezioni; a differenza della versione
+* originale libera la pila temporanea, così la misura non comprende la memoria persa
+*/
+static void salva_con_copie(lezione *lezioni, int n, const char *nome_file)
+{
+	FILE *fp = fopen(nome_file, "w");
+	if (fp == NULL)
+		return;
+
+	for (int i = 0; i < n; i++)
+	{
+		char data[11];
+		scrivi_data(lezioni[i].inizio, data);
+		fprintf(fp, "%s;%s;%s;%d;%d;%d\n", data, nome_giorno(lezioni[i].inizio), orario_fascia(lezioni[i].fascia),
+			dimensione_pila(lezioni[i].iscritti), capienza_pila(lezioni[i].iscritti),
+			dimensione_attesa(lezioni[i].attesa));
+
+		pila iscritti_tmp = nuova_pila();
+		partecipante p;
+		while (!pila_vuota(lezioni[i].iscritti))
+		{
+			if (estrai_pila(lezioni[i].iscritti, &p))
+			{
+				fprintf(fp, "%s\n", nome_partecipante(p));
+				inserisci_pila(p, iscritti_tmp);
+			}
+		}
+		while (!pila_vuota(iscritti_tmp))
+		{
+			if (estrai_pila(iscritti_tmp, &p))
+				inserisci_pila(p, lezioni[i].iscritti);
+		}
+		distruggi_pila(iscritti_tmp);
+	}
+
+	fclose(fp);
+}
+
+/* Funzione: benchmark_trova_prenotazioni
+*
+* Confronta le scansioni possibili per trovare le lezioni a cui è iscritto un partecipante
+*
+* Descrizione:
+* Costruisce un calendario di LEZIONI_SALVATAGGIO lezioni al completo e cerca
+* RICERCHE_PRENOTAZIONI partecipanti in tutte le lezioni in cinque modi:
+* - strcmp sui nomi in posti da LUNGHEZZA_PARTECIPANTE caratteri, come quando le pile contenevano i nomi
+* - ciclo semplice sugli identificativi, un confronto alla volta
+* - trova_prenotazioni, che scorre la coda e usa contiene_pila
+* - cerca_pila su ogni lezione di un array, senza scorrere la coda, con SSE2 o AVX2
+* - contiene_pila su ogni lezione dello stesso array, che consulta l'insieme dei presenti
+* Le prime due versioni lavorano su copie degli iscritti, contigue in memoria, fatte prima delle misure.
+* Tutte devono trovare lo stesso numero di prenotazioni.
+*
+* Side-effect:
+* - Alloca memoria per il calendario e le copie degli iscritti
+* - Stampa a video i risultati
+*/
+void benchmark_trova_prenotazioni(void)
+{
+	printf("\n--- Benchmark: prenotazioni di un partecipante ---\n");
+	printf("%d lezioni al completo, %d iscritti per lezione, %d partecipanti cercati\n",
+		LEZIONI_SALVATAGGIO, ISCRITTI_SALVATAGGIO, RICERCHE_PRENOTAZIONI);
+	printf("Istruzioni usate da cerca_pila: %s\n\n", nome_scansione_pila());
+
+	coda calendario = nuova_coda();
+	lezione *lezioni = malloc(LEZIONI_SALVATAGGIO * sizeof(lezione));
+	partecipante *iscritti = malloc((size_t)LEZIONI_SALVATAGGIO * ISCRITTI_SALVATAGGIO * sizeof(partecipante));
+	char (*posti)[LUNGHEZZA_PARTECIPANTE] = calloc((size_t)LEZIONI_SALVATAGGIO * ISCRITTI_SALVATAGGIO, LUNGHEZZA_PARTECIPANTE);
+	if (calendario == NULL || lezioni == NULL || iscritti == NULL || posti == NULL)
+	{
+		printf("Memoria insufficiente per il benchmark.\n");
+		free(calendario);
+		free(lezioni);
+		free(iscritti);
+		free(posti);
+		return;
+	}
+
+	uint32_t stato = 2463534242u;
+	for (int i = 0; i < LEZIONI_SALVATAGGIO; i++)
+	{
+		riempi_lezione(&lezioni[i], i, &stato);
+		inserisci_lezione(lezioni[i], calendario);
+		for (int j = 0; j < ISCRITTI_SALVATAGGIO; j++)
+		{
+			int posto = i * ISCRITTI_SALVATAGGIO + j;
+			iscritti[posto] = elemento_pila(lezioni[i].iscritti, j);
+			snprintf(posti[posto], LUNGHEZZA_PARTECIPANTE, "%s", nome_partecipante(iscritti[posto]));
+		}
+	}
+
+	// Gli stessi partecipanti per tutte le versioni
+	char nomi[RICERCHE_PRENOTAZIONI][LUNGHEZZA_NOME];
+	partecipante cercati[RICERCHE_PRENOTAZIONI];
+	for (int r = 0; r < RICERCHE_PRENOTAZIONI; r++)
+	{
+		snprintf(nomi[r], sizeof(nomi[r]), "utente%u", casuale(&stato) % NOMI_SALVATAGGIO);
+		cercati[r] = cerca_nome(nomi[r]);
+	}
+
+	const char *etichette[5] = { "strcmp sui nomi", "Ciclo sugli ID", "trova_prenotazioni", "cerca_pila", "contiene_pila" };
+	double tempi[5] = { 0, 0, 0, 0, 0 };
+	long trovate[5] = { 0, 0, 0, 0, 0 };
+	for (int versione = 0; versione < 5; versione++)
+	{
+		double inizio = secondi();
+		for (int r = 0; r < RICERCHE_PRENOTAZIONI; r++)
+		{
+			if (versione == 0)
+				trovate[versione] += conta_con_strcmp(posti, LEZIONI_SALVATAGGIO, nomi[r]);
+			else if (versione == 1)
+				trovate[versione] += conta_con_ciclo(iscritti, LEZIONI_SALVATAGGIO, cercati[r]);
+			else if (versione == 2)
+				trovate[versione] += trova_prenotazioni(calendario, cercati[r], NULL, 0);
+			else if (versione == 3)
+			{
+				for (int i = 0; i < LEZIONI_SALVATAGGIO; i++)
+					trovate[versione] += cerca_pila(lezioni[i].iscritti, cercati[r]) >= 0;
+			}
+			else
+			{
+				for (int i = 0; i < LEZIONI_SALVATAGGIO; i++)
+					trovate[versione] += contiene_pila(lezioni[i].iscritti, cercati[r]);
+			}
+		}
+		tempi[versione] = secondi() - inizio;
+	}
+
+	for (int versione = 0; versione < 5; versione++)
+	{
+		double per_ricerca = tempi[versione] / RICERCHE_PRENOTAZIONI;
+		printf("%-24s %8.1f us/ricerca   %6.0f M iscritti/s   (%.2fx)%s\n", etichette[versione], per_ricerca * 1e6,
+			(double)LEZIONI_SALVATAGGIO * ISCRITTI_SALVATAGGIO / per_ricerca / 1e6, tempi[0] / tempi[versione],
+			trovate[versione] == trovate[0] ? "" : "   PRENOTAZIONI DIVERSE");
+	}
+	printf("Prenotazioni trovate: %ld\n", trovate[0]);
+
+	svuota_calendario(calendario);
+	free(lezioni);
+	free(iscritti);
+	free(posti);
+}
+
+/* Funzione: carica_una_alla_volta
+*
+* Carica le lezioni nel formato di salva_lezioni inserendo gli iscritti con una chiamata
+* di inserisci_pila per ogni nome, come faceva carica_lezioni in passato
+*
+* Descrizione:
+* Tenuta solo come termine di paragone per benchmark_carica_lezioni
+*/
+static void carica_una_alla_volta(coda calendario, const char *nome_file)
+{
+	FILE *fp = fopen(nome_file, "r");
+	if (fp == NULL)
+		return;
+
+	char linea[256];
+	while (fgets(linea, sizeof(linea), fp))
+	{
+		lezione l;
+		char data[11], giorno[20], orario[20];
+		int numero_iscritti;
+		int capienza = CAPIENZA_LEZIONE;
+		int numero_attesa = 0;
+
+		if (sscanf(linea, "%10[^;];%19[^;];%19[^;];%d;%d;%d", data, giorno, orario,
+			&numero_iscritti, &capienza, &numero_attesa) >= 4)
+		{
+			l.inizio = leggi_inizio(data, orario, &l.fascia);
+			l.iscritti = nuova_pila_capienza(capienza < numero_iscritti ? numero_iscritti : capienza);
+			l.attesa = nuova_attesa(numero_attesa > CAPIENZA_ATTESA ? numero_attesa : CAPIENZA_ATTESA);
+			for (int i = 0; i < numero_iscritti + numero_attesa; i++)
+			{
+				if (fgets(linea, sizeof(linea), fp))
+				{
+					linea[strcspn(linea, "\n")] = 0;
+					if (i < numero_iscritti)
+						inserisci_pila(interna_nome(linea), l.iscritti);
+					else
+						accoda_attesa(l.attesa, interna_nome(linea));
+				}
+			}
+			inserisci_lezione(l, calendario);
+		}
+	}
+
+	fclose(fp);
+}
+
+/* Funzione: riempi_lezione
+*
+* Prepara la lezione numero i dei benchmark del calendario, al completo con ISCRITTI_SALVATAGGIO
+* iscritti scelti a caso tra NOMI_SALVATAGGIO partecipanti
+*/
+static void riempi_lezione(lezione *l, int i, uint32_t *stato)
+{
+	char nome[LUNGHEZZA_NOME];
+
+	l->inizio = inizio_lezione(giorno_civile(2000 + i / 336, i / 28 % 12 + 1, i % 28 + 1), 0);
+	l->fascia = 0;
+	l->iscritti = nuova_pila_capienza(ISCRITTI_SALVATAGGIO);
+	l->attesa = nuova_attesa(CAPIENZA_ATTESA);
+	for (int j = 0; j < ISCRITTI_SALVATAGGIO; j++)
+	{
+		snprintf(nome, sizeof(nome), "utente%u", casuale(stato) % NOMI_SALVATAGGIO);
+		inserisci_pila(interna_nome(nome), l->iscritti);
+	}
+}
+
+/* Funzione: svuota_calendario
+*
+* Libera tutte le lezioni di un calendario dei benchmark e il calendario stesso
+*/
+static void svuota_calendario(coda calendario)
+{
+	while (!coda_vuota(calendario))
+	{
+		lezione l = rimuovi_lezione(calendario);
+		distruggi_pila(l.iscritti);
+		distruggi_attesa(l.attesa);
+	}
+	distruggi_coda(calendario);
+}
+
+/* Funzione: conta_con_strcmp
+*
+* Conta le lezioni in cui compare nome, confrontandolo con strcmp con ogni posto
+*
+* Descrizione:
+* I posti sono ISCRITTI_SALVATAGGIO per lezione, di LUNGHEZZA_PARTECIPANTE caratteri ciascuno.
+* Ogni lezione si ferma al primo posto che corrisponde
+*/
+static int conta_con_strcmp(char (*posti)[LUNGHEZZA_PARTECIPANTE], int lezioni, const char *nome)
+{
+	int numero = 0;
+
+	for (int i = 0; i < lezioni; i++)
+	{
+		for (int j = 0; j < ISCRITTI_SALVATAGGIO; j++)
+		{
+			if (strcmp(posti[i * ISCRITTI_SALVATAGGIO + j], nome) == 0)
+			{
+				numero++;
+				break;
+			}
+		}
+	}
+	return numero;
+}
+
+/* Funzione: conta_con_ciclo
+*
+* Come conta_con_strcmp, confrontando gli identificativi uno alla volta
+*/
+static int conta_con_ciclo(const partecipante *iscritti, int lezioni, partecipante persona)
+{
+	int numero = 0;
+
+	for (int i = 0; i < lezioni; i++)
+	{
+		for (int j = 0; j < ISCRITTI_SALVATAGGIO; j++)
+		{
+			if (iscritti[i * ISCRITTI_SALVATAGGIO + j] == persona)
+			{
+				numero++;
+				break;
+			}
+		}
+	}
+	return numero;
+}
+
+/* Funzione: pulisci_con_giro
+*
+* Archivia le lezioni passate come faceva pulisci_lezioni_passate in passato: toglie ogni lezione
+* dalla testa della coda e reinserisce in fondo quelle ancora da svolgere
+*
+* Descrizione:
+* Tenuta solo come termine di paragone per benchmark_pulisci_lezioni. Le lezioni tornano
+* in fondo nello stesso ordine, quindi inserisci_lezione non deve mai spostarle
+*/
+static void pulisci_con_giro(coda calendario, const char *nome_file)
+{
+	FILE *fp = fopen(nome_file, "a");
+	if (fp == NULL)
+		return;
+
+	int64_t adesso = istante_attuale();
+	int numero_lezioni = dimensione_coda(calendario);
+	for (int n = 0; n < numero_lezioni; n++)
+	{
+		lezione corrente = rimuovi_lezione(calendario);
+		if (data_passata(corrente.inizio, adesso))
+		{
+			char data[11];
+			scrivi_data(corrente.inizio, data);
+			fprintf(fp, "%s;%s;%s;%d\n", data, nome_giorno(corrente.inizio),
+				orario_fascia(corrente.fascia), dimensione_pila(corrente.iscritti));
+			for (int i = 0; i < dimensione_pila(corrente.iscritti); i++)
+				fprintf(fp, "%s\n", nome_partecipante(elemento_pila(corrente.iscritti, i)));
+			distruggi_pila(corrente.iscritti);
+			distruggi_attesa(corrente.attesa);
+		}
+		else
+			inserisci_lezione(corrente, calendario);
+	}
+
+	fclose(fp);
+}
+
+/* Funzione: calendario_da_pulire
+*
+* Costruisce il calendario del benchmark di pulisci_lezioni_passate: LEZIONI_SALVATAGGIO lezioni
+* in due fasce al giorno, le prime 'passate' già svolte e le altre a partire da domani
+*
+* Post-condizione:
+* Restituisce il calendario oppure NULL se manca memoria
+*/
+static coda calendario_da_pulire(int passate)
+{
+	coda calendario = nuova_coda();
+	if (calendario == NULL)
+		return NULL;
+
+	int64_t domani = istante_attuale() / SECONDI_GIORNO + 1;
+	uint32_t stato = 2463534242u;
+	for (int i = 0; i < LEZIONI_SALVATAGGIO; i++)
+	{
+		lezione l;
+		riempi_lezione(&l, i, &stato);
+		int64_t giorno = i < passate ? domani - 2 - (passate - i) / 2 : domani + (i - passate) / 2;
+		l.fascia = i % 2;
+		l.inizio = inizio_lezione(giorno, l.fascia);
+		inserisci_lezione(l, calendario);
+	}
+	return calendario;
+}
+
+/* Funzione: genera_tutti_i_giorni
+*
+* Genera le lezioni dei prossimi 30 giorni come faceva genera_lezioni prima del giorno generato:
+* controlla ogni giorno con cerca_lezione anche se è già stato generato
+*
+* Descrizione:
+* Tenuta solo come termine di paragone per benchmark_genera_lezioni
+*/
+static void genera_tutti_i_giorni(coda calendario)
+{
+	int64_t oggi = istante_attuale() / SECONDI_GIORNO;
+	for (int64_t giorno = oggi; giorno < oggi + 30; giorno++)
+	{
+		int fascia;
+		if (giorno_lezione(giorno_della_settimana(giorno), &fascia)
+			&& cerca_lezione(calendario, inizio_lezione(giorno, fascia)) == NULL)
+		{
+			lezione l;
+			l.iscritti = nuova_pila_capienza(CAPIENZA_LEZIONE);
+			l.attesa = nuova_attesa(CAPIENZA_ATTESA);
+			l.inizio = inizio_lezione(giorno, fascia);
+			l.fascia = fascia;
+			inserisci_lezione(l, calendario);
+		}
+	}
+}
@@ -0,0 +1,152 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/* Funzione: benchmark_hash_login
+*
+* Confronta il motore a catene e quello a indirizzamento aperto su un traffico di login
+*
+* Descrizione:
+* Inserisce nella tabella un gran numero di abbonati con nomi del tipo "utenteN", partendo
+* da nuova_hash(10) come fa il programma, poi esegue molte ricerche in ordine casuale
+* di cui una parte riguarda nomi non registrati (login falliti).
+* Per ogni motore, con e senza filtro di Bloom, stampa il tempo medio di inserimento e di ricerca
+* e, quando il filtro è attivo, la quota di ricerche respinte e il tasso di falsi positivi.
+*
+* Side-effect:
+* - Alloca memoria per le tabelle di prova
+* - Stampa a video i risultati
+*/
+void benchmark_hash_login(void);
+
+/* Funzione: benchmark_funzioni_hash
+*
+* Misura velocità e distribuzione delle funzioni hash sui nomi utente tipici
+*
+* Descrizione:
+* Per ogni schema di nomi ("utenteN", "Abbonato_TestN", "Utente_TestN") e per ogni funzione hash
+* (storica polinomiale, FNV-1a a 64 bit, hash_chiave) calcola la distribuzione delle chiavi sugli
+* slot, sia con il modulo usato dal motore a catene sia con la maschera a potenza di due usata
+* dal motore a indirizzamento aperto, e il tempo medio per chiave.
+*
+* Side-effect:
+* - Alloca memoria temporanea per gli hash calcolati
+* - Stampa a video i risultati
+*/
+void benchmark_funzioni_hash(void);
+
+/* Funzione: benchmark_avvio_abbonati
+*
+* Confronta il caricamento di abbonati.txt con l'apertura di abbonati.bin
+*
+* Descrizione:
+* Per il file di testo misura carica_abbonati (lettura e analisi di ogni riga) seguita dai login
+* sulla tabella hash; per l'archivio binario misura apri_archivio (solo mmap) seguita dai login
+* sull'indice mappato, e poi la tabella del registro collegata all'archivio (riserva_archivio).
+*
+* Side-effect:
+* - Crea e cancella due file temporanei nella cartella corrente
+* - Stampa a video i risultati
+*/
+void benchmark_avvio_abbonati(void);
+
+/* Funzione: benchmark_hash_concorrente
+*
+* Misura la scalabilità delle ricerche sulla tabella concorrente da 1 a N thread
+*
+* Descrizione:
+* Divide lo stesso numero di login tra un numero crescente di thread, con una parte dei login
+* che preleva e restituisce una lezione con operazioni atomiche, e stampa le operazioni
+* al secondo e l'accelerazione rispetto a un solo thread.
+*
+* Side-effect:
+* - Crea thread e alloca memoria per la tabella di prova
+* - Stampa a video i risultati
+*/
+void benchmark_hash_concorrente(void);
+
+/* Funzione: benchmark_hash_perfetto
+*
+* Misura tempo di costruzione e latenza dei login dell'indice a hash perfetto
+*
+* Descrizione:
+* Con ABBONATI_PERFETTO abbonati, per entrambi i motori, misura i login sulla sola tabella,
+* il tempo di costruzione dell'indice, i login sull'indice appena costruito e quelli dopo
+* un blocco di iscrizioni finite nel trabocco, infine il tempo della ricostruzione.
+*
+* Side-effect:
+* - Alloca memoria per le tabelle di prova
+* - Stampa a video i risultati
+*/
+void benchmark_hash_perfetto(void);
+
+/* Funzione: benchmark_salva_lezioni
+*
+* Misura salva_lezioni su un calendario grande, prima e dopo la lettura degli iscritti sul posto
+*
+* Descrizione:
+* Confronta il salvataggio con le pile di appoggio usate in passato (svuotare e riempire di nuovo
+* ogni pila) con quello attuale, che legge gli iscritti con elemento_pila senza copiarli.
+*
+* Side-effect:
+* - Alloca memoria per il calendario di prova, crea e cancella un file nella cartella corrente
+* - Stampa a video i risultati
+*/
+void benchmark_salva_lezioni(void);
+
+/* Funzione: benchmark_carica_lezioni
+*
+* Misura carica_lezioni su un calendario grande con tutte le lezioni al completo
+*
+* Descrizione:
+* Confronta il caricamento che inseriva gli iscritti uno alla volta con quello attuale,
+* che raccoglie gli iscritti di ogni lezione e li passa alla pila con inserisci_blocco_pila.
+*
+* Side-effect:
+* - Alloca memoria per i calendari di prova, crea e cancella un file nella cartella corrente
+* - Stampa a video i risultati
+*/
+void benchmark_carica_lezioni(void);
+
+/* Funzione: benchmark_trova_prenotazioni
+*
+* Misura la ricerca delle lezioni a cui è iscritto un partecipante su un calendario grande
+*
+* Descrizione:
+* Confronta la scansione con strcmp sui nomi, il ciclo sugli identificativi,
+* trova_prenotazioni, cerca_pila con la scansione vettoriale e contiene_pila.
+*
+* Side-effect:
+* - Alloca memoria per il calendario di prova
+* - Stampa a video i risultati
+*/
+void benchmark_trova_prenotazioni(void);
+
+/* Funzione: benchmark_pulisci_lezioni
+*
+* Misura pulisci_lezioni_passate su un calendario grande con poche o nessuna lezione passata
+*
+* Descrizione:
+* Confronta il giro completo della coda fatto in passato con la rimozione dalla testa
+* della coda ordinata per inizio, che si ferma alla prima lezione ancora da svolgere.
+*
+* Side-effect:
+* - Alloca memoria per i calendari di prova, crea e cancella un file nella cartella corrente
+* - Stampa a video i risultati
+*/
+void benchmark_pulisci_lezioni(void);
+
+/* Funzione: benchmark_genera_lezioni
+*
+* Misura genera_lezioni quando il calendario è già stato generato fino a 30 giorni da oggi
+*
+* Descrizione:
+* Confronta il controllo di tutti i 30 giorni fatto in passato a ogni chiamata
+* con quello attuale, che parte dal giorno successivo all'ultimo generato.
+*
+* Side-effect:
+* - Alloca memoria per il calendario di prova
+* - Stampa a video i risultati
+*/
+void benchmark_genera_lezioni(void);
+
+#endif
@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "bloom.h"
+
+#define PAROLE_PER_BLOCCO 8 // Un blocco è una linea di cache: 8 parole da 64 bit
+#define BYTE_PER_BLOCCO (PAROLE_PER_BLOCCO * sizeof(uint64_t))
+#define BIT_PER_CHIAVE 16 // Circa lo 0,1% di falsi positivi con un bit per parola
+
+// Moltiplicatori dispari che ricavano dai 32 bit bassi dell'hash un bit diverso per ogni parola
+static const uint32_t sale[PAROLE_PER_BLOCCO] =
+{
+	0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+	0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+// Struttura del filtro
+struct c_bloom
+{
+	uint64_t *blocchi; // numero_blocchi * PAROLE_PER_BLOCCO parole, allineate a 64 byte
+	uint64_t numero_blocchi;
+	int capacita; // Chiavi per cui è stato dimensionato
+	int inseriti; // Chiavi aggiunte dall'ultimo svuotamento
+	int rimossi; // Chiavi rimosse dalla tabella dall'ultimo svuotamento
+
+	long interrogazioni;
+	long respinte;
+	long falsi_positivi;
+};
+
+static uint64_t *alloca_blocchi(int capacita, uint64_t *numero_blocchi);
+static void maschere(uint64_t hash, uint64_t *maschera);
+static uint64_t *blocco(filtro_bloom f, uint64_t hash);
+
+/* Funzione: nuovo_bloom
+*
+* Crea un filtro vuoto dimensionato per 'capacita' chiavi
+*
+* Descrizione:
+* Il filtro è diviso in blocchi di 64 byte, la dimensione di una linea di cache:
+* tutti i bit di una chiave cadono nello stesso blocco, quindi una ricerca legge
+* una sola linea di cache invece di una per ogni funzione hash
+*
+* Pre-condizione:
+* capacita>0
+*
+* Post-condizione:
+* Restituisce un filtro vuoto oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica allineata alle linee di cache
+*/
+filtro_bloom nuovo_bloom(int capacita)
+{
+	filtro_bloom f = malloc(sizeof(struct c_bloom));
+	if (f == NULL)
+		return NULL;
+
+	f->blocchi = alloca_blocchi(capacita, &f->numero_blocchi);
+	if (f->blocchi == NULL)
+	{
+		free(f);
+		return NULL;
+	}
+	f->capacita = capacita;
+	f->inseriti = 0;
+	f->rimossi = 0;
+	f->interrogazioni = 0;
+	f->respinte = 0;
+	f->falsi_positivi = 0;
+	return f;
+}
+
+/* Funzione: svuota_bloom
+*
+* Svuota il filtro e lo ridimensiona per 'capacita' chiavi, conservando le statistiche
+*
+* Post-condizione:
+* Restituisce 1 se l'operazione è riuscita, 0 se l'allocazione fallisce (il filtro resta invariato)
+*/
+int svuota_bloom(filtro_bloom f, int capacita)
+{
+	uint64_t numero_blocchi;
+	uint64_t *blocchi = alloca_blocchi(capacita, &numero_blocchi);
+	if (blocchi == NULL)
+		return 0;
+
+	free(f->blocchi);
+	f->blocchi = blocchi;
+	f->numero_blocchi = numero_blocchi;
+	f->capacita = capacita;
+	f->inseriti = 0;
+	f->rimossi = 0;
+	return 1;
+}
+
+/* Funzione: aggiungi_bloom
+*
+* Registra nel filtro l'hash di una chiave inserita nella tabella
+*
+* Descrizione:
+* Imposta un bit in ognuna delle 8 parole del blocco scelto dall'hash
+*/
+void aggiungi_bloom(filtro_bloom f, uint64_t hash)
+{
+	uint64_t maschera[PAROLE_PER_BLOCCO];
+	maschere(hash, maschera);
+
+	uint64_t *b = blocco(f, hash);
+	for (int i = 0; i < PAROLE_PER_BLOCCO; i++)
+		b[i] |= maschera[i];
+	f->inseriti++;
+}
+
+/* Funzione: forse_presente_bloom
+*
+* Verifica se la chiave con l'hash indicato può essere presente nella tabella
+*
+* Descrizione:
+* La chiave è sicuramente assente se anche uno solo degli 8 bit del suo blocco è a zero.
+* Le parole vengono controllate tutte senza uscire dal ciclo, così il compilatore può
+* confrontare il blocco con poche istruzioni vettoriali
+*
+* Post-condizione:
+* Restituisce 0 se la chiave è sicuramente assente, 1 se potrebbe essere presente
+*
+* Side-effect:
+* Aggiorna i contatori di interrogazioni e respinte
+*/
+int forse_presente_bloom(filtro_bloom f, uint64_t hash)
+{
+	uint64_t maschera[PAROLE_PER_BLOCCO];
+	maschere(hash, maschera);
+
+	const uint64_t *b = blocco(f, hash);
+	uint64_t mancanti = 0;
+	for (int i = 0; i < PAROLE_PER_BLOCCO; i++)
+		mancanti |= maschera[i] & ~b[i];
+
+	f->interrogazioni++;
+	if (mancanti != 0)
+	{
+		f->respinte++;
+		return 0;
+	}
+	return 1;
+}
+
+/* Funzione: falso_positivo_bloom
+*
+* Registra che una chiave non esclusa dal filtro non era presente nella tabella
+*/
+void falso_positivo_bloom(filtro_bloom f)
+{
+	f->falsi_positivi++;
+}
+
+/* Funzione: rimozione_bloom
+*
+* Registra la rimozione di una chiave dalla tabella
+*
+* Descrizione:
+* Un filtro di Bloom non può cancellare i bit di una chiave senza rischiare di
+* cancellare anche quelli di altre chiavi: i bit restano impostati e la chiave rimossa
+* produrrà falsi positivi finché il filtro non verrà ricostruito
+*/
+void rimozione_bloom(filtro_bloom f)
+{
+	f->rimossi++;
+}
+
+/* Funzione: da_ricostruire_bloom
+*
+* Post-condizione:
+* Restituisce 1 se il filtro contiene più chiavi di quelle per cui è dimensionato
+* o se più di metà delle chiavi aggiunte sono state rimosse dalla tabella
+*/
+int da_ricostruire_bloom(filtro_bloom f)
+{
+	return f->inseriti > f->capacita || f->rimossi > f->inseriti / 2;
+}
+
+/* Funzione: leggi_statistiche_bloom
+*
+* Copia in s i contatori del filtro e ne calcola i tassi (zero se non ci sono dati)
+*/
+void leggi_statistiche_bloom(filtro_bloom f, statistiche_bloom *s)
+{
+	s->interrogazioni = f->interrogazioni;
+	s->respinte = f->respinte;
+	s->falsi_positivi = f->falsi_positivi;
+
+	long assenti = f->respinte + f->falsi_positivi;
+	s->tasso_falsi_positivi = assenti > 0 ? (double)f->falsi_positivi / assenti : 0;
+	s->tasso_respinte = f->interrogazioni > 0 ? (double)f->respinte / f->interrogazioni : 0;
+}
+
+/* Funzione: distruggi_bloom
+*
+* Libera il filtro
+*
+* Pre-condizione:
+* f è un filtro valido oppure NULL
+*/
+void distruggi_bloom(filtro_bloom f)
+{
+	if (f == NULL)
+		return;
+
+	free(f->blocchi);
+	free(f);
+}
+
+/* Funzione: alloca_blocchi
+*
+* Alloca e azzera i blocchi necessari per 'capacita' chiavi (almeno uno)
+*
+* Post-condizione:
+* Restituisce le parole allineate a 64 byte e scrive il numero di blocchi in numero_blocchi,
+* oppure NULL se l'allocazione fallisce
+*/
+static uint64_t *alloca_blocchi(int capacita, uint64_t *numero_blocchi)
+{
+	uint64_t bit = (uint64_t)capacita * BIT_PER_CHIAVE;
+	uint64_t n = (bit + BYTE_PER_BLOCCO * 8 - 1) / (BYTE_PER_BLOCCO * 8);
+	if (n == 0)
+		n = 1;
+
+	uint64_t *blocchi = aligned_alloc(BYTE_PER_BLOCCO, n * BYTE_PER_BLOCCO);
+	if (blocchi == NULL)
+		return NULL;
+
+	memset(blocchi, 0, n * BYTE_PER_BLOCCO);
+	*numero_blocchi = n;
+	return blocchi;
+}
+
+/* Funzione: maschere
+*
+* Calcola per ogni parola del blocco la maschera con il bit della chiave
+*
+* Descrizione:
+* I 32 bit bassi dell'hash vengono moltiplicati per un sale diverso per ogni parola;
+* i 6 bit più alti del prodotto scelgono il bit (0..63) della parola
+*/
+static void maschere(uint64_t hash, uint64_t *maschera)
+{
+	uint32_t basso = (uint32_t)hash;
+	for (int i = 0; i < PAROLE_PER_BLOCCO; i++)
+		maschera[i] = 1ULL << ((uint32_t)(basso * sale[i]) >> 26);
+}
+
+/* Funzione: blocco
+*
+* Restituisce il blocco della chiave, scelto dai 32 bit alti dell'hash
+*
+* Descrizione:
+* Il prodotto dei 32 bit alti per il numero di blocchi, diviso per 2^32, cade in [0, numero_blocchi)
+* senza bisogno di una divisione e senza imporre un numero di blocchi potenza di due
+*/
+static uint64_t *blocco(filtro_bloom f, uint64_t hash)
+{
+	uint64_t indice = ((hash >> 32) * f->numero_blocchi) >> 32;
+	return f->blocchi + indice * PAROLE_PER_BLOCCO;
+}
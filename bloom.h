@@ -0,0 +1,96 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <stdint.h>
+
+// Filtro di Bloom a blocchi usato da hash.c davanti alle ricerche
+typedef struct c_bloom *filtro_bloom;
+
+// Contatori delle ricerche passate dal filtro
+typedef struct statistiche_bloom
+{
+	long interrogazioni; // Ricerche controllate dal filtro
+	long respinte; // Chiavi escluse dal filtro senza consultare la tabella
+	long falsi_positivi; // Chiavi assenti che il filtro non ha saputo escludere
+	double tasso_falsi_positivi; // falsi_positivi / (respinte + falsi_positivi): quota di chiavi assenti non escluse
+	double tasso_respinte; // respinte / interrogazioni: quota di ricerche risolte dal solo filtro
+} statistiche_bloom;
+
+/* Funzione: nuovo_bloom
+*
+* Crea un filtro vuoto dimensionato per 'capacita' chiavi
+*
+* Pre-condizione:
+* capacita>0
+*
+* Post-condizione:
+* Restituisce un filtro vuoto oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica allineata alle linee di cache
+*/
+filtro_bloom nuovo_bloom(int capacita);
+
+/* Funzione: svuota_bloom
+*
+* Svuota il filtro e lo ridimensiona per 'capacita' chiavi, conservando le statistiche
+*
+* Post-condizione:
+* Restituisce 1 se l'operazione è riuscita, 0 se l'allocazione fallisce (il filtro resta invariato)
+*/
+int svuota_bloom(filtro_bloom f, int capacita);
+
+/* Funzione: aggiungi_bloom
+*
+* Registra nel filtro l'hash di una chiave inserita nella tabella
+*/
+void aggiungi_bloom(filtro_bloom f, uint64_t hash);
+
+/* Funzione: forse_presente_bloom
+*
+* Verifica se la chiave con l'hash indicato può essere presente nella tabella
+*
+* Post-condizione:
+* Restituisce 0 se la chiave è sicuramente assente, 1 se potrebbe essere presente
+*
+* Side-effect:
+* Aggiorna i contatori di interrogazioni e respinte
+*/
+int forse_presente_bloom(filtro_bloom f, uint64_t hash);
+
+/* Funzione: falso_positivo_bloom
+*
+* Registra che una chiave non esclusa dal filtro non era presente nella tabella
+*/
+void falso_positivo_bloom(filtro_bloom f);
+
+/* Funzione: rimozione_bloom
+*
+* Registra la rimozione di una chiave dalla tabella (i suoi bit restano impostati)
+*/
+void rimozione_bloom(filtro_bloom f);
+
+/* Funzione: da_ricostruire_bloom
+*
+* Post-condizione:
+* Restituisce 1 se il filtro contiene più chiavi di quelle per cui è dimensionato
+* o troppe chiavi rimosse, e va quindi ricostruito con svuota_bloom e aggiungi_bloom
+*/
+int da_ricostruire_bloom(filtro_bloom f);
+
+/* Funzione: leggi_statistiche_bloom
+*
+* Copia in s i contatori del filtro e ne calcola i tassi
+*/
+void leggi_statistiche_bloom(filtro_bloom f, statistiche_bloom *s);
+
+/* Funzione: distruggi_bloom
+*
+* Libera il filtro
+*
+* Pre-condizione:
+* f è un filtro valido oppure NULL
+*/
+void distruggi_bloom(filtro_bloom f);
+
+#endif
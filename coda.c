@@ -2,31 +2,47 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
 #include "coda.h"
 #include "lezione.h"
 #include "hash.h"
 
-// Nodo della coda
-struct nodo
+#define LEZIONI_INIZIALI 16 // Lezioni allocate al primo inserimento (potenza di due)
+
+// Voce dell'indice delle lezioni per data e orario
+struct voce_indice
 {
-	lezione valore;
-	struct nodo *prossimo;
+	uint64_t chiave; // Istante di inizio della lezione, NESSUN_INIZIO se la voce è libera
+	int indice; // Posizione in vet della lezione
 };
 
 // Struttura della coda
 struct c_coda
 {
-	struct nodo *testa,*coda;
+	lezione *vet; // Buffer circolare, NULL finché non viene inserita la prima lezione
+	int primo; // Posizione in vet della lezione in testa
 	int numel;
+	int allocati; // Lezioni che vet può contenere
+	struct voce_indice *indice; // Indirizzamento aperto con il doppio delle voci rispetto ad allocati
+	uint32_t maschera; // Numero di voci dell'indice meno uno
+	int64_t generato; // Ultimo giorno con le lezioni già generate (vedi giorno_generato)
 };
 
+static int allarga_coda(coda calendario);
+static int fisica(coda calendario, int posizione);
+static int posizione_ordinata(coda calendario, int64_t inizio);
+static void sposta_lezione(coda calendario, int da, int a);
+static uint32_t posizione_indice(coda calendario, uint64_t chiave);
+static void aggiungi_indice(coda calendario, uint64_t chiave, int indice);
+static void togli_indice(coda calendario, uint64_t chiave, int indice);
+
 /* Funzione: nuova_coda
 *
 * Crea e inizializza una nuova coda vuota
 *
 * Descrizione:
 * La funzione alloca dinamicamente memoria per una struttura di tipo c_coda
-* Inizializza il numero di elementi a zero e i puntatori testa e coda a NULL
+* Inizializza il numero di elementi a zero; lo spazio per le lezioni non viene ancora allocato
 * Restituisce un puntatore alla nuova coda vuota creata
 *
 * Post-condizione:
@@ -44,9 +60,13 @@ coda nuova_coda(void)
 		return NULL;
 
 	// Inizializza i campi
+	calendario->vet = NULL;
+	calendario->primo = 0;
 	calendario->numel = 0;
-	calendario->testa = NULL;
-	calendario->coda = NULL;
+	calendario->allocati = 0;
+	calendario->indice = NULL;
+	calendario->maschera = 0;
+	calendario->generato = NESSUN_GIORNO_GENERATO;
 	return calendario;
 }
 
@@ -78,13 +98,18 @@ int coda_vuota(coda calendario)
 
 /* Funzione: inserisci_lezione
 *
-* Inserisce una nuova lezione in fondo alla coda calendario
+* Inserisce una nuova lezione nella coda calendario, in ordine di inizio
 *
 * Descrizione:
-* La funzione alloca dinamicamente un nuovo nodo contenente la lezione da inserire
-* Se la coda è vuota imposta il nuovo nodo come testa della coda
-* Altrimenti lo collega in fondo alla coda esistente
-* In entrambi i casi aggiorna il puntatore alla coda e incrementa il numero di elementi
+* La coda resta ordinata per istante di inizio, con le lezioni dallo stesso inizio nell'ordine
+* di inserimento. Il caso comune, una lezione che non inizia prima dell'ultima, scrive nella
+* posizione del buffer circolare che segue l'ultima, tornando all'inizio del buffer quando
+* ne raggiunge la fine. Altrimenti la posizione viene trovata con una ricerca binaria
+* e le lezioni tra quella posizione e l'estremità più vicina, testa o fondo,
+* si spostano di un posto per farle spazio.
+* Se il buffer è pieno lo raddoppia (vedi allarga_coda): nessuna allocazione per le altre lezioni
+* La lezione viene aggiunta all'indice per data e orario, se non ce n'è già una con la stessa chiave:
+* l'indice conosce così sempre la prima, in ordine di coda, delle lezioni con lo stesso inizio
 * Restituisce 1 in caso di successo 0 se l'allocazione fallisce -1 se la coda è NULL
 *
 * Parametri:
@@ -98,32 +123,44 @@ int coda_vuota(coda calendario)
 * - Restituisce 1 se l’inserimento è riuscito, 0 se fallisce per allocazione, -1 se la coda è NULL
 *
 * Side-effect:
-* - Modifica la coda calendario aggiungendo un nodo in fondo e incrementando il numero di elementi
+* - Modifica la coda calendario aggiungendo una lezione e incrementando il numero di elementi
+* - Può spostare lezioni o riallocare il buffer: i puntatori restituiti da elemento_coda non sono più validi
 */
 int inserisci_lezione(lezione val, coda calendario)
 { 
 	if (calendario == NULL)
 		return -1;
 
-	// Crea nuovo nodo
-	struct nodo *nuovo;
-	nuovo = malloc(sizeof(struct nodo));
-	if (nuovo == NULL)
+	// Buffer pieno: lo raddoppia
+	if (calendario->numel == calendario->allocati && !allarga_coda(calendario))
 		return 0;
 
-	// Inizializza nodo
-	nuovo->valore = val;
-	nuovo->prossimo = NULL;
+	// Posizione in ordine: dopo tutte le lezioni che non iniziano più tardi
+	int posizione = calendario->numel;
+	if (posizione > 0 && calendario->vet[fisica(calendario, posizione - 1)].inizio > val.inizio)
+		posizione = posizione_ordinata(calendario, val.inizio);
 
-	// Inserimento in coda
-	if (calendario->testa == NULL)
-    		calendario->testa = nuovo;
+	// Fa spazio spostando le lezioni verso l'estremità più vicina
+	if (posizione >= calendario->numel / 2)
+	{
+		for (int i = calendario->numel; i > posizione; i--)
+			sposta_lezione(calendario, fisica(calendario, i - 1), fisica(calendario, i));
+	}
 	else
-    		calendario->coda->prossimo = nuovo;
+	{
+		calendario->primo = (calendario->primo + calendario->allocati - 1) % calendario->allocati;
+		for (int i = 0; i < posizione; i++)
+			sposta_lezione(calendario, fisica(calendario, i + 1), fisica(calendario, i));
+	}
 
-	// Aggiorna puntatore coda e contatore
-	calendario->coda = nuovo;
+	// Inserimento e aggiornamento del contatore
+	int indice = fisica(calendario, posizione);
+	calendario->vet[indice] = val;
 	(calendario->numel)++;
+
+	uint64_t chiave = (uint64_t)val.inizio;
+	if (chiave != NESSUN_INIZIO && calendario->indice[posizione_indice(calendario, chiave)].chiave == NESSUN_INIZIO)
+		aggiungi_indice(calendario, chiave, indice);
 	return 1;
 }
 
@@ -133,9 +170,10 @@ int inserisci_lezione(lezione val, coda calendario)
 *
 * Descrizione:
 * La funzione controlla se la coda è NULL o vuota e in tal caso restituisce ELEMENTO_NULLO
-* Altrimenti salva la lezione del primo nodo, aggiorna il puntatore alla testa
-* Dealloca il nodo rimosso e aggiorna il numero di elementi nella coda
-* Se la coda diventa vuota aggiorna anche il puntatore alla coda
+* Altrimenti restituisce la lezione in testa, fa avanzare la testa del buffer circolare
+* e aggiorna il numero di elementi nella coda: nessuna lezione viene spostata
+* La lezione esce anche dall'indice per data e orario; se la nuova testa ha lo stesso inizio
+* ne prende il posto nell'indice, così le altre lezioni con quell'inizio restano raggiungibili
 *
 * Parametri:
 * calendario: la coda da cui rimuovere la lezione
@@ -147,7 +185,7 @@ int inserisci_lezione(lezione val, coda calendario)
 * - Se la coda è vuota restituisce ELEMENTO_NULLO, altrimenti restituisce la lezione rimossa
 *
 * Side-effect:
-* - Modifica la coda rimuovendo il primo nodo e aggiornando testa e numero di elementi
+* - Modifica la coda rimuovendo la prima lezione e aggiornando testa e numero di elementi
 */
 lezione rimuovi_lezione(coda calendario)
 {
@@ -157,15 +195,279 @@ lezione rimuovi_lezione(coda calendario)
 	if (calendario->numel == 0)
         	return ELEMENTO_NULLO; 
 
-	lezione risultato = calendario->testa->valore; // Salva il valore da restituire
-	struct nodo *temp = calendario->testa; // Salva il nodo da eliminare
-	calendario->testa = calendario->testa->prossimo; // Aggiorna la testa
-	free(temp); // Libera la memoria
-
-	// Se la coda è vuota, aggiorna anche il puntatore coda
-	if (calendario->testa == NULL)
-		calendario->coda = NULL;
-
+	lezione risultato = calendario->vet[calendario->primo]; // Salva il valore da restituire
+	uint64_t chiave = (uint64_t)risultato.inizio;
+	togli_indice(calendario, chiave, calendario->primo);
+	calendario->primo = (calendario->primo + 1) % calendario->allocati; // Aggiorna la testa
 	(calendario->numel)--; // Decrementa il contatore
+
+	// La lezione indicizzata era la prima con questo inizio: ora lo è la nuova testa
+	if (calendario->numel > 0 && calendario->vet[calendario->primo].inizio == risultato.inizio &&
+		chiave != NESSUN_INIZIO && calendario->indice[posizione_indice(calendario, chiave)].chiave == NESSUN_INIZIO)
+		aggiungi_indice(calendario, chiave, calendario->primo);
 	return risultato;
 }
+
+/* Funzione: dimensione_coda
+*
+* Restituisce il numero di lezioni presenti nella coda calendario
+*
+* Post-condizione:
+* - Restituisce il numero di lezioni, -1 se la coda è NULL
+*/
+int dimensione_coda(coda calendario)
+{
+	if (calendario == NULL)
+		return -1;
+	return calendario->numel;
+}
+
+/* Funzione: elemento_coda
+*
+* Restituisce la lezione in posizione 'posizione' della coda, senza toglierla
+*
+* Descrizione:
+* La posizione viene contata dalla testa e trasformata in un indice del buffer circolare:
+* l'accesso costa lo stesso qualunque sia la posizione
+*
+* Parametri:
+* calendario: la coda da leggere
+* posizione: distanza dalla testa, 0 per la prima lezione
+*
+* Post-condizione:
+* - Restituisce un puntatore alla lezione, che può essere modificata sul posto,
+*   oppure NULL se posizione è fuori dalla coda o la coda è NULL
+*/
+lezione *elemento_coda(coda calendario, int posizione)
+{
+	if (calendario == NULL || posizione < 0 || posizione >= calendario->numel)
+		return NULL;
+	return &calendario->vet[(calendario->primo + posizione) % calendario->allocati];
+}
+
+/* Funzione: cerca_lezione
+*
+* Trova la lezione che inizia nell'istante indicato
+*
+* Descrizione:
+* Consulta l'indice per data e orario invece di scorrere la coda:
+* il costo non dipende dal numero di lezioni
+*
+* Post-condizione:
+* - Restituisce un puntatore alla lezione oppure NULL se non c'è; se più lezioni iniziano
+*   in quell'istante, la prima in ordine di coda
+*/
+lezione *cerca_lezione(coda calendario, int64_t inizio)
+{
+	if (calendario == NULL || calendario->indice == NULL || inizio == NESSUN_INIZIO)
+		return NULL;
+
+	uint64_t chiave = (uint64_t)inizio;
+
+	struct voce_indice *voce = &calendario->indice[posizione_indice(calendario, chiave)];
+	return voce->chiave == chiave ? &calendario->vet[voce->indice] : NULL;
+}
+
+/* Funzione: giorno_generato
+*
+* Restituisce l'ultimo giorno fino al quale sono state generate le lezioni del calendario
+*/
+int64_t giorno_generato(coda calendario)
+{
+	return calendario->generato;
+}
+
+/* Funzione: segna_giorno_generato
+*
+* Registra che le lezioni del calendario sono state generate fino al giorno indicato, se è successivo
+*/
+void segna_giorno_generato(coda calendario, int64_t giorni)
+{
+	if (giorni > calendario->generato)
+		calendario->generato = giorni;
+}
+
+/* Funzione: distruggi_coda
+*
+* Libera la coda calendario e lo spazio delle sue lezioni
+*/
+void distruggi_coda(coda calendario)
+{
+	if (calendario == NULL)
+		return;
+
+	free(calendario->vet);
+	free(calendario->indice);
+	free(calendario);
+}
+
+/* Funzione: allarga_coda
+*
+* Raddoppia lo spazio per le lezioni, partendo da LEZIONI_INIZIALI
+*
+* Descrizione:
+* Le lezioni vengono ricopiate nel nuovo buffer a partire dall'indice 0, nell'ordine della coda:
+* la parte che era tornata all'inizio del vecchio buffer finisce dopo quella in fondo.
+* Le posizioni cambiano, quindi l'indice viene ricostruito con il doppio delle voci
+*
+* Post-condizione:
+* - Restituisce 1 se il buffer è stato allargato, 0 se l'allocazione fallisce (la coda non cambia)
+*/
+static int allarga_coda(coda calendario)
+{
+	int allocati = calendario->allocati > 0 ? calendario->allocati * 2 : LEZIONI_INIZIALI;
+	lezione *vet = malloc(allocati * sizeof(lezione));
+	struct voce_indice *indice = calloc(2 * (size_t)allocati, sizeof(struct voce_indice));
+	if (vet == NULL || indice == NULL)
+	{
+		free(vet);
+		free(indice);
+		return 0;
+	}
+
+	// Prima le lezioni dalla testa alla fine del vecchio buffer, poi quelle tornate all'inizio
+	int in_fondo = calendario->allocati - calendario->primo;
+	if (in_fondo > calendario->numel)
+		in_fondo = calendario->numel;
+	if (calendario->numel > 0)
+	{
+		memcpy(vet, &calendario->vet[calendario->primo], in_fondo * sizeof(lezione));
+		memcpy(&vet[in_fondo], calendario->vet, (calendario->numel - in_fondo) * sizeof(lezione));
+	}
+
+	free(calendario->vet);
+	free(calendario->indice);
+	calendario->vet = vet;
+	calendario->primo = 0;
+	calendario->allocati = allocati;
+	calendario->indice = indice;
+	calendario->maschera = 2 * allocati - 1;
+
+	for (int i = 0; i < calendario->numel; i++)
+	{
+		uint64_t chiave = (uint64_t)vet[i].inizio;
+		if (chiave != NESSUN_INIZIO && indice[posizione_indice(calendario, chiave)].chiave == NESSUN_INIZIO)
+			aggiungi_indice(calendario, chiave, i);
+	}
+	return 1;
+}
+
+/* Funzione: fisica
+*
+* Restituisce l'indice in vet della lezione in posizione 'posizione' dalla testa
+*/
+static int fisica(coda calendario, int posizione)
+{
+	return (calendario->primo + posizione) % calendario->allocati;
+}
+
+/* Funzione: posizione_ordinata
+*
+* Restituisce la prima posizione dalla testa la cui lezione inizia dopo 'inizio'
+*
+* Descrizione:
+* Ricerca binaria sulle posizioni: la coda è ordinata per inizio
+*/
+static int posizione_ordinata(coda calendario, int64_t inizio)
+{
+	int basso = 0;
+	int alto = calendario->numel;
+
+	while (basso < alto)
+	{
+		int medio = basso + (alto - basso) / 2;
+		if (calendario->vet[fisica(calendario, medio)].inizio <= inizio)
+			basso = medio + 1;
+		else
+			alto = medio;
+	}
+	return basso;
+}
+
+/* Funzione: sposta_lezione
+*
+* Copia la lezione da vet[da] a vet[a], aggiornando l'indice se la conosce in vet[da]
+*/
+static void sposta_lezione(coda calendario, int da, int a)
+{
+	calendario->vet[a] = calendario->vet[da];
+
+	uint64_t chiave = (uint64_t)calendario->vet[a].inizio;
+	if (chiave == NESSUN_INIZIO)
+		return;
+
+	struct voce_indice *voce = &calendario->indice[posizione_indice(calendario, chiave)];
+	if (voce->chiave == chiave && voce->indice == da)
+		voce->indice = a;
+}
+
+/* Funzione: posizione_indice
+*
+* Restituisce la voce dell'indice che contiene chiave oppure, se manca, la voce libera dove andrebbe inserita
+*
+* Descrizione:
+* La chiave viene sparsa con la costante di Fibonacci a 64 bit, di cui vengono presi i bit alti;
+* le collisioni proseguono sulla voce successiva. L'indice ha almeno metà delle voci libere
+*/
+static uint32_t posizione_indice(coda calendario, uint64_t chiave)
+{
+	uint32_t bit = (uint32_t)__builtin_popcount(calendario->maschera);
+	uint32_t posizione = (uint32_t)((chiave * 11400714819323198485ull) >> (64 - bit));
+
+	while (calendario->indice[posizione].chiave != NESSUN_INIZIO && calendario->indice[posizione].chiave != chiave)
+		posizione = (posizione + 1) & calendario->maschera;
+	return posizione;
+}
+
+/* Funzione: aggiungi_indice
+*
+* Registra nell'indice che la lezione con la chiave indicata si trova in vet[indice]
+*
+* Pre-condizione:
+* - chiave è diversa da NESSUN_INIZIO e non è già nell'indice
+*/
+static void aggiungi_indice(coda calendario, uint64_t chiave, int indice)
+{
+	struct voce_indice *voce = &calendario->indice[posizione_indice(calendario, chiave)];
+	voce->chiave = chiave;
+	voce->indice = indice;
+}
+
+/* Funzione: togli_indice
+*
+* Toglie dall'indice la chiave indicata, se corrisponde alla lezione in vet[indice]
+*
+* Descrizione:
+* Una lezione con la stessa chiave di un'altra che la precede non è nell'indice:
+* in quel caso la voce appartiene all'altra e resta. Dopo aver liberato la voce,
+* riporta indietro le voci successive del gruppo che non potrebbero più essere raggiunte,
+* così l'indice non accumula voci cancellate
+*/
+static void togli_indice(coda calendario, uint64_t chiave, int indice)
+{
+	if (chiave == NESSUN_INIZIO || calendario->indice == NULL)
+		return;
+
+	uint32_t libera = posizione_indice(calendario, chiave);
+	if (calendario->indice[libera].chiave != chiave || calendario->indice[libera].indice != indice)
+		return;
+
+	uint32_t bit = (uint32_t)__builtin_popcount(calendario->maschera);
+	uint32_t posizione = libera;
+	while (1)
+	{
+		posizione = (posizione + 1) & calendario->maschera;
+		struct voce_indice voce = calendario->indice[posizione];
+		if (voce.chiave == NESSUN_INIZIO)
+			break;
+
+		// La voce può occupare il posto liberato se la sua posizione naturale non sta tra il posto e lei
+		uint32_t naturale = (uint32_t)((voce.chiave * 11400714819323198485ull) >> (64 - bit));
+		if (((posizione - naturale) & calendario->maschera) >= ((posizione - libera) & calendario->maschera))
+		{
+			calendario->indice[libera] = voce;
+			libera = posizione;
+		}
+	}
+	calendario->indice[libera].chiave = NESSUN_INIZIO;
+}
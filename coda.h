@@ -3,7 +3,8 @@
 
 #include "abbonati.h"
 #include "lezione.h"
-#define ELEMENTO_NULLO ((lezione){ NULL, "", "", "" }) // Lezione nulla/vuota
+#define ELEMENTO_NULLO ((lezione){ NULL, NESSUN_INIZIO, NESSUNA_FASCIA, NULL }) // Lezione nulla/vuota
+#define NESSUN_GIORNO_GENERATO INT64_MIN // Calendario per cui genera_lezioni non ha ancora creato lezioni
 
 typedef struct c_coda *coda;
 
@@ -36,13 +37,14 @@ int coda_vuota(coda calendario);
 
 /* Funzione: inserisci_lezione
 *
-* Inserisce una nuova lezione in fondo alla coda calendario
+* Inserisce una nuova lezione nella coda calendario, mantenendola ordinata per inizio
 *
 * Descrizione:
-* La funzione alloca dinamicamente un nuovo nodo contenente la lezione da inserire
-* Se la coda è vuota imposta il nuovo nodo come testa della coda
-* Altrimenti lo collega in fondo alla coda esistente
-* In entrambi i casi aggiorna il puntatore alla coda e incrementa il numero di elementi
+* Le lezioni sono conservate in un buffer circolare che raddoppia quando è pieno:
+* l'inserimento non alloca memoria se non quando il buffer va allargato.
+* Una lezione che non inizia prima dell'ultima va in fondo in tempo costante; le altre
+* vengono collocate con una ricerca binaria, dopo quelle con lo stesso inizio.
+* La testa della coda è quindi sempre la lezione che inizia per prima
 * Restituisce 1 in caso di successo 0 se l'allocazione fallisce -1 se la coda è NULL
 *
 * Parametri:
@@ -56,13 +58,13 @@ int coda_vuota(coda calendario);
 * - Restituisce 1 se l’inserimento è riuscito, 0 se fallisce per allocazione, -1 se la coda è NULL
 *
 * Side-effect:
-* - Modifica la coda calendario aggiungendo un nodo in fondo e incrementando il numero di elementi
+* - Modifica la coda calendario aggiungendo una lezione e incrementando il numero di elementi
 */
 int inserisci_lezione(lezione val, coda calendario);
 
 /* Funzione: rimuovi_lezione
 *
-* Rimuove e restituisce la prima lezione presente nella coda calendario
+* Rimuove e restituisce la prima lezione presente nella coda calendario, cioè quella che inizia per prima
 *
 * Parametri:
 * calendario: la coda da cui rimuovere la lezione
@@ -74,8 +76,110 @@ int inserisci_lezione(lezione val, coda calendario);
 * - Se la coda è vuota restituisce ELEMENTO_NULLO, altrimenti restituisce la lezione rimossa
 *
 * Side-effect:
-* - Modifica la coda rimuovendo il primo nodo e aggiornando testa e numero di elementi
+* - Modifica la coda rimuovendo la prima lezione e aggiornando testa e numero di elementi
 */
 lezione rimuovi_lezione(coda calendario);
 
+/* Funzione: dimensione_coda
+*
+* Restituisce il numero di lezioni presenti nella coda calendario
+*
+* Parametri:
+* calendario: la coda da controllare
+*
+* Post-condizione:
+* - Restituisce il numero di lezioni, -1 se la coda è NULL
+*/
+int dimensione_coda(coda calendario);
+
+/* Funzione: elemento_coda
+*
+* Restituisce la lezione in posizione 'posizione' della coda, senza toglierla, in tempo costante
+*
+* Descrizione:
+* Le lezioni sono contigue in memoria: scorrere la coda con elemento_coda da 0 a dimensione_coda - 1
+* legge le lezioni in ordine di inizio
+*
+* Parametri:
+* calendario: la coda da leggere
+* posizione: distanza dalla testa, 0 per la prima lezione
+*
+* Pre-condizione:
+* - 'calendario' deve essere una coda inizializzata
+*
+* Post-condizione:
+* - Restituisce un puntatore alla lezione, che può essere modificata sul posto,
+*   oppure NULL se posizione è fuori dalla coda. Il puntatore resta valido
+*   fino al prossimo inserimento o rimozione
+*/
+lezione *elemento_coda(coda calendario, int posizione);
+
+/* Funzione: cerca_lezione
+*
+* Trova in tempo costante la lezione che inizia nell'istante indicato
+*
+* Descrizione:
+* La coda mantiene un indice per istante di inizio, che riassume data e fascia oraria,
+* aggiornato da inserisci_lezione e rimuovi_lezione. Se più lezioni hanno lo stesso
+* inizio, l'indice conosce la prima in ordine di coda; quando esce dalla testa
+* il suo posto passa alla successiva
+*
+* Parametri:
+* calendario: la coda in cui cercare
+* inizio: istante di inizio, come restituito da inizio_lezione o leggi_inizio
+*
+* Pre-condizione:
+* - 'calendario' deve essere una coda inizializzata
+* - Le lezioni nella coda non vanno modificate sul posto nel campo inizio
+*
+* Post-condizione:
+* - Restituisce un puntatore alla lezione, valido come quelli di elemento_coda, oppure NULL se non c'è
+*/
+lezione *cerca_lezione(coda calendario, int64_t inizio);
+
+/* Funzione: giorno_generato
+*
+* Restituisce l'ultimo giorno fino al quale sono state generate le lezioni del calendario
+*
+* Descrizione:
+* genera_lezioni crea le lezioni solo per i giorni successivi a questo; il giorno viene
+* salvato e ricaricato con il file delle lezioni
+*
+* Pre-condizione:
+* - 'calendario' deve essere una coda inizializzata
+*
+* Post-condizione:
+* - Restituisce il giorno, contato da giorno_civile, oppure NESSUN_GIORNO_GENERATO
+*/
+int64_t giorno_generato(coda calendario);
+
+/* Funzione: segna_giorno_generato
+*
+* Registra che le lezioni del calendario sono state generate fino al giorno indicato
+*
+* Parametri:
+* calendario: la coda da aggiornare
+* giorni: il giorno, contato da giorno_civile
+*
+* Pre-condizione:
+* - 'calendario' deve essere una coda inizializzata
+*
+* Side-effect:
+* - Il giorno registrato non torna mai indietro: un giorno precedente a quello già registrato viene ignorato
+*/
+void segna_giorno_generato(coda calendario, int64_t giorni);
+
+/* Funzione: distruggi_coda
+*
+* Libera la coda calendario e lo spazio delle sue lezioni
+*
+* Descrizione:
+* Le pile degli iscritti e le liste d'attesa appartengono alle lezioni e non vengono liberate:
+* chi le ha create le toglie prima con rimuovi_lezione
+*
+* Pre-condizione:
+* - 'calendario' è una coda inizializzata oppure NULL
+*/
+void distruggi_coda(coda calendario);
+
 #endif
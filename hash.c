@@ -2,14 +2,80 @@
 #include <stdlib.h>
 #include <string.h>
 #include "hash.h"  
+#include "hash_aperto.h"
+#include "arena.h"
+#include "bloom.h"
+#include "hash_perfetto.h"
+
+#define FATTORE_CARICO_MASSIMO 1 // Elementi per slot oltre i quali la tabella cresce
+#define PASSI_MIGRAZIONE 4 // Slot della vecchia tabella migrati ad ogni inserimento
+#define BLOCCO_ARENA 65536 // Byte per blocco dell'arena che contiene nodi e chiavi
+#define DIMENSIONE_MINIMA 10 // La tabella non viene mai ristretta sotto questo numero di slot
+#define CAPACITA_MINIMA_BLOOM 64 // Chiavi per cui viene dimensionato almeno il filtro di Bloom
+
+// Aggiornamento dei contatori delle statistiche: atomico perché più thread possono cercare
+// insieme nella stessa tabella (hash_concorrente.c); senza HASH_STATISTICHE non costa nulla
+#ifdef HASH_STATISTICHE
+#define REGISTRA(contatore, valore) __atomic_add_fetch(&(contatore), (valore), __ATOMIC_RELAXED)
+#else
+#define REGISTRA(contatore, valore) ((void)0)
+#endif
 
 // Struttura della tabella hash
 struct c_hash 
 {
+	motore_hash motore;
+	tabella_aperta aperta; // Usata solo dal motore HASH_APERTO
+	filtro_bloom bloom; // Filtro davanti alle ricerche, NULL se non attivato
+	indice_perfetto perfetto; // Indice a hash perfetto usato dalle ricerche, NULL se non costruito
+
+	arena memoria; // Nodi abbonato e chiavi, liberati tutti insieme da distruggi_hash
+	abbonato *liberi; // Nodi rimossi (collegati tramite prossimo), riusati dai prossimi inserimenti
+	riserva_hash riserva; // Abbonati copiati nella tabella solo quando servono, tutto NULL se non c'è
+
 	int dimensione;
+	int numel; // Numero di abbonati presenti (in entrambe le tabelle durante la migrazione)
 	abbonato **tabella;
+
+	// Rehashing incrementale: la vecchia tabella viene svuotata un po' alla volta
+	abbonato **vecchia; // Tabella in migrazione, NULL se non è in corso alcun rehashing
+	int dimensione_vecchia;
+	int prossimo_slot; // Primo slot della vecchia tabella non ancora migrato
+	long ridimensionamenti;
+
+	// Contatori aggiornati solo con HASH_STATISTICHE
+	long inserimenti;
+	long duplicati;
+	long rimozioni;
+	long ricerche_riuscite;
+	long ricerche_fallite;
+	long sondaggi_riusciti;
+	long sondaggi_falliti;
+	long confronti_riusciti;
+	long confronti_falliti;
 };
 
+static void migra_slot(tabella_hash h, int passi);
+static void avvia_ridimensionamento(tabella_hash h, int nuova_dimensione);
+static int stacca_da_catena(abbonato **testa, char *chiave, uint64_t hash, tabella_hash h);
+static abbonato *cerca_nodo(char *chiave, uint64_t hash, tabella_hash h, sondaggio *s);
+static abbonato *cerca_catena(abbonato *corrente, char *chiave, uint64_t hash, sondaggio *s);
+static void azzera_contatori(tabella_hash h);
+static void registra_catena(abbonato *corrente, statistiche_hash *s);
+static double media(long totale, long operazioni);
+static uint64_t mescola(uint64_t a, uint64_t b);
+static void ricostruisci_bloom(tabella_hash h);
+static void aggiungi_al_bloom(abbonato *corrente, void *filtro);
+static void aggiungi_a_elenco(abbonato *corrente, void *elenco);
+static abbonato *cerca_in_tabella(char *chiave, uint64_t hash, tabella_hash h);
+static int porta_da_riserva(const char *chiave, tabella_hash h);
+static int numero_nodi(tabella_hash h);
+static void visita_nodi(tabella_hash h, void (*visita)(abbonato *, void *), void *contesto);
+static void escludi_dalla_riserva(abbonato *corrente, void *tabella);
+static void copia_dalla_riserva(abbonato *corrente, void *tabella);
+
+static funzione_hash funzione_corrente = hash_chiave; // Funzione hash usata da tutte le tabelle
+
 /* Funzione: nuova_hash
 *
 * Crea e inizializza una nuova tabella hash
@@ -18,6 +84,8 @@ struct c_hash
 * Viene allocata dinamicamente una struttura hash e una tabella di puntatori a abbonato 
 * della dimensione specificata in input. Ogni slot della tabella viene inizializzato a NULL 
 * tramite calloc, garantendo che tutti i puntatori siano azzerati.
+* La tabella possiede un'arena da cui verranno allocati nodi e chiavi.
+* Il contatore degli elementi parte da zero e non c'è alcun rehashing in corso.
 *
 * Parametri:
 * dimensione: numero di slot nella tabella hash
@@ -38,10 +106,24 @@ tabella_hash nuova_hash(int dimensione)
 	if (h == NULL) 
     		return NULL;
 
+	h->motore = HASH_CATENE;
+	h->aperta = NULL;
+	h->bloom = NULL;
+	h->perfetto = NULL;
+	h->liberi = NULL;
+	memset(&h->riserva, 0, sizeof(riserva_hash));
 	h->dimensione = dimensione;
+	h->numel = 0;
+	h->vecchia = NULL;
+	h->dimensione_vecchia = 0;
+	h->prossimo_slot = 0;
+	azzera_contatori(h);
 	h->tabella = calloc(dimensione, sizeof(abbonato *));
-	if (h->tabella == NULL) 
+	h->memoria = nuova_arena(BLOCCO_ARENA);
+	if (h->tabella == NULL || h->memoria == NULL) 
     	{
+    		free(h->tabella);
+    		distruggi_arena(h->memoria);
     		free(h);
     		return NULL;
 	}
@@ -49,13 +131,102 @@ tabella_hash nuova_hash(int dimensione)
 	return h;
 }
 
+/* Funzione: nuova_hash_motore
+*
+* Crea e inizializza una nuova tabella hash che usa il motore indicato
+*
+* Descrizione:
+* Con HASH_CATENE equivale a nuova_hash. Con HASH_APERTO la struttura principale
+* delega tutte le operazioni al motore a indirizzamento aperto di hash_aperto.c
+*
+* Parametri:
+* dimensione: numero di abbonati previsti
+* motore: HASH_CATENE o HASH_APERTO
+*
+* Pre-condizione:
+* dimensione>0
+*
+* Post-condizione:
+* Restituisce una tabella hash vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per la nuova tabella hash
+*/
+tabella_hash nuova_hash_motore(int dimensione, motore_hash motore)
+{
+	if (motore == HASH_CATENE)
+		return nuova_hash(dimensione);
+
+	tabella_hash h = malloc(sizeof(struct c_hash));
+	if (h == NULL)
+		return NULL;
+
+	h->motore = HASH_APERTO;
+	h->bloom = NULL;
+	h->perfetto = NULL;
+	h->aperta = nuova_aperta(dimensione);
+	if (h->aperta == NULL)
+	{
+		free(h);
+		return NULL;
+	}
+
+	h->memoria = NULL;
+	h->liberi = NULL;
+	memset(&h->riserva, 0, sizeof(riserva_hash));
+	h->dimensione = 0;
+	h->numel = 0;
+	h->tabella = NULL;
+	h->vecchia = NULL;
+	h->dimensione_vecchia = 0;
+	h->prossimo_slot = 0;
+	azzera_contatori(h);
+	return h;
+}
+
+/* Funzione: distruggi_hash
+*
+* Libera la tabella hash e tutti gli abbonati che contiene
+*
+* Descrizione:
+* Nodi e chiavi non vengono liberati uno per uno: appartengono all'arena della tabella,
+* che viene rilasciata un blocco alla volta. Vengono poi liberati gli array di slot
+* (anche quello di un eventuale rehashing in corso) e la struttura principale
+*
+* Parametri:
+* h: tabella hash da distruggere
+*
+* Pre-condizione:
+* h è una tabella hash valida oppure NULL
+*
+* Post-condizione:
+* I puntatori ad abbonati restituiti da cerca_hash non sono più validi
+*
+* Side-effect:
+* Libera la memoria dinamica della tabella
+*/
+void distruggi_hash(tabella_hash h)
+{
+	if (h == NULL)
+		return;
+
+	if (h->motore == HASH_APERTO)
+		distruggi_aperta(h->aperta);
+
+	distruggi_bloom(h->bloom);
+	distruggi_perfetto(h->perfetto);
+	distruggi_arena(h->memoria);
+	free(h->tabella);
+	free(h->vecchia);
+	free(h);
+}
+
 /* Funzione: calcola_indice
 *
 * Calcola l'indice nella tabella hash associato alla stringa chiave
 *
 * Descrizione:
-* La funzione calcola un valore intero a partire da una stringa utilizzando 
-* una funzione di hash semplice basata su moltiplicazioni successive con 31 
+* La funzione calcola l'hash a 64 bit della chiave con calcola_hash
 * Il risultato viene poi ridotto modulo dimensione per garantire che l’indice rientri 
 * nell’intervallo valido degli slot della tabella hash
 *
@@ -70,6 +241,92 @@ tabella_hash nuova_hash(int dimensione)
 * 0<=indice<dimensione (l'indice denota quale slot della tabella andare a leggere o scrivere)
 */
 int calcola_indice(char *chiave, int dimensione)
+{
+	return calcola_hash(chiave) % dimensione;
+}
+
+/* Funzione: calcola_hash
+*
+* Calcola l'hash a 64 bit della chiave con la funzione hash in uso
+*
+* Pre-condizione:
+* chiave è una stringa non nulla che termina con \0
+*
+* Post-condizione:
+* Restituisce lo stesso valore per chiavi uguali
+*/
+uint64_t calcola_hash(const char *chiave)
+{
+	return funzione_corrente(chiave);
+}
+
+/* Funzione: imposta_funzione_hash
+*
+* Sostituisce la funzione hash usata da tutte le tabelle
+*
+* Parametri:
+* funzione: nuova funzione hash, NULL per tornare a hash_chiave
+*
+* Pre-condizione:
+* Non esistono tabelle hash contenenti abbonati (gli hash memorizzati non verrebbero ricalcolati)
+*/
+void imposta_funzione_hash(funzione_hash funzione)
+{
+	funzione_corrente = funzione != NULL ? funzione : hash_chiave;
+}
+
+/* Funzione: hash_chiave
+*
+* Funzione hash predefinita a 64 bit
+*
+* Descrizione:
+* La chiave viene letta una parola di 8 byte alla volta (memcpy evita letture non allineate);
+* ogni parola viene combinata con lo stato tramite una moltiplicazione a 128 bit di cui si
+* sommano in xor le due metà, come in wyhash. Gli ultimi byte (meno di 8) formano un'ultima
+* parola, e la lunghezza entra nel risultato così che "a" e "a\0\0" non collidano.
+* Nomi che differiscono per una sola cifra, come "utente1" e "utente2", cambiano
+* in media metà dei bit del risultato.
+*
+* Pre-condizione:
+* chiave è una stringa non nulla che termina con \0
+*/
+uint64_t hash_chiave(const char *chiave)
+{
+	const uint64_t segreto0 = 0xa0761d6478bd642fULL;
+	const uint64_t segreto1 = 0xe7037ed1a0b428dbULL;
+	const uint64_t segreto2 = 0x8ebc6af09c88c6e3ULL;
+
+	size_t lunghezza = strlen(chiave);
+	size_t rimasti = lunghezza;
+	uint64_t stato = segreto0 ^ lunghezza;
+	uint64_t parola;
+
+	// Parole complete di 8 byte
+	while (rimasti >= 8)
+	{
+		memcpy(&parola, chiave, 8);
+		stato = mescola(parola ^ segreto1, stato ^ segreto0);
+		chiave += 8;
+		rimasti -= 8;
+	}
+
+	// Byte finali
+	parola = 0;
+	memcpy(&parola, chiave, rimasti);
+	stato = mescola(parola ^ segreto1, stato ^ segreto2);
+
+	return mescola(stato ^ segreto0, lunghezza ^ segreto1);
+}
+
+/* Funzione: hash_polinomiale
+*
+* Funzione hash storica della tabella: hash = hash * 31 + c un byte alla volta, su 32 bit
+*
+* Descrizione:
+* Mantenuta per confronto nei benchmark; i nomi con lo stesso prefisso producono valori
+* vicini tra loro e i bit alti del risultato a 64 bit sono sempre zero
+*/
+uint64_t hash_polinomiale(const char *chiave)
 {
 	unsigned int hash = 0;
 
@@ -79,8 +336,7 @@ int calcola_indice(char *chiave, int dimensione)
     		hash = hash * 31 + *chiave++;
 	}
 
-	// Applica il modulo per ottenere l'indice
-	return hash % dimensione;
+	return hash;
 }
 
 /* Funzione: inserisci_hash
@@ -88,12 +344,21 @@ int calcola_indice(char *chiave, int dimensione)
 * Inserisce un nuovo elemento (nuovo) nella tabella hash h
 *
 * Descrizione:
-* La funzione calcola l’indice della chiave del nuovo abbonato all’interno della tabella hash, 
-* utilizzando la funzione calcola_indice. Scorre poi la lista collegata in quella posizione per 
-* verificare se la chiave è già presente: se sì, la funzione termina senza modificare la tabella. 
-* In caso contrario, alloca un nuovo nodo abbonato, duplica la chiave con strdup, copia 
-* nome utente e password (assicurandosi che siano null-terminate), e lo inserisce in testa 
-* alla lista nella posizione calcolata
+* Prima di inserire, se è in corso un rehashing, la funzione migra alcuni slot della vecchia
+* tabella nella nuova (PASSI_MIGRAZIONE), in modo che il costo del ridimensionamento venga
+* distribuito sugli inserimenti successivi invece di pesare su uno solo.
+* Verifica poi che la chiave non sia già presente, cercandola in entrambe le tabelle.
+* In caso contrario, riusa un nodo rimosso in precedenza oppure ne alloca uno nuovo dall'arena
+* della tabella, copia nome utente e password (assicurandosi che siano null-terminate);
+* se la chiave coincide con il nome utente punta direttamente al campo nomeutente del nodo,
+* altrimenti ne viene allocata una copia dall'arena. Poi memorizza l'hash della chiave
+* (così non dovrà più essere ricalcolato) e lo inserisce in testa alla lista nella posizione
+* calcolata della tabella corrente.
+* Se dopo l'inserimento il fattore di carico supera FATTORE_CARICO_MASSIMO e non c'è già
+* un rehashing in corso, viene allocata una tabella di dimensione doppia e avviata la migrazione.
+* Se il filtro di Bloom è attivo, l'hash del nuovo abbonato viene aggiunto anche al filtro.
+* Se la tabella ha una riserva, l'abbonato con la stessa chiave che vi si trova ancora viene
+* copiato prima nella tabella, così il nuovo risulta un duplicato come se fosse stato caricato.
 *
 * Parametri:
 * nuovo: elemento da inserire (contiene: chiave, nomeutente, password)
@@ -107,41 +372,97 @@ int calcola_indice(char *chiave, int dimensione)
 * Altrimenti la tabella rimane invariata
 *
 * Side-effect:
-* Viene allocata memoria dinamicamente per un nuovo nodo e duplicata la chiave
+* Il nuovo nodo e la copia della chiave vengono allocati dall'arena della tabella.
+* Può allocare una nuova tabella di slot e spostare nodi dalla vecchia tabella.
 */
 tabella_hash inserisci_hash(abbonato nuovo, tabella_hash h) 
 {
-	// Calcola la posizione nella tabella
-	int indice = calcola_indice(nuovo.chiave, h->dimensione);
-	abbonato *corrente = h->tabella[indice];
+	if (h->riserva.preleva != NULL)
+		porta_da_riserva(nuovo.chiave, h);
 
-	// Verifica se la chiave esiste già
-	while (corrente != NULL)
+	uint64_t hash = calcola_hash(nuovo.chiave);
+	if (h->motore == HASH_APERTO)
 	{
-    		if (strcmp(corrente->chiave, nuovo.chiave) == 0)
-        	{
-        		return h;  // Chiave già presente
-    		}
+		if (!inserisci_aperta(nuovo, hash, h->aperta))
+		{
+			REGISTRA(h->duplicati, 1);
+			return h;
+		}
+		REGISTRA(h->inserimenti, 1);
+		if (h->bloom != NULL)
+		{
+			aggiungi_bloom(h->bloom, hash);
+			if (da_ricostruire_bloom(h->bloom))
+				ricostruisci_bloom(h);
+		}
+		if (h->perfetto != NULL)
+		{
+			sondaggio s = { 0, 0 };
+			if (!aggiungi_perfetto(h->perfetto, cerca_aperta(nuovo.chiave, hash, h->aperta, &s)))
+				costruisci_perfetto_hash(h);
+		}
+		return h;
+	}
+
+	// Avanza il rehashing in corso
+	if (h->vecchia != NULL)
+		migra_slot(h, PASSI_MIGRAZIONE);
 
-    		corrente = corrente->prossimo;
+	// Verifica se la chiave esiste già
+	sondaggio s = { 0, 0 };
+	if (cerca_nodo(nuovo.chiave, hash, h, &s) != NULL)
+	{
+		REGISTRA(h->duplicati, 1);
+		return h;  // Chiave già presente
 	}
 
-	// Alloca il nuovo nodo
-	abbonato *nodo = malloc(sizeof(abbonato));
+	// Riusa un nodo rimosso o ne alloca uno dall'arena
+	abbonato *nodo = h->liberi;
+	if (nodo != NULL)
+		h->liberi = nodo->prossimo;
+	else
+		nodo = alloca_arena(h->memoria, sizeof(abbonato));
 	if (nodo == NULL) 
     		return h;
 
 	// Copia i dati dell'abbonato
-	nodo->chiave = strdup(nuovo.chiave);
 	strncpy(nodo->nomeutente, nuovo.nomeutente, MAX_CARATTERI - 1);
 	nodo->nomeutente[MAX_CARATTERI - 1] = '\0';
+	if (strcmp(nuovo.chiave, nodo->nomeutente) == 0)
+		nodo->chiave = nodo->nomeutente;
+	else
+		nodo->chiave = copia_stringa_arena(h->memoria, nuovo.chiave);
+	if (nodo->chiave == NULL)
+	{
+		nodo->prossimo = h->liberi;
+		h->liberi = nodo;
+		return h;
+	}
 	strncpy(nodo->password, nuovo.password, MAX_CARATTERI - 1);
 	nodo->password[MAX_CARATTERI - 1] = '\0';
 
-	// Inserisce in testa
+	// Inserisce in testa nella tabella corrente
+	int indice = hash % h->dimensione;
+	nodo->hash = hash;
 	nodo->lezioni_rimanenti = nuovo.lezioni_rimanenti;
+	nodo->ultima_attivita = nuovo.ultima_attivita;
 	nodo->prossimo = h->tabella[indice];
 	h->tabella[indice] = nodo;
+	h->numel++;
+	REGISTRA(h->inserimenti, 1);
+
+	if (h->bloom != NULL)
+	{
+		aggiungi_bloom(h->bloom, hash);
+		if (da_ricostruire_bloom(h->bloom))
+			ricostruisci_bloom(h);
+	}
+	if (h->perfetto != NULL && !aggiungi_perfetto(h->perfetto, nodo))
+		costruisci_perfetto_hash(h);
+
+	// Cresce se il fattore di carico è troppo alto
+	if (h->vecchia == NULL && h->numel > h->dimensione * FATTORE_CARICO_MASSIMO)
+		avvia_ridimensionamento(h, h->dimensione * 2);
 
 	return h;
 }
@@ -150,10 +471,21 @@ tabella_hash inserisci_hash(abbonato nuovo, tabella_hash h)
 * Cerca nella tabella hash h un elemento con chiave uguale a chiave e lo restituisce se trovato
 * 
 * Descrizione:
-* La funzione calcola l'indice associato alla chiave usando la funzione calcola_indice
+* La funzione calcola una sola volta l'hash a 64 bit della chiave e ne ricava l'indice
 * Poi scorre la lista collegata presente in quella posizione della tabella hash
+* confrontando prima gli hash memorizzati nei nodi e solo se coincidono le chiavi (strcmp)
 * Se trova un nodo con chiave uguale a quella cercata lo restituisce
+* Se è in corso un rehashing e la chiave non è nella tabella corrente, 
+* la cerca anche nella vecchia tabella (se lo slot non è ancora stato migrato)
 * In caso contrario restituisce NULL
+* Se il filtro di Bloom è attivo viene consultato per primo: la maggior parte delle chiavi
+* assenti viene scartata leggendo una sola linea di cache, senza scorrere alcuna catena.
+* Se è stato costruito l'indice a hash perfetto la ricerca avviene solo lì: uno slot,
+* un confronto e, se ci sono state iscrizioni dopo la costruzione, il piccolo trabocco.
+* Se la chiave manca e la tabella ha una riserva, l'abbonato viene cercato lì e, se c'è,
+* copiato nella tabella: dalla ricerca successiva viene trovato senza passare dalla riserva.
+* Filtro e indice descrivono solo gli abbonati già copiati, quindi un loro "assente"
+* non basta a escludere la riserva
 *
 * Parametri:
 * chiave: elemento da cercare nella tabella 
@@ -167,17 +499,741 @@ tabella_hash inserisci_hash(abbonato nuovo, tabella_hash h)
 */
 abbonato* cerca_hash(char *chiave, tabella_hash h) 
 {
-	// Calcola la posizione nella tabella
-	int indice = calcola_indice(chiave, h->dimensione);
-	abbonato *corrente = h->tabella[indice];
+	uint64_t hash = calcola_hash(chiave);
+	abbonato *trovato = cerca_in_tabella(chiave, hash, h);
+	if (trovato == NULL && h->riserva.preleva != NULL && porta_da_riserva(chiave, h))
+		trovato = cerca_in_tabella(chiave, hash, h);
+	return trovato;
+}
+
+/* Funzione: rimuovi_hash
+*
+* Rimuove dalla tabella hash l'abbonato con la chiave indicata
+*
+* Descrizione:
+* Con il motore a catene il nodo viene staccato subito dalla sua lista (nella tabella corrente
+* oppure, durante un rehashing, nella vecchia) e messo da parte per essere riusato dal
+* prossimo inserimento: la memoria dell'arena non cresce con le rimozioni.
+* Se dopo la rimozione la tabella è occupata per meno di un quarto, viene avviato un
+* rehashing incrementale verso una tabella di metà dimensione, così le catene restano
+* corte senza che una singola operazione debba spostare tutti i nodi.
+* Con il motore HASH_APERTO lo slot viene marcato come eliminato (tombstone);
+* superata una soglia di tombstone la tabella viene compattata in modo incrementale.
+* Il filtro di Bloom, se attivo, non può dimenticare una chiave: quando le chiavi rimosse
+* sono troppe viene ricostruito a partire dagli abbonati rimasti.
+* Se l'abbonato è ancora solo nella riserva, viene escluso da lì senza toccare la tabella
+*
+* Parametri:
+* chiave: chiave dell'abbonato da rimuovere
+* h: tabella hash da cui rimuovere l'abbonato
+*
+* Pre-condizione:
+* chiave è una stringa non vuota e h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato era presente ed è stato rimosso, 0 altrimenti.
+* Il puntatore all'abbonato rimosso non è più valido
+*/
+int rimuovi_hash(char *chiave, tabella_hash h)
+{
+	if (h->riserva.escludi != NULL && h->riserva.escludi(h->riserva.contesto, chiave))
+	{
+		REGISTRA(h->rimozioni, 1);
+		return 1; // Non era ancora stato copiato nella tabella
+	}
+
+	uint64_t hash = calcola_hash(chiave);
+	if (h->perfetto != NULL)
+		rimuovi_perfetto(h->perfetto, chiave, hash);
+
+	if (h->motore == HASH_APERTO)
+	{
+		if (!rimuovi_aperta(chiave, hash, h->aperta))
+			return 0;
+		REGISTRA(h->rimozioni, 1);
+		if (h->bloom != NULL)
+		{
+			rimozione_bloom(h->bloom);
+			if (da_ricostruire_bloom(h->bloom))
+				ricostruisci_bloom(h);
+		}
+		return 1;
+	}
+
+	// Anche le rimozioni fanno avanzare un rehashing in corso
+	if (h->vecchia != NULL)
+		migra_slot(h, PASSI_MIGRAZIONE);
+
+	int rimosso = stacca_da_catena(&h->tabella[hash % h->dimensione], chiave, hash, h);
+
+	// Durante un rehashing la chiave può trovarsi in uno slot non ancora migrato
+	if (!rimosso && h->vecchia != NULL)
+	{
+		int indice = hash % h->dimensione_vecchia;
+		if (indice >= h->prossimo_slot)
+			rimosso = stacca_da_catena(&h->vecchia[indice], chiave, hash, h);
+	}
+	if (!rimosso)
+		return 0;
+
+	h->numel--;
+	REGISTRA(h->rimozioni, 1);
+
+	if (h->bloom != NULL)
+	{
+		rimozione_bloom(h->bloom);
+		if (da_ricostruire_bloom(h->bloom))
+			ricostruisci_bloom(h);
+	}
+
+	// Restringe la tabella se è rimasta quasi vuota
+	if (h->vecchia == NULL && h->numel < h->dimensione / 4 && h->dimensione / 2 >= DIMENSIONE_MINIMA)
+		avvia_ridimensionamento(h, h->dimensione / 2);
+
+	return 1;
+}
+
+/* Funzione: numero_abbonati_hash
+*
+* Restituisce il numero di abbonati presenti nella tabella hash
+*
+* Parametri:
+* h: tabella hash da analizzare
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce il numero di elementi inseriti nella tabella, compresi quelli della riserva non ancora copiati
+*/
+int numero_abbonati_hash(tabella_hash h)
+{
+	int numero = numero_nodi(h);
+	if (h->riserva.numero != NULL)
+		numero += h->riserva.numero(h->riserva.contesto);
+	return numero;
+}
+
+/* Funzione: visita_hash
+*
+* Applica la funzione visita a ogni abbonato presente nella tabella hash
+*
+* Descrizione:
+* Scorre tutti gli slot della tabella corrente e, se è in corso un rehashing,
+* anche gli slot non ancora migrati della vecchia tabella, così che ogni abbonato
+* venga visitato esattamente una volta. Poi visita gli abbonati della riserva non ancora copiati:
+* la riserva li esclude quando vengono copiati, quindi nessuno viene visitato due volte
+*
+* Parametri:
+* h: tabella hash da scorrere
+* visita: funzione chiamata per ogni abbonato
+* contesto: puntatore passato invariato a ogni chiamata di visita
+*
+* Pre-condizione:
+* h è una tabella hash valida e visita non modifica le chiavi né inserisce nella tabella
+*/
+void visita_hash(tabella_hash h, void (*visita)(abbonato *, void *), void *contesto)
+{
+	visita_nodi(h, visita, contesto);
+	if (h->riserva.visita != NULL)
+		h->riserva.visita(h->riserva.contesto, visita, contesto);
+}
+
+/* Funzione: collega_riserva_hash
+*
+* Collega alla tabella una riserva da cui copiare gli abbonati solo quando servono
+*
+* Descrizione:
+* Gli abbonati già presenti nella tabella vengono esclusi dalla nuova riserva, così
+* visita_hash e numero_abbonati_hash non li contano due volte. Il costo è proporzionale
+* agli abbonati copiati finora, non a quelli della riserva
+*/
+void collega_riserva_hash(tabella_hash h, riserva_hash riserva)
+{
+	h->riserva = riserva;
+	visita_nodi(h, escludi_dalla_riserva, h);
+}
+
+/* Funzione: stacca_riserva_hash
+*
+* Copia nella tabella gli abbonati della riserva non ancora copiati e la scollega
+*
+* Descrizione:
+* La riserva viene scollegata prima della visita, così gli inserimenti non la consultano
+*/
+void stacca_riserva_hash(tabella_hash h)
+{
+	riserva_hash riserva = h->riserva;
+	memset(&h->riserva, 0, sizeof(riserva_hash));
+	if (riserva.visita != NULL)
+		riserva.visita(riserva.contesto, copia_dalla_riserva, h);
+}
+
+/* Funzione: visita_nodi
+*
+* Applica la funzione visita a ogni abbonato già presente nella tabella, senza la riserva
+*/
+static void visita_nodi(tabella_hash h, void (*visita)(abbonato *, void *), void *contesto)
+{
+	if (h->motore == HASH_APERTO)
+	{
+		visita_aperta(h->aperta, visita, contesto);
+		return;
+	}
+
+	for (int i = 0; i < h->dimensione; i++)
+		for (abbonato *corrente = h->tabella[i]; corrente != NULL; corrente = corrente->prossimo)
+			visita(corrente, contesto);
+
+	if (h->vecchia == NULL)
+		return;
+
+	for (int i = h->prossimo_slot; i < h->dimensione_vecchia; i++)
+		for (abbonato *corrente = h->vecchia[i]; corrente != NULL; corrente = corrente->prossimo)
+			visita(corrente, contesto);
+}
+
+/* Funzione: attiva_bloom_hash
+*
+* Attiva il filtro di Bloom davanti alle ricerche della tabella
+*
+* Descrizione:
+* Il filtro viene dimensionato per il doppio degli abbonati presenti (almeno CAPACITA_MINIMA_BLOOM)
+* e riempito con gli hash già memorizzati nei nodi, senza ricalcolarli.
+* Se il filtro era già attivo non succede nulla
+*
+* Parametri:
+* h: tabella hash su cui attivare il filtro
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce 1 se il filtro è attivo, 0 se l'allocazione è fallita
+*
+* Side-effect:
+* Alloca memoria dinamica per il filtro
+*/
+int attiva_bloom_hash(tabella_hash h)
+{
+	if (h->bloom != NULL)
+		return 1;
+
+	int numel = numero_nodi(h);
+	h->bloom = nuovo_bloom(numel * 2 > CAPACITA_MINIMA_BLOOM ? numel * 2 : CAPACITA_MINIMA_BLOOM);
+	if (h->bloom == NULL)
+		return 0;
+
+	visita_nodi(h, aggiungi_al_bloom, h->bloom);
+	return 1;
+}
+
+/* Funzione: statistiche_bloom_hash
+*
+* Legge i contatori del filtro di Bloom della tabella
+*
+* Parametri:
+* h: tabella hash da analizzare
+* s: struttura in cui scrivere i contatori
+*
+* Pre-condizione:
+* h è una tabella hash valida e s non è NULL
+*
+* Post-condizione:
+* Restituisce 1 e riempie s se il filtro è attivo, altrimenti restituisce 0 e s non viene modificata
+*/
+int statistiche_bloom_hash(tabella_hash h, statistiche_bloom *s)
+{
+	if (h->bloom == NULL)
+		return 0;
+
+	leggi_statistiche_bloom(h->bloom, s);
+	return 1;
+}
+
+/* Funzione: costruisci_perfetto_hash
+*
+* Costruisce (o ricostruisce) l'indice a hash perfetto usato dalle ricerche della tabella
+*
+* Descrizione:
+* L'indice viene costruito sui nodi già presenti, usando l'hash memorizzato in ognuno,
+* e sostituisce quello precedente, ripiegando nell'indice gli abbonati che erano nel trabocco.
+* Da questo momento inserimenti e rimozioni lo tengono aggiornato; quando il trabocco
+* si riempie viene ricostruito automaticamente.
+* Se la costruzione fallisce le ricerche tornano a usare solo la tabella
+*
+* Parametri:
+* h: tabella hash su cui costruire l'indice
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce 1 se l'indice è attivo, 0 se la costruzione è fallita
+*
+* Side-effect:
+* Alloca memoria dinamica per l'indice e, temporaneamente, per l'elenco dei nodi
+*/
+int costruisci_perfetto_hash(tabella_hash h)
+{
+	distruggi_perfetto(h->perfetto);
+	h->perfetto = NULL;
+
+	int numel = numero_nodi(h);
+	abbonato **elenco = malloc((numel > 0 ? numel : 1) * sizeof(abbonato *));
+	if (elenco == NULL)
+		return 0;
+
+	abbonato **prossimo = elenco;
+	visita_nodi(h, aggiungi_a_elenco, &prossimo);
+	h->perfetto = costruisci_perfetto(elenco, numel);
+	free(elenco);
+	return h->perfetto != NULL;
+}
+
+/* Funzione: leggi_statistiche_hash
+*
+* Descrive lo stato della tabella hash
+*
+* Descrizione:
+* Per le catene l'istogramma conta gli slot per lunghezza della catena, includendo
+* gli slot della vecchia tabella non ancora migrati; per l'indirizzamento aperto
+* la forma della tabella viene chiesta a statistiche_aperta.
+* I contatori delle operazioni vengono aggiornati solo se il programma è compilato
+* con HASH_STATISTICHE, altrimenti restano a zero e contatori_attivi vale 0
+*
+* Parametri:
+* h: tabella hash da analizzare
+* s: struttura in cui scrivere le statistiche
+*
+* Pre-condizione:
+* h è una tabella hash valida e s non è NULL
+*/
+void leggi_statistiche_hash(tabella_hash h, statistiche_hash *s)
+{
+	memset(s, 0, sizeof(statistiche_hash));
+	s->motore = h->motore;
+	s->abbonati = numero_nodi(h);
+	s->in_riserva = h->riserva.numero != NULL ? h->riserva.numero(h->riserva.contesto) : 0;
 
+	if (h->motore == HASH_APERTO)
+		statistiche_aperta(h->aperta, s);
+	else
+	{
+		s->slot = h->dimensione;
+		for (int i = 0; i < h->dimensione; i++)
+			registra_catena(h->tabella[i], s);
+		for (int i = h->prossimo_slot; i < h->dimensione_vecchia; i++)
+			registra_catena(h->vecchia[i], s);
+		s->ridimensionamenti = h->ridimensionamenti;
+	}
+	s->fattore_carico = s->slot > 0 ? (double)s->abbonati / s->slot : 0;
+
+#ifdef HASH_STATISTICHE
+	s->contatori_attivi = 1;
+#endif
+	s->inserimenti = h->inserimenti;
+	s->duplicati = h->duplicati;
+	s->rimozioni = h->rimozioni;
+	s->ricerche_riuscite = h->ricerche_riuscite;
+	s->ricerche_fallite = h->ricerche_fallite;
+	s->sondaggi_per_riuscita = media(h->sondaggi_riusciti, h->ricerche_riuscite);
+	s->sondaggi_per_fallita = media(h->sondaggi_falliti, h->ricerche_fallite);
+	s->confronti_per_riuscita = media(h->confronti_riusciti, h->ricerche_riuscite);
+	s->confronti_per_fallita = media(h->confronti_falliti, h->ricerche_fallite);
+}
+
+/* Funzione: stampa_statistiche_hash
+*
+* Stampa a video le statistiche della tabella hash e, se attivo, del suo filtro di Bloom
+*
+* Parametri:
+* h: tabella hash da analizzare
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Side-effect:
+* Output a schermo
+*/
+void stampa_statistiche_hash(tabella_hash h)
+{
+	statistiche_hash s;
+	leggi_statistiche_hash(h, &s);
+
+	int aperto = s.motore == HASH_APERTO;
+	printf("\nMotore: %s\n", aperto ? "indirizzamento aperto" : "catene");
+	printf("Abbonati: %d  Slot: %d  Vuoti: %d  Fattore di carico: %.2f\n",
+		s.abbonati, s.slot, s.slot_vuoti, s.fattore_carico);
+	printf("Ridimensionamenti: %ld\n", s.ridimensionamenti);
+	if (h->riserva.numero != NULL)
+		printf("Abbonati non ancora copiati dalla riserva: %d\n", s.in_riserva);
+
+	printf("%s\n", aperto ? "Abbonati per gruppi sondati:" : "Slot per lunghezza della catena:");
+	for (int i = 0; i < CLASSI_ISTOGRAMMA; i++)
+	{
+		int classe = aperto ? i + 1 : i;
+		printf("  %d%s: %d\n", classe, i == CLASSI_ISTOGRAMMA - 1 ? "+" : "", s.istogramma[i]);
+	}
+	printf("%s: %d\n", aperto ? "Gruppi sondati al massimo" : "Catena più lunga", s.lunghezza_massima);
+
+	if (s.contatori_attivi)
+	{
+		printf("Inserimenti: %ld  Duplicati: %ld  Rimozioni: %ld\n", s.inserimenti, s.duplicati, s.rimozioni);
+		printf("Ricerche riuscite: %ld  (%.2f sondaggi, %.2f confronti in media)\n",
+			s.ricerche_riuscite, s.sondaggi_per_riuscita, s.confronti_per_riuscita);
+		printf("Ricerche fallite: %ld  (%.2f sondaggi, %.2f confronti in media)\n",
+			s.ricerche_fallite, s.sondaggi_per_fallita, s.confronti_per_fallita);
+	}
+	else
+		printf("Contatori delle operazioni disattivati (compilare con -DHASH_STATISTICHE)\n");
+
+	if (h->perfetto != NULL)
+		printf("Indice a hash perfetto attivo, %d abbonati nel trabocco\n", aggiunti_perfetto(h->perfetto));
+
+	statistiche_bloom b;
+	if (statistiche_bloom_hash(h, &b))
+		printf("Filtro di Bloom: %ld interrogazioni, %.1f%% respinte, %.2f%% falsi positivi\n",
+			b.interrogazioni, b.tasso_respinte * 100, b.tasso_falsi_positivi * 100);
+}
+
+/* Funzione: cerca_in_tabella
+*
+* Cerca la chiave tra gli abbonati già presenti nella tabella, senza consultare la riserva
+*
+* Descrizione:
+* Consulta il filtro di Bloom, poi l'indice a hash perfetto se costruito, altrimenti il motore,
+* e aggiorna i contatori delle ricerche
+*/
+static abbonato *cerca_in_tabella(char *chiave, uint64_t hash, tabella_hash h)
+{
+	if (h->bloom != NULL && !forse_presente_bloom(h->bloom, hash))
+	{
+		REGISTRA(h->ricerche_fallite, 1);
+		return NULL;
+	}
+
+	abbonato *trovato;
+	sondaggio s = { 0, 0 };
+	if (h->perfetto != NULL)
+	{
+		CONTA(s.sondaggi);
+		trovato = cerca_perfetto(h->perfetto, chiave, hash);
+	}
+	else if (h->motore == HASH_APERTO)
+		trovato = cerca_aperta(chiave, hash, h->aperta, &s);
+	else
+		trovato = cerca_nodo(chiave, hash, h, &s);
+
+	if (trovato != NULL)
+	{
+		REGISTRA(h->ricerche_riuscite, 1);
+		REGISTRA(h->sondaggi_riusciti, s.sondaggi);
+		REGISTRA(h->confronti_riusciti, s.confronti);
+		return trovato;
+	}
+
+	REGISTRA(h->ricerche_fallite, 1);
+	REGISTRA(h->sondaggi_falliti, s.sondaggi);
+	REGISTRA(h->confronti_falliti, s.confronti);
+	if (h->bloom != NULL)
+		falso_positivo_bloom(h->bloom);
+	return NULL;
+}
+
+/* Funzione: cerca_nodo
+*
+* Cerca il nodo con la chiave (e l'hash) indicati nella tabella a catene
+*
+* Descrizione:
+* Cerca nella tabella corrente e, se è in corso un rehashing,
+* negli slot non ancora migrati della vecchia tabella
+*
+* Post-condizione:
+* Restituisce il nodo con chiave uguale a chiave, altrimenti NULL
+*/
+static abbonato *cerca_nodo(char *chiave, uint64_t hash, tabella_hash h, sondaggio *s)
+{
+	// Cerca nella tabella corrente
+	abbonato *trovato = cerca_catena(h->tabella[hash % h->dimensione], chiave, hash, s);
+	if (trovato != NULL || h->vecchia == NULL)
+		return trovato;
+
+	// Cerca negli slot non ancora migrati della vecchia tabella
+	int indice = hash % h->dimensione_vecchia;
+	if (indice < h->prossimo_slot)
+		return NULL;
+	return cerca_catena(h->vecchia[indice], chiave, hash, s);
+}
+
+/* Funzione: cerca_catena
+*
+* Scorre una lista collegata di abbonati cercando la chiave indicata
+*
+* Descrizione:
+* strcmp viene chiamata solo sui nodi il cui hash memorizzato coincide con quello cercato
+*
+* Post-condizione:
+* Restituisce il nodo con chiave uguale a chiave, altrimenti NULL.
+* Con HASH_STATISTICHE aggiunge a s i nodi esaminati e le chiamate a strcmp
+*/
+static abbonato *cerca_catena(abbonato *corrente, char *chiave, uint64_t hash, sondaggio *s)
+{
 	// Scorre la lista cercando la chiave
 	while (corrente != NULL) 
-    	{
-    		if (strcmp(corrente->chiave, chiave) == 0) 
-        	return corrente;
+	{
+		CONTA(s->sondaggi);
+		if (corrente->hash == hash && (CONTA(s->confronti), strcmp(corrente->chiave, chiave) == 0)) 
+			return corrente;
 
-    		corrente = corrente->prossimo;
+		corrente = corrente->prossimo;
 	}
 	return NULL;
 }
+
+/* Funzione: stacca_da_catena
+*
+* Stacca da una lista collegata il nodo con la chiave indicata e lo aggiunge ai nodi liberi
+*
+* Post-condizione:
+* Restituisce 1 se il nodo è stato trovato e staccato, 0 altrimenti
+*/
+static int stacca_da_catena(abbonato **testa, char *chiave, uint64_t hash, tabella_hash h)
+{
+	for (abbonato **collegamento = testa; *collegamento != NULL; collegamento = &(*collegamento)->prossimo)
+	{
+		abbonato *corrente = *collegamento;
+		if (corrente->hash == hash && strcmp(corrente->chiave, chiave) == 0)
+		{
+			*collegamento = corrente->prossimo;
+			corrente->prossimo = h->liberi;
+			h->liberi = corrente;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Funzione: avvia_ridimensionamento
+*
+* Alloca una tabella di slot della dimensione indicata e inizia la migrazione incrementale
+*
+* Descrizione:
+* La tabella corrente diventa la vecchia tabella, da cui i nodi verranno spostati 
+* poco alla volta dagli inserimenti successivi. La nuova dimensione è il doppio quando
+* la tabella cresce e la metà quando viene ristretta dopo molte rimozioni.
+* Se l'allocazione fallisce la tabella resta com'è: continuerà a funzionare con catene più lunghe
+*
+* Side-effect:
+* Alloca memoria dinamica per la nuova tabella di slot
+*/
+static void avvia_ridimensionamento(tabella_hash h, int nuova_dimensione)
+{
+	abbonato **nuova = calloc(nuova_dimensione, sizeof(abbonato *));
+	if (nuova == NULL)
+		return;
+
+	h->vecchia = h->tabella;
+	h->dimensione_vecchia = h->dimensione;
+	h->prossimo_slot = 0;
+	h->tabella = nuova;
+	h->dimensione = nuova_dimensione;
+	h->ridimensionamenti++;
+}
+
+/* Funzione: migra_slot
+*
+* Sposta nella tabella corrente i nodi dei prossimi slot della vecchia tabella
+*
+* Descrizione:
+* Vengono migrati al più 'passi' slot non vuoti, usando l'hash memorizzato in ogni nodo; per non fermarsi troppo a lungo su una
+* vecchia tabella quasi vuota, anche gli slot vuoti visitati hanno un limite (10 per passo).
+* Quando tutti gli slot sono stati migrati la vecchia tabella viene liberata
+*
+* Side-effect:
+* Modifica le liste collegate di entrambe le tabelle, può liberare la vecchia tabella
+*/
+static void migra_slot(tabella_hash h, int passi)
+{
+	int vuoti_massimi = passi * 10;
+
+	while (passi > 0 && h->prossimo_slot < h->dimensione_vecchia)
+	{
+		abbonato *corrente = h->vecchia[h->prossimo_slot];
+		if (corrente == NULL)
+		{
+			h->prossimo_slot++;
+			if (--vuoti_massimi == 0)
+				break;
+			continue;
+		}
+
+		// Sposta ogni nodo della catena nello slot della nuova tabella
+		while (corrente != NULL)
+		{
+			abbonato *prossimo = corrente->prossimo;
+			int indice = corrente->hash % h->dimensione;
+			corrente->prossimo = h->tabella[indice];
+			h->tabella[indice] = corrente;
+			corrente = prossimo;
+		}
+		h->vecchia[h->prossimo_slot] = NULL;
+		h->prossimo_slot++;
+		passi--;
+	}
+
+	// Migrazione completata
+	if (h->prossimo_slot >= h->dimensione_vecchia)
+	{
+		free(h->vecchia);
+		h->vecchia = NULL;
+		h->dimensione_vecchia = 0;
+		h->prossimo_slot = 0;
+	}
+}
+
+/* Funzione: mescola
+*
+* Moltiplica a 128 bit e restituisce lo xor delle due metà del prodotto
+*/
+static uint64_t mescola(uint64_t a, uint64_t b)
+{
+	__uint128_t prodotto = (__uint128_t)a * b;
+	return (uint64_t)prodotto ^ (uint64_t)(prodotto >> 64);
+}
+
+/* Funzione: ricostruisci_bloom
+*
+* Ricostruisce il filtro di Bloom dagli abbonati presenti
+*
+* Descrizione:
+* Chiamata quando il filtro ha ricevuto più chiavi di quelle per cui era dimensionato
+* o quando troppe delle sue chiavi sono state rimosse: il filtro viene ridimensionato per il doppio
+* degli abbonati presenti e riempito di nuovo. Il costo, proporzionale al numero di abbonati,
+* si ripaga sulle almeno numel/2 operazioni che servono per rendere necessaria la ricostruzione successiva.
+* Se l'allocazione fallisce il filtro viene disattivato, perché non potrebbe più garantire
+* di non scartare chiavi presenti
+*/
+static void ricostruisci_bloom(tabella_hash h)
+{
+	int numel = numero_nodi(h);
+	if (!svuota_bloom(h->bloom, numel * 2 > CAPACITA_MINIMA_BLOOM ? numel * 2 : CAPACITA_MINIMA_BLOOM))
+	{
+		distruggi_bloom(h->bloom);
+		h->bloom = NULL;
+		return;
+	}
+
+	visita_nodi(h, aggiungi_al_bloom, h->bloom);
+}
+
+/* Funzione: aggiungi_al_bloom
+*
+* Aggiunge al filtro l'hash memorizzato nel nodo (usata con visita_nodi)
+*/
+static void aggiungi_al_bloom(abbonato *corrente, void *filtro)
+{
+	aggiungi_bloom(filtro, corrente->hash);
+}
+
+/* Funzione: aggiungi_a_elenco
+*
+* Accoda il nodo all'elenco puntato da elenco (usata con visita_nodi)
+*/
+static void aggiungi_a_elenco(abbonato *corrente, void *elenco)
+{
+	abbonato ***prossimo = elenco;
+	*(*prossimo)++ = corrente;
+}
+
+/* Funzione: azzera_contatori
+*
+* Azzera il numero di ridimensionamenti e i contatori delle operazioni di una tabella appena creata
+*/
+static void azzera_contatori(tabella_hash h)
+{
+	h->ridimensionamenti = 0;
+	h->inserimenti = 0;
+	h->duplicati = 0;
+	h->rimozioni = 0;
+	h->ricerche_riuscite = 0;
+	h->ricerche_fallite = 0;
+	h->sondaggi_riusciti = 0;
+	h->sondaggi_falliti = 0;
+	h->confronti_riusciti = 0;
+	h->confronti_falliti = 0;
+}
+
+/* Funzione: registra_catena
+*
+* Aggiunge all'istogramma delle statistiche la lunghezza della catena che parte da corrente
+*/
+static void registra_catena(abbonato *corrente, statistiche_hash *s)
+{
+	int lunghezza = 0;
+	for (; corrente != NULL; corrente = corrente->prossimo)
+		lunghezza++;
+
+	if (lunghezza == 0)
+		s->slot_vuoti++;
+	s->istogramma[lunghezza < CLASSI_ISTOGRAMMA ? lunghezza : CLASSI_ISTOGRAMMA - 1]++;
+	if (lunghezza > s->lunghezza_massima)
+		s->lunghezza_massima = lunghezza;
+}
+
+/* Funzione: media
+*
+* Restituisce totale / operazioni, 0 se non ci sono operazioni
+*/
+static double media(long totale, long operazioni)
+{
+	return operazioni > 0 ? (double)totale / operazioni : 0;
+}
+
+/* Funzione: porta_da_riserva
+*
+* Copia nella tabella l'abbonato della riserva con la chiave indicata
+*
+* Post-condizione:
+* Restituisce 1 se la riserva lo conteneva ancora; da quel momento non lo restituisce più
+*/
+static int porta_da_riserva(const char *chiave, tabella_hash h)
+{
+	abbonato copia;
+	if (!h->riserva.preleva(h->riserva.contesto, chiave, &copia))
+		return 0;
+
+	copia.chiave = copia.nomeutente; // La tabella ne fa una copia
+	inserisci_hash(copia, h);
+	return 1;
+}
+
+/* Funzione: numero_nodi
+*
+* Restituisce il numero di abbonati già presenti nella tabella, senza la riserva
+*/
+static int numero_nodi(tabella_hash h)
+{
+	if (h->motore == HASH_APERTO)
+		return numero_aperta(h->aperta);
+	return h->numel;
+}
+
+/* Funzione: escludi_dalla_riserva
+*
+* Esclude dalla riserva della tabella l'abbonato già presente nella tabella (usata con visita_nodi)
+*/
+static void escludi_dalla_riserva(abbonato *corrente, void *tabella)
+{
+	tabella_hash h = tabella;
+	h->riserva.escludi(h->riserva.contesto, corrente->chiave);
+}
+
+/* Funzione: copia_dalla_riserva
+*
+* Inserisce nella tabella la copia temporanea di un abbonato della riserva (usata da stacca_riserva_hash)
+*/
+static void copia_dalla_riserva(abbonato *corrente, void *tabella)
+{
+	inserisci_hash(*corrente, tabella);
+}
@@ -6,9 +6,62 @@
 #include <string.h>
 #include "abbonati.h"
 #include "partecipante.h"
+#include "bloom.h"
 
 typedef struct c_hash *tabella_hash;
 
+// Funzione che calcola l'hash a 64 bit di una chiave terminata da \0
+typedef uint64_t (*funzione_hash)(const char *chiave);
+
+// Organizzazione interna della tabella hash
+typedef enum motore_hash
+{
+	HASH_CATENE, // Slot con liste collegate di abbonati (predefinito)
+	HASH_APERTO  // Indirizzamento aperto con impronte di un byte e membri contigui
+} motore_hash;
+
+// Abbonati che una tabella legge da un'altra struttura solo quando servono (vedi collega_riserva_hash).
+// La chiave di ogni abbonato della riserva è il suo nome utente. Un abbonato escluso è già stato
+// copiato nella tabella oppure rimosso: la riserva non lo restituisce né lo visita più
+typedef struct riserva_hash
+{
+	void *contesto; // Passato invariato a ogni funzione
+	int (*preleva)(void *contesto, const char *chiave, abbonato *copia); // Copia l'abbonato e lo esclude: 1 se c'era
+	int (*escludi)(void *contesto, const char *chiave); // 1 se l'abbonato c'era e non era già escluso
+	void (*visita)(void *contesto, void (*visita)(abbonato *, void *), void *dati); // Solo i non esclusi
+	int (*numero)(void *contesto); // Abbonati non esclusi
+} riserva_hash;
+
+#define CLASSI_ISTOGRAMMA 8 // Classi dell'istogramma delle statistiche: l'ultima raccoglie anche i valori maggiori
+
+// Stato di una tabella hash restituito da leggi_statistiche_hash
+typedef struct statistiche_hash
+{
+	motore_hash motore;
+	int abbonati; // Abbonati copiati nella tabella, senza quelli ancora nella riserva
+	int in_riserva; // Abbonati della riserva non ancora copiati nella tabella
+	int slot; // Slot della tabella corrente (catene) o del livello corrente (indirizzamento aperto)
+	int slot_vuoti;
+	double fattore_carico; // abbonati / slot
+	// Catene: numero di slot per lunghezza della catena (0, 1, 2, ...).
+	// Indirizzamento aperto: numero di abbonati per gruppi sondati prima di trovarli (1, 2, 3, ...)
+	int istogramma[CLASSI_ISTOGRAMMA];
+	int lunghezza_massima; // Catena più lunga o massimo numero di gruppi sondati
+	long ridimensionamenti; // Rehashing avviati: crescite, restringimenti e compattazioni
+
+	// Contatori delle operazioni: valgono 0 se il programma non è compilato con -DHASH_STATISTICHE
+	int contatori_attivi;
+	long inserimenti;
+	long duplicati; // Inserimenti ignorati perché la chiave era già presente
+	long rimozioni;
+	long ricerche_riuscite;
+	long ricerche_fallite; // Comprese quelle scartate dal filtro di Bloom
+	double sondaggi_per_riuscita; // Nodi (catene) o gruppi (indirizzamento aperto) esaminati in media
+	double sondaggi_per_fallita;
+	double confronti_per_riuscita; // Chiamate a strcmp in media
+	double confronti_per_fallita;
+} statistiche_hash;
+
 // Funzioni per la gestione della tabella hash
 /* Funzione: nuova_hash
 *
@@ -27,6 +80,43 @@ typedef struct c_hash *tabella_hash;
 */
 tabella_hash nuova_hash(int dimensione);
 
+/* Funzione: nuova_hash_motore
+*
+* Crea e inizializza una nuova tabella hash che usa il motore indicato
+* Parametri:
+* dimensione: numero di abbonati previsti
+* motore: HASH_CATENE o HASH_APERTO
+*
+* Pre-condizione:
+* dimensione>0
+*
+* Post-condizione:
+* Restituisce una tabella hash vuota che offre le stesse operazioni indipendentemente dal motore,
+* oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per la nuova tabella hash
+*/
+tabella_hash nuova_hash_motore(int dimensione, motore_hash motore);
+
+/* Funzione: distruggi_hash
+*
+* Libera la tabella hash e tutti gli abbonati che contiene
+* Parametri:
+* h: tabella hash da distruggere
+*
+* Pre-condizione:
+* h è una tabella hash valida oppure NULL
+*
+* Post-condizione:
+* I puntatori ad abbonati restituiti da cerca_hash non sono più validi
+*
+* Side-effect:
+* Libera la memoria dinamica della tabella, con un costo proporzionale al numero
+* di blocchi dell'arena e non al numero di abbonati
+*/
+void distruggi_hash(tabella_hash tabella);
+
 /* Funzione: calcola_indice
 *
 * Calcola l'indice nella tabella hash associato alla stringa chiave
@@ -42,6 +132,50 @@ tabella_hash nuova_hash(int dimensione);
 */
 int calcola_indice(char *chiave, int dimensione);
 
+/* Funzione: calcola_hash
+*
+* Calcola l'hash a 64 bit della chiave con la funzione hash in uso
+*
+* Pre-condizione:
+* chiave è una stringa non nulla che termina con \0
+*
+* Post-condizione:
+* Restituisce lo stesso valore per chiavi uguali
+*/
+uint64_t calcola_hash(const char *chiave);
+
+/* Funzione: imposta_funzione_hash
+*
+* Sostituisce la funzione hash usata da tutte le tabelle
+*
+* Parametri:
+* funzione: nuova funzione hash, NULL per tornare a hash_chiave
+*
+* Pre-condizione:
+* Non esistono tabelle hash contenenti abbonati (gli hash memorizzati non verrebbero ricalcolati).
+* La funzione deve distribuire bene tutti i 64 bit: il motore HASH_APERTO usa i 7 bit più alti come impronta
+*/
+void imposta_funzione_hash(funzione_hash funzione);
+
+/* Funzione: hash_chiave
+*
+* Funzione hash predefinita: legge la chiave 8 byte alla volta e mescola ogni parola
+* con una moltiplicazione a 128 bit (stile wyhash)
+*
+* Pre-condizione:
+* chiave è una stringa non nulla che termina con \0
+*/
+uint64_t hash_chiave(const char *chiave);
+
+/* Funzione: hash_polinomiale
+*
+* Funzione hash storica: hash = hash * 31 + c un byte alla volta, su 32 bit
+*
+* Pre-condizione:
+* chiave è una stringa non nulla che termina con \0
+*/
+uint64_t hash_polinomiale(const char *chiave);
+
 /* Funzione: inserisci_hash
 *
 * Inserisce un nuovo elemento (nuovo) nella tabella hash h
@@ -57,7 +191,10 @@ int calcola_indice(char *chiave, int dimensione);
 * Altrimenti la tabella rimane invariata
 *
 * Side-effect:
-* Viene allocata memoria dinamicamente per un nuovo nodo e duplicata la chiave.
+* Il nuovo abbonato e la copia della chiave vengono allocati dall'arena della tabella:
+* nuovo.chiave non viene trattenuta e resta di proprietà del chiamante.
+* Se il fattore di carico è troppo alto la tabella cresce; lo spostamento dei nodi
+* viene distribuito sugli inserimenti successivi (rehashing incrementale).
 */
 tabella_hash inserisci_hash(abbonato item, tabella_hash tabella);
 
@@ -69,11 +206,200 @@ tabella_hash inserisci_hash(abbonato item, tabella_hash tabella);
 * h: tabella hash in cui si cerca l'elemento
 *
 * Pre-condizione:
-* chiave è una stringa non vuota e h è una tabella hash valida
+* chiave è una stringa non vuota e tabella è una tabella hash valida
 *
 * Post-condizione:
 * restituisce l'elemento se presente nella tabella, altrimenti NULL
+*
+* Side-effect:
+* Se la tabella ha una riserva (collega_riserva_hash) e la chiave è solo lì,
+* l'abbonato viene copiato nella tabella: la ricerca diventa un inserimento
 */
 abbonato *cerca_hash(char *chiave, tabella_hash tabella);
 
+/* Funzione: rimuovi_hash
+*
+* Rimuove dalla tabella hash l'abbonato con la chiave indicata
+*
+* Parametri:
+* chiave: chiave dell'abbonato da rimuovere
+* tabella: tabella hash da cui rimuovere l'abbonato
+*
+* Pre-condizione:
+* chiave è una stringa non vuota e tabella è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato era presente ed è stato rimosso, 0 altrimenti.
+* Il puntatore all'abbonato rimosso non è più valido
+*
+* Side-effect:
+* Lo slot liberato viene riusato dagli inserimenti successivi; quando le rimozioni
+* si accumulano la tabella viene compattata in modo incrementale
+*/
+int rimuovi_hash(char *chiave, tabella_hash tabella);
+
+/* Funzione: numero_abbonati_hash
+*
+* Restituisce il numero di abbonati presenti nella tabella hash
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce il numero di elementi inseriti nella tabella, compresi quelli
+* della riserva non ancora copiati
+*/
+int numero_abbonati_hash(tabella_hash tabella);
+
+/* Funzione: visita_hash
+*
+* Applica la funzione visita a ogni abbonato presente nella tabella hash
+*
+* Parametri:
+* h: tabella hash da scorrere
+* visita: funzione chiamata per ogni abbonato
+* contesto: puntatore passato invariato a ogni chiamata di visita
+*
+* Pre-condizione:
+* h è una tabella hash valida e visita non modifica le chiavi né inserisce nella tabella
+*
+* Post-condizione:
+* visita viene chiamata esattamente una volta per ogni abbonato presente. Gli abbonati
+* della riserva non ancora copiati vengono passati come copie temporanee, valide solo durante la chiamata
+*/
+void visita_hash(tabella_hash tabella, void (*visita)(abbonato *, void *), void *contesto);
+
+/* Funzione: attiva_bloom_hash
+*
+* Attiva un filtro di Bloom a blocchi davanti alle ricerche della tabella
+*
+* Descrizione:
+* Il filtro viene aggiornato a ogni inserimento e consente a cerca_hash di scartare
+* quasi tutte le chiavi assenti leggendo una sola linea di cache
+*
+* Parametri:
+* h: tabella hash su cui attivare il filtro
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce 1 se il filtro è attivo, 0 se l'allocazione è fallita
+*
+* Side-effect:
+* Alloca memoria dinamica (circa 2 byte per abbonato) liberata da distruggi_hash
+*/
+int attiva_bloom_hash(tabella_hash h);
+
+/* Funzione: statistiche_bloom_hash
+*
+* Legge i contatori del filtro di Bloom della tabella
+*
+* Parametri:
+* h: tabella hash da analizzare
+* s: struttura in cui scrivere interrogazioni, respinte, falsi positivi e relativi tassi
+*
+* Pre-condizione:
+* h è una tabella hash valida e s non è NULL
+*
+* Post-condizione:
+* Restituisce 1 e riempie s se il filtro è attivo, altrimenti 0
+*/
+int statistiche_bloom_hash(tabella_hash h, statistiche_bloom *s);
+
+/* Funzione: costruisci_perfetto_hash
+*
+* Costruisce (o ricostruisce) un indice a hash perfetto minimo sugli abbonati della tabella
+*
+* Descrizione:
+* Pensato per il login, dove le ricerche sono molte più delle iscrizioni: ogni ricerca
+* legge un solo slot ed esegue un solo confronto tra chiavi. Gli abbonati inseriti dopo
+* la costruzione vanno in un piccolo trabocco, ripiegato nell'indice alla ricostruzione
+* successiva, che avviene da sola quando il trabocco si riempie
+*
+* Parametri:
+* h: tabella hash su cui costruire l'indice
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce 1 se l'indice è attivo, 0 se la costruzione è fallita (le ricerche usano la tabella)
+*
+* Side-effect:
+* Alloca memoria dinamica (circa 13 byte per abbonato) liberata da distruggi_hash
+*/
+int costruisci_perfetto_hash(tabella_hash h);
+
+/* Funzione: leggi_statistiche_hash
+*
+* Descrive lo stato della tabella hash: occupazione degli slot, lunghezza delle catene,
+* ridimensionamenti e, se abilitati, i contatori di ricerche, confronti e inserimenti
+*
+* Parametri:
+* h: tabella hash da analizzare
+* s: struttura in cui scrivere le statistiche
+*
+* Pre-condizione:
+* h è una tabella hash valida e s non è NULL
+*
+* Side-effect:
+* Scorre tutti gli slot: il costo è proporzionale alla dimensione della tabella
+*/
+void leggi_statistiche_hash(tabella_hash h, statistiche_hash *s);
+
+/* Funzione: stampa_statistiche_hash
+*
+* Stampa a video le statistiche della tabella hash (e del filtro di Bloom, se attivo)
+*
+* Parametri:
+* h: tabella hash da analizzare
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Side-effect:
+* Output a schermo
+*/
+void stampa_statistiche_hash(tabella_hash h);
+
+/* Funzione: collega_riserva_hash
+*
+* Collega alla tabella una riserva da cui copiare gli abbonati solo quando servono
+*
+* Descrizione:
+* Una tabella con riserva può partire vuota: cerca_hash e inserisci_hash copiano nella tabella
+* l'abbonato della riserva con la stessa chiave la prima volta che viene chiesto, rimuovi_hash
+* lo esclude dalla riserva, visita_hash e numero_abbonati_hash contano anche i non copiati.
+* Gli abbonati già presenti nella tabella vengono esclusi subito dalla riserva.
+* Una riserva collegata al posto di un'altra deve contenere tutti gli abbonati non ancora copiati
+* da quella precedente
+*
+* Parametri:
+* h: tabella hash
+* riserva: funzioni e contesto della riserva
+*
+* Pre-condizione:
+* h è una tabella hash valida a cui non accedono altri thread: anche le ricerche la modificano
+*
+* Post-condizione:
+* La riserva viene usata fino a stacca_riserva_hash o a distruggi_hash, che non la libera
+*/
+void collega_riserva_hash(tabella_hash h, riserva_hash riserva);
+
+/* Funzione: stacca_riserva_hash
+*
+* Copia nella tabella gli abbonati della riserva non ancora copiati e la scollega
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* La tabella contiene tutti i suoi abbonati e non usa più la riserva, che può essere chiusa
+*
+* Side-effect:
+* Alloca un nodo per ogni abbonato copiato
+*/
+void stacca_riserva_hash(tabella_hash h);
+
 #endif
@@ -0,0 +1,657 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "abbonati.h"
+#include "hash.h"
+#include "hash_aperto.h"
+#include "arena.h"
+
+#define GRUPPO 16 // Slot esaminati insieme ad ogni passo di ricerca
+#define VUOTO 0x80 // Byte di controllo di uno slot libero (le impronte usano solo 7 bit)
+#define ELIMINATO 0xFE // Byte di controllo di uno slot rimosso (tombstone): la ricerca non si ferma
+#define MEMBRI_PER_BLOCCO 1024 // Abbonati contigui in ogni blocco dell'array dei membri
+#define PASSI_MIGRAZIONE 4 // Gruppi della vecchia tabella migrati ad ogni inserimento
+
+// Array di slot: un byte di controllo e l'indice di un membro per ogni slot
+struct livello
+{
+	unsigned char *controlli;
+	uint32_t *membri;
+	size_t gruppi; // Numero di gruppi, sempre potenza di due
+};
+
+// Struttura della tabella a indirizzamento aperto
+struct c_aperta
+{
+	struct livello corrente;
+	struct livello vecchio; // Livello in migrazione, controlli == NULL se non c'è rehashing
+	size_t prossimo_gruppo; // Primo gruppo del vecchio livello non ancora migrato
+	int numel; // Membri presenti
+	int eliminati; // Tombstone nel livello corrente
+	int soglia; // Slot occupati (membri più tombstone) oltre i quali il livello corrente va ricostruito
+	long ridimensionamenti; // Rehashing avviati (crescite e compattazioni)
+
+	// Array contiguo dei membri, diviso in blocchi che non vengono mai spostati.
+	// Blocchi e chiavi sono allocati dall'arena della tabella
+	arena memoria;
+	abbonato **blocchi;
+	int numero_blocchi;
+	int usati; // Posizioni dell'array dei membri già usate, compresi i membri rimossi
+
+	// Posizioni di membri rimossi, riusate dai prossimi inserimenti
+	uint32_t *liberi;
+	int numero_liberi;
+	int capacita_liberi;
+};
+
+static int crea_livello(struct livello *l, size_t gruppi);
+static uint32_t confronta_gruppo(const unsigned char *controlli, unsigned char valore);
+static abbonato *membro(tabella_aperta t, uint32_t indice);
+static long trova(tabella_aperta t, const char *chiave, uint64_t h, sondaggio *s);
+static long trova_nel_livello(tabella_aperta t, struct livello *l, const char *chiave, uint64_t h, sondaggio *s);
+static int gruppi_sondati(struct livello *l, uint64_t h, uint32_t indice);
+static int metti_nel_livello(struct livello *l, uint64_t h, uint32_t indice);
+static long nuovo_membro(tabella_aperta t);
+static int riserva_libero(tabella_aperta t);
+static void avvia_ridimensionamento(tabella_aperta t, size_t gruppi);
+static void migra_gruppi(tabella_aperta t, size_t passi);
+
+/* Funzione: nuova_aperta
+*
+* Crea una tabella a indirizzamento aperto in grado di contenere almeno 'dimensione' abbonati
+*
+* Descrizione:
+* Il numero di gruppi è la più piccola potenza di due che tiene il fattore di carico sotto 7/8.
+* Tutti i byte di controllo vengono posti a VUOTO
+*
+* Pre-condizione:
+* dimensione>0
+*
+* Post-condizione:
+* Restituisce una tabella vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per i byte di controllo e gli slot
+*/
+tabella_aperta nuova_aperta(int dimensione)
+{
+	tabella_aperta t = malloc(sizeof(struct c_aperta));
+	if (t == NULL)
+		return NULL;
+
+	size_t gruppi = 1;
+	while (gruppi * GRUPPO * 7 / 8 < (size_t)dimensione)
+		gruppi *= 2;
+
+	t->memoria = nuova_arena(MEMBRI_PER_BLOCCO * sizeof(abbonato));
+	if (t->memoria == NULL)
+	{
+		free(t);
+		return NULL;
+	}
+	if (!crea_livello(&t->corrente, gruppi))
+	{
+		distruggi_arena(t->memoria);
+		free(t);
+		return NULL;
+	}
+
+	t->vecchio.controlli = NULL;
+	t->vecchio.membri = NULL;
+	t->vecchio.gruppi = 0;
+	t->prossimo_gruppo = 0;
+	t->numel = 0;
+	t->eliminati = 0;
+	t->soglia = gruppi * GRUPPO * 7 / 8;
+	t->ridimensionamenti = 0;
+	t->blocchi = NULL;
+	t->numero_blocchi = 0;
+	t->usati = 0;
+	t->liberi = NULL;
+	t->numero_liberi = 0;
+	t->capacita_liberi = 0;
+	return t;
+}
+
+/* Funzione: inserisci_aperta
+*
+* Inserisce una copia di nuovo se la sua chiave non è già presente
+*
+* Descrizione:
+* Se è in corso un rehashing vengono prima migrati alcuni gruppi del vecchio livello.
+* Dopo aver verificato che la chiave non sia presente in nessuno dei due livelli,
+* l'abbonato viene copiato nella posizione di un membro rimosso oppure in fondo all'array
+* contiguo dei membri, e il suo indice viene scritto nel primo slot vuoto o eliminato
+* della sequenza di gruppi associata al suo hash.
+* Quando membri e tombstone raggiungono la soglia viene avviato un rehashing: verso un livello
+* con gli stessi gruppi se i tombstone sono molti (compattazione), altrimenti con il doppio dei gruppi
+*
+* Pre-condizione:
+* t è una tabella valida, nuovo.chiave è una stringa non vuota
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato inserito, 0 se la chiave era già presente o l'allocazione è fallita
+*
+* Side-effect:
+* Copia l'abbonato nell'array contiguo dei membri, può far crescere la tabella
+*/
+int inserisci_aperta(abbonato nuovo, uint64_t hash, tabella_aperta t)
+{
+	// Avanza il rehashing in corso
+	if (t->vecchio.controlli != NULL)
+		migra_gruppi(t, PASSI_MIGRAZIONE);
+
+	sondaggio s = { 0, 0 };
+	if (trova(t, nuovo.chiave, hash, &s) >= 0)
+		return 0; // Chiave già presente
+
+	// Ricostruisce il livello prima di riempirlo troppo (se non riesce, la tabella resta invariata)
+	if (t->numel + t->eliminati >= t->soglia)
+	{
+		size_t gruppi = t->corrente.gruppi;
+		avvia_ridimensionamento(t, t->eliminati >= t->soglia / 4 ? gruppi : gruppi * 2);
+		if (t->numel + t->eliminati >= t->soglia)
+			return 0;
+	}
+
+	long indice = nuovo_membro(t);
+	if (indice < 0)
+		return 0;
+
+	// Copia i dati dell'abbonato; se la chiave è il nome utente non serve una copia a parte
+	abbonato *m = membro(t, indice);
+	strncpy(m->nomeutente, nuovo.nomeutente, MAX_CARATTERI - 1);
+	m->nomeutente[MAX_CARATTERI - 1] = '\0';
+	if (strcmp(nuovo.chiave, m->nomeutente) == 0)
+		m->chiave = m->nomeutente;
+	else
+		m->chiave = copia_stringa_arena(t->memoria, nuovo.chiave);
+	if (m->chiave == NULL)
+	{
+		// Restituisce la posizione; se non c'è spazio per ricordarla resta inutilizzata (chiave NULL)
+		if (riserva_libero(t))
+			t->liberi[t->numero_liberi++] = indice;
+		return 0;
+	}
+	strncpy(m->password, nuovo.password, MAX_CARATTERI - 1);
+	m->password[MAX_CARATTERI - 1] = '\0';
+	m->hash = hash;
+	m->lezioni_rimanenti = nuovo.lezioni_rimanenti;
+	m->ultima_attivita = nuovo.ultima_attivita;
+	m->prossimo = NULL;
+
+	if (metti_nel_livello(&t->corrente, hash, indice))
+		t->eliminati--;
+	t->numel++;
+	return 1;
+}
+
+/* Funzione: rimuovi_aperta
+*
+* Rimuove l'abbonato con la chiave indicata
+*
+* Descrizione:
+* Lo slot che punta al membro viene marcato ELIMINATO in entrambi i livelli (durante un rehashing
+* i gruppi già migrati sono ancora presenti nel vecchio livello): le ricerche lo attraversano
+* senza fermarsi. La posizione del membro viene messa da parte per il prossimo inserimento.
+* Se i tombstone superano un quarto della soglia, il livello viene ricostruito con lo stesso numero
+* di gruppi tramite il rehashing incrementale, che copia solo gli slot ancora occupati: le ricerche
+* continuano a funzionare durante la compattazione e ogni operazione ne esegue solo un pezzo
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato rimosso, 0 se non era presente
+*/
+int rimuovi_aperta(char *chiave, uint64_t hash, tabella_aperta t)
+{
+	if (t->vecchio.controlli != NULL)
+		migra_gruppi(t, PASSI_MIGRAZIONE);
+
+	sondaggio s = { 0, 0 };
+	long slot = trova_nel_livello(t, &t->corrente, chiave, hash, &s);
+	long slot_vecchio = -1;
+	if (t->vecchio.controlli != NULL)
+		slot_vecchio = trova_nel_livello(t, &t->vecchio, chiave, hash, &s);
+	if (slot < 0 && slot_vecchio < 0)
+		return 0;
+
+	// Spazio per ricordare la posizione liberata
+	if (!riserva_libero(t))
+		return 0;
+
+	uint32_t indice = slot >= 0 ? t->corrente.membri[slot] : t->vecchio.membri[slot_vecchio];
+	if (slot >= 0)
+	{
+		t->corrente.controlli[slot] = ELIMINATO;
+		t->eliminati++;
+	}
+	if (slot_vecchio >= 0)
+		t->vecchio.controlli[slot_vecchio] = ELIMINATO;
+
+	membro(t, indice)->chiave = NULL;
+	t->liberi[t->numero_liberi++] = indice;
+	t->numel--;
+
+	// Compatta se i tombstone sono troppi
+	if (t->vecchio.controlli == NULL && t->eliminati > t->soglia / 4)
+		avvia_ridimensionamento(t, t->corrente.gruppi);
+
+	return 1;
+}
+
+/* Funzione: cerca_aperta
+*
+* Cerca l'abbonato con la chiave indicata
+*
+* Descrizione:
+* Cerca nel livello corrente e, se non trova la chiave ed è in corso un rehashing,
+* anche nel vecchio livello. I gruppi migrati non vengono svuotati: puntano agli stessi
+* membri del livello corrente, quindi il risultato è lo stesso da qualunque livello provenga
+*
+* Post-condizione:
+* Restituisce il puntatore all'abbonato (stabile finché l'abbonato non viene rimosso) oppure NULL
+*/
+abbonato *cerca_aperta(char *chiave, uint64_t hash, tabella_aperta t, sondaggio *s)
+{
+	long indice = trova(t, chiave, hash, s);
+	return indice < 0 ? NULL : membro(t, indice);
+}
+
+/* Funzione: numero_aperta
+*
+* Restituisce il numero di abbonati presenti nella tabella
+*/
+int numero_aperta(tabella_aperta t)
+{
+	return t->numel;
+}
+
+/* Funzione: visita_aperta
+*
+* Applica visita a ogni abbonato, nell'ordine delle posizioni nell'array dei membri
+*
+* Descrizione:
+* Scorre direttamente l'array contiguo dei membri, senza passare dagli slot,
+* saltando le posizioni dei membri rimossi (chiave NULL)
+*/
+void visita_aperta(tabella_aperta t, void (*visita)(abbonato *, void *), void *contesto)
+{
+	for (int i = 0; i < t->usati; i++)
+	{
+		abbonato *m = membro(t, i);
+		if (m->chiave != NULL)
+			visita(m, contesto);
+	}
+}
+
+/* Funzione: statistiche_aperta
+*
+* Scrive in s la forma della tabella
+*
+* Descrizione:
+* Gli slot e gli slot vuoti sono quelli del livello corrente (i tombstone non sono vuoti).
+* Per ogni abbonato viene ripercorsa la sequenza di gruppi della sua ricerca, nel livello
+* in cui si trova: la classe i dell'istogramma conta gli abbonati trovati al gruppo i+1,
+* l'ultima anche quelli trovati più avanti. Il costo è proporzionale al numero di abbonati
+*/
+void statistiche_aperta(tabella_aperta t, statistiche_hash *s)
+{
+	s->slot = t->corrente.gruppi * GRUPPO;
+	s->slot_vuoti = 0;
+	for (size_t i = 0; i < t->corrente.gruppi * GRUPPO; i++)
+		if (t->corrente.controlli[i] == VUOTO)
+			s->slot_vuoti++;
+
+	memset(s->istogramma, 0, sizeof(s->istogramma));
+	s->lunghezza_massima = 0;
+	for (int i = 0; i < t->usati; i++)
+	{
+		abbonato *m = membro(t, i);
+		if (m->chiave == NULL)
+			continue;
+
+		int gruppi = gruppi_sondati(&t->corrente, m->hash, i);
+		if (gruppi == 0 && t->vecchio.controlli != NULL)
+			gruppi = gruppi_sondati(&t->vecchio, m->hash, i);
+		if (gruppi == 0)
+			continue;
+
+		s->istogramma[gruppi < CLASSI_ISTOGRAMMA ? gruppi - 1 : CLASSI_ISTOGRAMMA - 1]++;
+		if (gruppi > s->lunghezza_massima)
+			s->lunghezza_massima = gruppi;
+	}
+	s->ridimensionamenti = t->ridimensionamenti;
+}
+
+/* Funzione: distruggi_aperta
+*
+* Libera la tabella, i membri e le loro chiavi
+*
+* Descrizione:
+* Membri e chiavi vengono rilasciati insieme all'arena, poi vengono liberati
+* gli slot dei livelli e l'indice dei blocchi
+*
+* Pre-condizione:
+* t è una tabella valida
+*/
+void distruggi_aperta(tabella_aperta t)
+{
+	distruggi_arena(t->memoria);
+	free(t->blocchi);
+	free(t->liberi);
+	free(t->corrente.controlli);
+	free(t->corrente.membri);
+	free(t->vecchio.controlli);
+	free(t->vecchio.membri);
+	free(t);
+}
+
+/* Funzione: crea_livello
+*
+* Alloca gli slot di un livello con il numero di gruppi indicato
+*
+* Post-condizione:
+* Restituisce 1 se l'allocazione è riuscita, 0 altrimenti
+*/
+static int crea_livello(struct livello *l, size_t gruppi)
+{
+	l->controlli = malloc(gruppi * GRUPPO);
+	l->membri = malloc(gruppi * GRUPPO * sizeof(uint32_t));
+	if (l->controlli == NULL || l->membri == NULL)
+	{
+		free(l->controlli);
+		free(l->membri);
+		return 0;
+	}
+
+	memset(l->controlli, VUOTO, gruppi * GRUPPO);
+	l->gruppi = gruppi;
+	return 1;
+}
+
+/* Funzione: confronta_gruppo
+*
+* Confronta i GRUPPO byte di controllo con valore
+*
+* Descrizione:
+* Con SSE2 il confronto dei 16 byte avviene con una sola istruzione, altrimenti byte per byte
+*
+* Post-condizione:
+* Il bit i del risultato è 1 se e solo se controlli[i] == valore
+*/
+static uint32_t confronta_gruppo(const unsigned char *controlli, unsigned char valore)
+{
+#ifdef __SSE2__
+	__m128i gruppo = _mm_loadu_si128((const __m128i *)controlli);
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(gruppo, _mm_set1_epi8((char)valore)));
+#else
+	uint32_t maschera = 0;
+	for (int i = 0; i < GRUPPO; i++)
+		if (controlli[i] == valore)
+			maschera |= 1u << i;
+	return maschera;
+#endif
+}
+
+/* Funzione: membro
+*
+* Restituisce l'abbonato di posizione indice nell'array dei membri
+*/
+static abbonato *membro(tabella_aperta t, uint32_t indice)
+{
+	return &t->blocchi[indice / MEMBRI_PER_BLOCCO][indice % MEMBRI_PER_BLOCCO];
+}
+
+/* Funzione: trova
+*
+* Cerca la chiave nel livello corrente e, durante un rehashing, nel vecchio livello
+*
+* Post-condizione:
+* Restituisce l'indice del membro con la chiave indicata, -1 se non presente
+*/
+static long trova(tabella_aperta t, const char *chiave, uint64_t h, sondaggio *s)
+{
+	long slot = trova_nel_livello(t, &t->corrente, chiave, h, s);
+	if (slot >= 0)
+		return t->corrente.membri[slot];
+
+	if (t->vecchio.controlli != NULL)
+	{
+		slot = trova_nel_livello(t, &t->vecchio, chiave, h, s);
+		if (slot >= 0)
+			return t->vecchio.membri[slot];
+	}
+	return -1;
+}
+
+/* Funzione: trova_nel_livello
+*
+* Cerca la chiave negli slot di un livello
+*
+* Descrizione:
+* I bit bassi dell'hash scelgono il gruppo di partenza, i 7 bit alti sono l'impronta
+* salvata nel byte di controllo di ogni slot occupato. In ogni gruppo si confrontano le chiavi
+* (strcmp) solo degli slot con la stessa impronta e lo stesso hash memorizzato. La ricerca prosegue sui gruppi
+* successivi (sondaggio triangolare) e si ferma al primo gruppo che contiene uno slot vuoto;
+* gli slot eliminati non fermano la ricerca
+*
+* Post-condizione:
+* Restituisce la posizione dello slot che punta al membro con la chiave indicata, -1 se non presente.
+* Con HASH_STATISTICHE aggiunge a s i gruppi esaminati e le chiamate a strcmp
+*/
+static long trova_nel_livello(tabella_aperta t, struct livello *l, const char *chiave, uint64_t h, sondaggio *s)
+{
+	unsigned char h2 = h >> 57;
+	size_t maschera_gruppi = l->gruppi - 1;
+	size_t g = h & maschera_gruppi;
+
+	for (size_t passo = 1; passo <= l->gruppi; passo++)
+	{
+		const unsigned char *controlli = l->controlli + g * GRUPPO;
+		CONTA(s->sondaggi);
+
+		uint32_t candidati = confronta_gruppo(controlli, h2);
+		while (candidati != 0)
+		{
+			size_t slot = g * GRUPPO + __builtin_ctz(candidati);
+			abbonato *m = membro(t, l->membri[slot]);
+			if (m->hash == h && (CONTA(s->confronti), strcmp(m->chiave, chiave) == 0))
+				return slot;
+			candidati &= candidati - 1;
+		}
+
+		if (confronta_gruppo(controlli, VUOTO) != 0)
+			return -1;
+
+		g = (g + passo) & maschera_gruppi;
+	}
+	return -1;
+}
+
+/* Funzione: gruppi_sondati
+*
+* Conta i gruppi che una ricerca esamina nel livello prima di trovare lo slot del membro indicato
+*
+* Post-condizione:
+* Restituisce il numero di gruppi (almeno 1), 0 se il livello non contiene il membro
+*/
+static int gruppi_sondati(struct livello *l, uint64_t h, uint32_t indice)
+{
+	unsigned char h2 = h >> 57;
+	size_t maschera_gruppi = l->gruppi - 1;
+	size_t g = h & maschera_gruppi;
+
+	for (size_t passo = 1; passo <= l->gruppi; passo++)
+	{
+		const unsigned char *controlli = l->controlli + g * GRUPPO;
+
+		uint32_t candidati = confronta_gruppo(controlli, h2);
+		while (candidati != 0)
+		{
+			if (l->membri[g * GRUPPO + __builtin_ctz(candidati)] == indice)
+				return passo;
+			candidati &= candidati - 1;
+		}
+
+		if (confronta_gruppo(controlli, VUOTO) != 0)
+			return 0;
+
+		g = (g + passo) & maschera_gruppi;
+	}
+	return 0;
+}
+
+/* Funzione: metti_nel_livello
+*
+* Scrive l'indice di un membro nel primo slot vuoto o eliminato della sua sequenza di gruppi
+*
+* Pre-condizione:
+* Il livello contiene almeno uno slot vuoto
+*
+* Post-condizione:
+* Restituisce 1 se è stato riusato uno slot eliminato, 0 se è stato usato uno slot vuoto
+*/
+static int metti_nel_livello(struct livello *l, uint64_t h, uint32_t indice)
+{
+	size_t maschera_gruppi = l->gruppi - 1;
+	size_t g = h & maschera_gruppi;
+
+	for (size_t passo = 1; ; passo++)
+	{
+		const unsigned char *controlli = l->controlli + g * GRUPPO;
+		uint32_t liberi = confronta_gruppo(controlli, VUOTO) | confronta_gruppo(controlli, ELIMINATO);
+		if (liberi != 0)
+		{
+			size_t slot = g * GRUPPO + __builtin_ctz(liberi);
+			int riusato = l->controlli[slot] == ELIMINATO;
+			l->controlli[slot] = h >> 57;
+			l->membri[slot] = indice;
+			return riusato;
+		}
+		g = (g + passo) & maschera_gruppi;
+	}
+}
+
+/* Funzione: nuovo_membro
+*
+* Restituisce la posizione in cui copiare un nuovo membro
+*
+* Descrizione:
+* Riusa per prima la posizione di un membro rimosso; altrimenti usa la prima posizione
+* mai usata, allocando dall'arena un nuovo blocco di membri quando quello corrente è pieno
+*
+* Post-condizione:
+* Restituisce la posizione, -1 se l'allocazione fallisce
+*/
+static long nuovo_membro(tabella_aperta t)
+{
+	if (t->numero_liberi > 0)
+		return t->liberi[--t->numero_liberi];
+
+	if (t->usati % MEMBRI_PER_BLOCCO == 0)
+	{
+		abbonato **blocchi = realloc(t->blocchi, (t->numero_blocchi + 1) * sizeof(abbonato *));
+		if (blocchi == NULL)
+			return -1;
+		t->blocchi = blocchi;
+		t->blocchi[t->numero_blocchi] = alloca_arena(t->memoria, MEMBRI_PER_BLOCCO * sizeof(abbonato));
+		if (t->blocchi[t->numero_blocchi] == NULL)
+			return -1;
+		t->numero_blocchi++;
+	}
+	return t->usati++;
+}
+
+/* Funzione: riserva_libero
+*
+* Assicura che ci sia spazio per ricordare almeno un'altra posizione libera
+*
+* Post-condizione:
+* Restituisce 1 se t->liberi può ricevere un'altra posizione, 0 se l'allocazione fallisce
+*/
+static int riserva_libero(tabella_aperta t)
+{
+	if (t->numero_liberi < t->capacita_liberi)
+		return 1;
+
+	int capacita = t->capacita_liberi ? t->capacita_liberi * 2 : 16;
+	uint32_t *liberi = realloc(t->liberi, capacita * sizeof(uint32_t));
+	if (liberi == NULL)
+		return 0;
+	t->liberi = liberi;
+	t->capacita_liberi = capacita;
+	return 1;
+}
+
+/* Funzione: avvia_ridimensionamento
+*
+* Alloca un livello con il numero di gruppi indicato e inizia la migrazione incrementale
+*
+* Descrizione:
+* Con il doppio dei gruppi la tabella cresce; con lo stesso numero di gruppi viene compattata,
+* perché nel nuovo livello vengono copiati solo gli slot occupati e non i tombstone.
+* Se una migrazione precedente non è ancora terminata viene completata subito.
+* Se l'allocazione fallisce il livello corrente viene mantenuto
+*
+* Side-effect:
+* Alloca memoria dinamica per il nuovo livello
+*/
+static void avvia_ridimensionamento(tabella_aperta t, size_t gruppi)
+{
+	if (t->vecchio.controlli != NULL)
+		migra_gruppi(t, t->vecchio.gruppi);
+
+	struct livello nuovo;
+	if (!crea_livello(&nuovo, gruppi))
+		return;
+
+	t->vecchio = t->corrente;
+	t->corrente = nuovo;
+	t->prossimo_gruppo = 0;
+	t->eliminati = 0;
+	t->ridimensionamenti++;
+	t->soglia = nuovo.gruppi * GRUPPO * 7 / 8;
+}
+
+/* Funzione: migra_gruppi
+*
+* Copia nel livello corrente gli slot dei prossimi gruppi del vecchio livello
+*
+* Descrizione:
+* La posizione nel nuovo livello si ricava dall'hash memorizzato nel membro, senza rileggere la chiave.
+* Gli slot copiati restano anche nel vecchio livello, così le ricerche che lo attraversano
+* continuano a funzionare. Quando tutti i gruppi sono stati copiati il vecchio livello viene liberato
+*
+* Side-effect:
+* Scrive nel livello corrente, può liberare il vecchio livello
+*/
+static void migra_gruppi(tabella_aperta t, size_t passi)
+{
+	while (passi > 0 && t->prossimo_gruppo < t->vecchio.gruppi)
+	{
+		size_t inizio = t->prossimo_gruppo * GRUPPO;
+		for (size_t s = inizio; s < inizio + GRUPPO; s++)
+		{
+			if (t->vecchio.controlli[s] == VUOTO || t->vecchio.controlli[s] == ELIMINATO)
+				continue;
+			uint32_t indice = t->vecchio.membri[s];
+			if (metti_nel_livello(&t->corrente, membro(t, indice)->hash, indice))
+				t->eliminati--;
+		}
+		t->prossimo_gruppo++;
+		passi--;
+	}
+
+	// Migrazione completata
+	if (t->prossimo_gruppo >= t->vecchio.gruppi)
+	{
+		free(t->vecchio.controlli);
+		free(t->vecchio.membri);
+		t->vecchio.controlli = NULL;
+		t->vecchio.membri = NULL;
+		t->vecchio.gruppi = 0;
+	}
+}
@@ -0,0 +1,111 @@
+#ifndef HASH_APERTO_H
+#define HASH_APERTO_H
+
+#include "abbonati.h"
+#include "hash.h"
+
+// Motore a indirizzamento aperto usato da hash.c: non va incluso dal resto del programma
+typedef struct c_aperta *tabella_aperta;
+
+// Lavoro svolto da una ricerca: catene o gruppi esaminati e chiavi confrontate con strcmp
+typedef struct sondaggio
+{
+	int sondaggi;
+	int confronti;
+} sondaggio;
+
+// Il lavoro delle ricerche viene contato solo se il programma è compilato con -DHASH_STATISTICHE
+#ifdef HASH_STATISTICHE
+#define CONTA(contatore) ((contatore)++)
+#else
+#define CONTA(contatore) ((void)0)
+#endif
+
+/* Funzione: nuova_aperta
+*
+* Crea una tabella a indirizzamento aperto in grado di contenere almeno 'dimensione' abbonati
+*
+* Pre-condizione:
+* dimensione>0
+*
+* Post-condizione:
+* Restituisce una tabella vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per i byte di controllo e gli slot
+*/
+tabella_aperta nuova_aperta(int dimensione);
+
+/* Funzione: inserisci_aperta
+*
+* Inserisce una copia di nuovo se la sua chiave non è già presente
+*
+* Pre-condizione:
+* t è una tabella valida, nuovo.chiave è una stringa non vuota e hash è calcola_hash(nuovo.chiave)
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato inserito, 0 altrimenti
+*
+* Side-effect:
+* Copia l'abbonato nell'array contiguo dei membri (riusando la posizione di un membro rimosso),
+* può far crescere la tabella
+*/
+int inserisci_aperta(abbonato nuovo, uint64_t hash, tabella_aperta t);
+
+/* Funzione: cerca_aperta
+*
+* Cerca l'abbonato con la chiave indicata
+*
+* Pre-condizione:
+* hash è calcola_hash(chiave)
+*
+* Post-condizione:
+* Restituisce il puntatore all'abbonato (stabile finché l'abbonato non viene rimosso) oppure NULL.
+* Con HASH_STATISTICHE aggiunge a s i gruppi esaminati e le chiavi confrontate
+*/
+abbonato *cerca_aperta(char *chiave, uint64_t hash, tabella_aperta t, sondaggio *s);
+
+/* Funzione: rimuovi_aperta
+*
+* Rimuove l'abbonato con la chiave indicata, lasciando un tombstone nel suo slot
+*
+* Pre-condizione:
+* hash è calcola_hash(chiave)
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato rimosso, 0 se non era presente
+*
+* Side-effect:
+* Può avviare una compattazione incrementale della tabella
+*/
+int rimuovi_aperta(char *chiave, uint64_t hash, tabella_aperta t);
+
+/* Funzione: numero_aperta
+*
+* Restituisce il numero di abbonati presenti nella tabella
+*/
+int numero_aperta(tabella_aperta t);
+
+/* Funzione: visita_aperta
+*
+* Applica visita a ogni abbonato, nell'ordine delle posizioni nell'array dei membri
+*/
+void visita_aperta(tabella_aperta t, void (*visita)(abbonato *, void *), void *contesto);
+
+/* Funzione: statistiche_aperta
+*
+* Scrive in s la forma della tabella: slot, slot vuoti, ridimensionamenti e istogramma
+* degli abbonati per numero di gruppi sondati prima di trovarli
+*/
+void statistiche_aperta(tabella_aperta t, statistiche_hash *s);
+
+/* Funzione: distruggi_aperta
+*
+* Libera la tabella, i membri e le loro chiavi
+*
+* Pre-condizione:
+* t è una tabella valida
+*/
+void distruggi_aperta(tabella_aperta t);
+
+#endif
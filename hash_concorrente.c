@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "abbonati.h"
+#include "hash.h"
+#include "hash_concorrente.h"
+
+#define STRISCE 64 // Numero di strisce, potenza di due
+#define BIT_STRISCIA 32 // Primo bit dell'hash usato per scegliere la striscia
+
+// Una striscia occupa una linea di cache propria: i lock di strisce vicine non si contendono la stessa linea
+struct striscia
+{
+	_Alignas(64) pthread_rwlock_t lock;
+	tabella_hash tabella;
+};
+
+// Struttura della tabella concorrente
+struct c_concorrente
+{
+	struct striscia strisce[STRISCE];
+};
+
+static struct striscia *striscia_di(tabella_concorrente t, const char *chiave);
+
+/* Funzione: nuova_concorrente
+*
+* Crea una tabella degli abbonati utilizzabile da più thread contemporaneamente
+*
+* Descrizione:
+* Ogni striscia riceve una tabella dimensionata per la sua quota degli abbonati previsti.
+* La striscia di una chiave è scelta dai bit 32-37 del suo hash: i motori usano i bit bassi
+* per lo slot e i 7 bit più alti come impronta, che restano così ben distribuiti
+* anche dentro ogni striscia
+*
+* Parametri:
+* dimensione: numero di abbonati previsti
+* motore: motore delle tabelle interne (HASH_CATENE o HASH_APERTO)
+*
+* Pre-condizione:
+* dimensione>0
+*
+* Post-condizione:
+* Restituisce una tabella vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per le strisce e le loro tabelle
+*/
+tabella_concorrente nuova_concorrente(int dimensione, motore_hash motore)
+{
+	tabella_concorrente t = aligned_alloc(64, sizeof(struct c_concorrente));
+	if (t == NULL)
+		return NULL;
+
+	int quota = dimensione / STRISCE + 1;
+	for (int i = 0; i < STRISCE; i++)
+	{
+		t->strisce[i].tabella = nuova_hash_motore(quota, motore);
+		if (t->strisce[i].tabella == NULL || pthread_rwlock_init(&t->strisce[i].lock, NULL) != 0)
+		{
+			distruggi_hash(t->strisce[i].tabella);
+			for (int j = 0; j < i; j++)
+			{
+				pthread_rwlock_destroy(&t->strisce[j].lock);
+				distruggi_hash(t->strisce[j].tabella);
+			}
+			free(t);
+			return NULL;
+		}
+	}
+	return t;
+}
+
+/* Funzione: inserisci_concorrente
+*
+* Inserisce una copia di nuovo se la sua chiave non è già presente
+*
+* Descrizione:
+* La presenza della chiave viene verificata e l'abbonato inserito sotto lo stesso lock in scrittura,
+* così due thread che registrano lo stesso nome non possono inserirlo entrambi
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato inserito, 0 se la chiave era già presente
+*/
+int inserisci_concorrente(abbonato nuovo, tabella_concorrente t)
+{
+	struct striscia *s = striscia_di(t, nuovo.chiave);
+
+	pthread_rwlock_wrlock(&s->lock);
+	int prima = numero_abbonati_hash(s->tabella);
+	s->tabella = inserisci_hash(nuovo, s->tabella);
+	int inserito = numero_abbonati_hash(s->tabella) > prima;
+	pthread_rwlock_unlock(&s->lock);
+
+	return inserito;
+}
+
+/* Funzione: cerca_concorrente
+*
+* Copia l'abbonato con la chiave indicata
+*
+* Descrizione:
+* Più thread possono tenere insieme il lock in lettura della stessa striscia, quindi le ricerche
+* non si bloccano a vicenda; aspettano solo un inserimento o una rimozione nella stessa striscia.
+* L'abbonato viene copiato prima di rilasciare il lock: dopo, una rimozione può rimettere il nodo
+* tra quelli liberi e un inserimento riusarlo per un altro abbonato.
+* Le lezioni vengono lette in modo atomico perché altri lettori possono modificarle insieme.
+* Le ricerche non modificano la tabella: sulle tabelle interne non va attivato il filtro di Bloom,
+* i cui contatori vengono aggiornati a ogni ricerca
+*/
+int cerca_concorrente(char *chiave, tabella_concorrente t, abbonato *copia)
+{
+	struct striscia *s = striscia_di(t, chiave);
+
+	pthread_rwlock_rdlock(&s->lock);
+	abbonato *trovato = cerca_hash(chiave, s->tabella);
+	if (trovato != NULL && copia != NULL)
+	{
+		copia->chiave = NULL;
+		copia->hash = trovato->hash;
+		memcpy(copia->nomeutente, trovato->nomeutente, MAX_CARATTERI);
+		memcpy(copia->password, trovato->password, MAX_CARATTERI);
+		copia->lezioni_rimanenti = __atomic_load_n(&trovato->lezioni_rimanenti, __ATOMIC_RELAXED);
+		copia->ultima_attivita = trovato->ultima_attivita;
+		copia->prossimo = NULL;
+	}
+	pthread_rwlock_unlock(&s->lock);
+
+	return trovato != NULL;
+}
+
+/* Funzione: rimuovi_concorrente
+*
+* Rimuove l'abbonato con la chiave indicata
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato rimosso, 0 se non era presente
+*/
+int rimuovi_concorrente(char *chiave, tabella_concorrente t)
+{
+	struct striscia *s = striscia_di(t, chiave);
+
+	pthread_rwlock_wrlock(&s->lock);
+	int rimosso = rimuovi_hash(chiave, s->tabella);
+	pthread_rwlock_unlock(&s->lock);
+
+	return rimosso;
+}
+
+/* Funzione: numero_concorrente
+*
+* Restituisce il numero di abbonati presenti nella tabella, sommando quelli di ogni striscia
+*/
+int numero_concorrente(tabella_concorrente t)
+{
+	int totale = 0;
+	for (int i = 0; i < STRISCE; i++)
+	{
+		pthread_rwlock_rdlock(&t->strisce[i].lock);
+		totale += numero_abbonati_hash(t->strisce[i].tabella);
+		pthread_rwlock_unlock(&t->strisce[i].lock);
+	}
+	return totale;
+}
+
+/* Funzione: leggi_lezioni_concorrente
+*
+* Legge in modo atomico le lezioni rimanenti dell'abbonato con la chiave indicata
+*
+* Descrizione:
+* Il lock in lettura basta: impedisce solo le rimozioni, non le modifiche atomiche degli altri lettori
+*/
+int leggi_lezioni_concorrente(char *chiave, tabella_concorrente t, int *lezioni)
+{
+	struct striscia *s = striscia_di(t, chiave);
+
+	pthread_rwlock_rdlock(&s->lock);
+	abbonato *utente = cerca_hash(chiave, s->tabella);
+	if (utente != NULL)
+		*lezioni = __atomic_load_n(&utente->lezioni_rimanenti, __ATOMIC_RELAXED);
+	pthread_rwlock_unlock(&s->lock);
+
+	return utente != NULL;
+}
+
+/* Funzione: modifica_lezioni_concorrente
+*
+* Aggiunge in modo atomico variazione alle lezioni rimanenti dell'abbonato con la chiave indicata
+*
+* Descrizione:
+* La somma è una sola istruzione atomica sul campo dell'abbonato, eseguita tenendo il lock
+* in lettura della striscia: il nodo non può essere rimosso e riusato per un altro abbonato
+* tra la ricerca e la modifica, e le prenotazioni di abbonati diversi non si bloccano
+*/
+int modifica_lezioni_concorrente(char *chiave, tabella_concorrente t, int variazione, int *saldo)
+{
+	struct striscia *s = striscia_di(t, chiave);
+
+	pthread_rwlock_rdlock(&s->lock);
+	abbonato *utente = cerca_hash(chiave, s->tabella);
+	int nuovo = utente != NULL ? __atomic_add_fetch(&utente->lezioni_rimanenti, variazione, __ATOMIC_RELAXED) : 0;
+	pthread_rwlock_unlock(&s->lock);
+
+	if (utente != NULL && saldo != NULL)
+		*saldo = nuovo;
+	return utente != NULL;
+}
+
+/* Funzione: preleva_lezione_concorrente
+*
+* Toglie una lezione all'abbonato con la chiave indicata solo se ne ha almeno una, in modo atomico
+*
+* Descrizione:
+* Ciclo di compare-and-swap, eseguito tenendo il lock in lettura della striscia come
+* in modifica_lezioni_concorrente: se un altro thread cambia il saldo tra la lettura
+* e la scrittura, il confronto fallisce e il controllo viene ripetuto sul valore aggiornato
+*/
+int preleva_lezione_concorrente(char *chiave, tabella_concorrente t)
+{
+	struct striscia *s = striscia_di(t, chiave);
+	int prelevata = 0;
+
+	pthread_rwlock_rdlock(&s->lock);
+	abbonato *utente = cerca_hash(chiave, s->tabella);
+	int saldo = utente != NULL ? __atomic_load_n(&utente->lezioni_rimanenti, __ATOMIC_RELAXED) : 0;
+	while (!prelevata && saldo > 0)
+		prelevata = __atomic_compare_exchange_n(&utente->lezioni_rimanenti, &saldo, saldo - 1, 1,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	pthread_rwlock_unlock(&s->lock);
+
+	return prelevata;
+}
+
+/* Funzione: distruggi_concorrente
+*
+* Libera la tabella e tutti gli abbonati che contiene
+*/
+void distruggi_concorrente(tabella_concorrente t)
+{
+	if (t == NULL)
+		return;
+
+	for (int i = 0; i < STRISCE; i++)
+	{
+		pthread_rwlock_destroy(&t->strisce[i].lock);
+		distruggi_hash(t->strisce[i].tabella);
+	}
+	free(t);
+}
+
+/* Funzione: striscia_di
+*
+* Restituisce la striscia a cui appartiene la chiave
+*/
+static struct striscia *striscia_di(tabella_concorrente t, const char *chiave)
+{
+	return &t->strisce[(calcola_hash(chiave) >> BIT_STRISCIA) & (STRISCE - 1)];
+}
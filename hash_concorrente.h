@@ -0,0 +1,147 @@
+#ifndef HASH_CONCORRENTE_H
+#define HASH_CONCORRENTE_H
+
+#include "abbonati.h"
+#include "hash.h"
+
+// Tabella degli abbonati condivisibile tra più thread
+typedef struct c_concorrente *tabella_concorrente;
+
+/* Funzione: nuova_concorrente
+*
+* Crea una tabella degli abbonati utilizzabile da più thread contemporaneamente
+*
+* Descrizione:
+* La tabella è divisa in strisce, ognuna con la propria tabella_hash e il proprio lock
+* lettori/scrittore: le ricerche non si bloccano mai tra loro e un inserimento blocca
+* solo le ricerche che cadono nella sua striscia
+*
+* Parametri:
+* dimensione: numero di abbonati previsti
+* motore: motore delle tabelle interne (HASH_CATENE o HASH_APERTO)
+*
+* Pre-condizione:
+* dimensione>0
+*
+* Post-condizione:
+* Restituisce una tabella vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per le strisce e le loro tabelle
+*/
+tabella_concorrente nuova_concorrente(int dimensione, motore_hash motore);
+
+/* Funzione: inserisci_concorrente
+*
+* Inserisce una copia di nuovo se la sua chiave non è già presente
+*
+* Pre-condizione:
+* t è una tabella valida, nuovo.chiave è una stringa non vuota
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato inserito, 0 se la chiave era già presente
+*
+* Side-effect:
+* Prende in scrittura il lock della striscia della chiave
+*/
+int inserisci_concorrente(abbonato nuovo, tabella_concorrente t);
+
+/* Funzione: cerca_concorrente
+*
+* Copia l'abbonato con la chiave indicata
+*
+* Parametri:
+* chiave: chiave da cercare
+* t: tabella in cui cercare
+* copia: dove scrivere l'abbonato trovato, NULL se basta sapere se è presente
+*
+* Pre-condizione:
+* t è una tabella valida, chiave è una stringa non vuota
+*
+* Post-condizione:
+* Restituisce 1 e, se copia non è NULL, vi scrive nome utente, password, lezioni rimanenti
+* e ultima attività dell'abbonato; restituisce 0 se la chiave non è presente.
+* Nessun puntatore alla tabella esce dal lock: copia->chiave e copia->prossimo valgono NULL
+* e le lezioni vanno modificate solo con le funzioni *_lezioni_concorrente
+*
+* Side-effect:
+* Prende in lettura il lock della striscia della chiave
+*/
+int cerca_concorrente(char *chiave, tabella_concorrente t, abbonato *copia);
+
+/* Funzione: rimuovi_concorrente
+*
+* Rimuove l'abbonato con la chiave indicata
+*
+* Pre-condizione:
+* t è una tabella valida, chiave è una stringa non vuota
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato rimosso, 0 se non era presente
+*
+* Side-effect:
+* Prende in scrittura il lock della striscia della chiave
+*/
+int rimuovi_concorrente(char *chiave, tabella_concorrente t);
+
+/* Funzione: numero_concorrente
+*
+* Restituisce il numero di abbonati presenti nella tabella
+*
+* Descrizione:
+* Le strisce vengono lette una alla volta: con inserimenti in corso il valore
+* è solo una fotografia approssimata
+*/
+int numero_concorrente(tabella_concorrente t);
+
+/* Funzione: leggi_lezioni_concorrente
+*
+* Legge in modo atomico le lezioni rimanenti dell'abbonato con la chiave indicata
+*
+* Post-condizione:
+* Restituisce 1 e scrive le lezioni in lezioni se l'abbonato è presente, altrimenti 0
+*
+* Side-effect:
+* Prende in lettura il lock della striscia della chiave
+*/
+int leggi_lezioni_concorrente(char *chiave, tabella_concorrente t, int *lezioni);
+
+/* Funzione: modifica_lezioni_concorrente
+*
+* Aggiunge in modo atomico variazione alle lezioni rimanenti dell'abbonato con la chiave indicata
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è presente e, se saldo non è NULL, vi scrive il nuovo
+* numero di lezioni rimanenti; restituisce 0 se l'abbonato non è presente
+*
+* Side-effect:
+* Prende in lettura il lock della striscia della chiave
+*/
+int modifica_lezioni_concorrente(char *chiave, tabella_concorrente t, int variazione, int *saldo);
+
+/* Funzione: preleva_lezione_concorrente
+*
+* Toglie una lezione all'abbonato con la chiave indicata solo se ne ha almeno una, in modo atomico
+*
+* Descrizione:
+* Controllo e decremento avvengono in un'unica operazione: due prenotazioni simultanee
+* non possono portare sotto zero il saldo dell'abbonato
+*
+* Post-condizione:
+* Restituisce 1 se la lezione è stata prelevata, 0 se l'abbonato non è presente o non aveva lezioni
+*
+* Side-effect:
+* Prende in lettura il lock della striscia della chiave
+*/
+int preleva_lezione_concorrente(char *chiave, tabella_concorrente t);
+
+/* Funzione: distruggi_concorrente
+*
+* Libera la tabella e tutti gli abbonati che contiene
+*
+* Pre-condizione:
+* t è una tabella valida oppure NULL e nessun altro thread la sta usando
+*/
+void distruggi_concorrente(tabella_concorrente t);
+
+#endif
@@ -0,0 +1,492 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "abbonati.h"
+#include "hash_perfetto.h"
+
+#define MEDIA_BUCKET 5 // Chiavi per bucket in media: bucket piccoli si sistemano con pochi tentativi
+#define SEMI_MASSIMI 8 // Semi provati prima di rinunciare alla costruzione
+#define BIT_D1 24 // Bit bassi dello spostamento che contengono d1: al più 2^24 abbonati
+#define MASSIMO_D0 256 // d0 occupa gli 8 bit alti dello spostamento
+#define TENTATIVI_MASSIMI (1 << 22) // Coppie di spostamenti provate per un bucket con lo stesso seme
+#define MINIMO_TRABOCCO 64 // Aggiunte accettate dal trabocco anche per indici piccoli
+#define QUOTA_TRABOCCO 8 // Il trabocco si riempie dopo n/QUOTA_TRABOCCO aggiunte
+
+// Slot del trabocco: l'hash viene confrontato prima della chiave
+struct slot_perfetto
+{
+	uint64_t hash;
+	abbonato *membro; // NULL se vuoto
+};
+
+// Coordinate di una chiave ricavate dal suo hash e dal seme
+struct coordinate
+{
+	uint32_t bucket;
+	uint32_t f1;
+	uint32_t f2;
+};
+
+// Struttura dell'indice
+struct c_perfetto
+{
+	uint64_t seme;
+	uint32_t numero_slot; // Uguale al numero di abbonati della costruzione (almeno 1)
+	uint32_t numero_bucket;
+	// Spostamenti di ogni bucket, d0 << BIT_D1 | d1: le sue chiavi vanno negli slot (f1 + d0 * f2 + d1) % numero_slot.
+	// Con 4 byte per bucket l'array resta abbastanza piccolo da stare in cache
+	uint32_t *spostamenti;
+	abbonato **slot; // Un puntatore per slot: l'hash memorizzato nel nodo viene confrontato prima della chiave
+
+	// Trabocco: piccola tabella a sondaggio lineare per gli abbonati aggiunti dopo la costruzione
+	struct slot_perfetto *trabocco;
+	uint32_t capacita_trabocco; // Potenza di due, almeno il doppio di limite_trabocco
+	int limite_trabocco;
+	int aggiunti; // Abbonati presenti nel trabocco
+	int occupati_trabocco; // Slot del trabocco usati, compresi quelli rimossi
+};
+
+// Memoria temporanea della costruzione, riusata per ogni seme provato
+struct costruzione
+{
+	struct coordinate *coordinate;
+	uint32_t *chiavi; // Chiavi raggruppate per bucket
+	uint32_t *inizio; // Prima chiave di ogni bucket in chiavi
+	uint32_t *riempiti;
+	uint32_t *per_dimensione;
+	uint32_t *ordine; // Bucket dal più grande al più piccolo
+	uint32_t *basi; // (f1 + d0 * f2) % numero_slot delle chiavi del bucket
+	uint32_t *liberi; // Slot ancora liberi
+	uint32_t *dove_libero; // Posizione di ogni slot libero in liberi
+};
+
+// Il suo indirizzo marca gli slot rimossi del trabocco, che non interrompono il sondaggio
+static abbonato rimosso_trabocco;
+#define RIMOSSO (&rimosso_trabocco)
+
+static int alloca_costruzione(struct costruzione *l, int n, uint32_t numero_bucket, uint32_t numero_slot);
+static void libera_costruzione(struct costruzione *l);
+static int prova_seme(indice_perfetto p, abbonato **membri, int n, struct costruzione *l);
+static struct coordinate coordinate(indice_perfetto p, uint64_t hash);
+static uint32_t posizione(indice_perfetto p, struct coordinate c, uint32_t d0, uint32_t d1);
+static abbonato **slot_di(indice_perfetto p, uint64_t hash);
+static uint64_t mescola(uint64_t x);
+static uint32_t riduci(uint32_t x, uint32_t n);
+static struct slot_perfetto *cerca_trabocco(indice_perfetto p, const char *chiave, uint64_t hash);
+
+/* Funzione: costruisci_perfetto
+*
+* Costruisce un indice a hash perfetto minimo (schema CHD) sugli abbonati indicati
+*
+* Descrizione:
+* Le chiavi vengono divise in circa n/MEDIA_BUCKET bucket. I bucket vengono sistemati dal più
+* grande al più piccolo: per ognuno si cerca una coppia di spostamenti (d0, d1) che mandi tutte
+* le sue chiavi in slot ancora liberi e diversi tra loro. I bucket con una sola chiave, che arrivano
+* per ultimi quando gli slot liberi sono pochi, prendono direttamente il primo slot libero.
+* Se un bucket non si riesce a sistemare si riparte con un altro seme
+*
+* Parametri:
+* membri: puntatori agli abbonati, con l'hash già memorizzato
+* n: numero di abbonati
+*
+* Post-condizione:
+* Restituisce l'indice oppure NULL se l'allocazione fallisce, se gli abbonati sono 2^24 o più
+* o se nessun seme separa le chiavi
+*
+* Side-effect:
+* Alloca memoria dinamica per l'indice e, durante la costruzione, per le coordinate delle chiavi
+*/
+indice_perfetto costruisci_perfetto(abbonato **membri, int n)
+{
+	if (n >= 1 << BIT_D1)
+		return NULL;
+
+	indice_perfetto p = malloc(sizeof(struct c_perfetto));
+	if (p == NULL)
+		return NULL;
+
+	p->numero_slot = n > 0 ? n : 1;
+	p->numero_bucket = n / MEDIA_BUCKET + 1;
+	p->spostamenti = malloc(p->numero_bucket * sizeof(uint32_t));
+	p->slot = malloc(p->numero_slot * sizeof(abbonato *));
+
+	p->limite_trabocco = n / QUOTA_TRABOCCO > MINIMO_TRABOCCO ? n / QUOTA_TRABOCCO : MINIMO_TRABOCCO;
+	p->capacita_trabocco = 1;
+	while (p->capacita_trabocco < (uint32_t)p->limite_trabocco * 2)
+		p->capacita_trabocco *= 2;
+	p->trabocco = calloc(p->capacita_trabocco, sizeof(struct slot_perfetto));
+	p->aggiunti = 0;
+	p->occupati_trabocco = 0;
+
+	struct costruzione l;
+	if (p->spostamenti == NULL || p->slot == NULL || p->trabocco == NULL ||
+		!alloca_costruzione(&l, n, p->numero_bucket, p->numero_slot))
+	{
+		distruggi_perfetto(p);
+		return NULL;
+	}
+
+	int riuscito = 0;
+	for (int i = 0; i < SEMI_MASSIMI && !riuscito; i++)
+	{
+		p->seme = mescola(0x9e3779b97f4a7c15ULL * (i + 1));
+		riuscito = prova_seme(p, membri, n, &l);
+	}
+
+	libera_costruzione(&l);
+	if (!riuscito)
+	{
+		distruggi_perfetto(p);
+		return NULL;
+	}
+	return p;
+}
+
+/* Funzione: cerca_perfetto
+*
+* Cerca nell'indice l'abbonato con la chiave (e l'hash) indicati
+*
+* Descrizione:
+* Lo slot dell'hash perfetto è l'unico posto in cui la chiave può trovarsi se faceva parte
+* della costruzione: basta confrontare l'hash memorizzato nel nodo e poi la chiave. Il trabocco
+* viene consultato solo se contiene qualcosa
+*/
+abbonato *cerca_perfetto(indice_perfetto p, const char *chiave, uint64_t hash)
+{
+	abbonato *membro = *slot_di(p, hash);
+	if (membro != NULL && membro->hash == hash && strcmp(membro->chiave, chiave) == 0)
+		return membro;
+
+	if (p->aggiunti == 0)
+		return NULL;
+
+	struct slot_perfetto *s = cerca_trabocco(p, chiave, hash);
+	return s != NULL ? s->membro : NULL;
+}
+
+/* Funzione: aggiungi_perfetto
+*
+* Aggiunge alla tabella di trabocco un abbonato inserito dopo la costruzione
+*
+* Descrizione:
+* La chiave non è presente, quindi può prendere il primo slot vuoto o rimosso della sua sequenza.
+* Il trabocco non cresce: quando le aggiunte arrivano a limite_trabocco è ora di ricostruire
+* l'indice, il cui costo si ripaga sulle n/QUOTA_TRABOCCO aggiunte che lo hanno reso necessario
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato aggiunto, 0 se il trabocco è pieno
+*/
+int aggiungi_perfetto(indice_perfetto p, abbonato *nuovo)
+{
+	if (p->occupati_trabocco >= p->limite_trabocco)
+		return 0;
+
+	uint32_t maschera = p->capacita_trabocco - 1;
+	uint32_t i = nuovo->hash & maschera;
+	while (p->trabocco[i].membro != NULL && p->trabocco[i].membro != RIMOSSO)
+		i = (i + 1) & maschera;
+
+	if (p->trabocco[i].membro == NULL)
+		p->occupati_trabocco++;
+	p->trabocco[i].hash = nuovo->hash;
+	p->trabocco[i].membro = nuovo;
+	p->aggiunti++;
+	return 1;
+}
+
+/* Funzione: rimuovi_perfetto
+*
+* Toglie dall'indice l'abbonato con la chiave (e l'hash) indicati, se presente
+*/
+void rimuovi_perfetto(indice_perfetto p, const char *chiave, uint64_t hash)
+{
+	abbonato **slot = slot_di(p, hash);
+	if (*slot != NULL && (*slot)->hash == hash && strcmp((*slot)->chiave, chiave) == 0)
+	{
+		*slot = NULL;
+		return;
+	}
+
+	struct slot_perfetto *s = cerca_trabocco(p, chiave, hash);
+	if (s != NULL)
+	{
+		s->membro = RIMOSSO;
+		p->aggiunti--;
+	}
+}
+
+/* Funzione: aggiunti_perfetto
+*
+* Restituisce il numero di abbonati presenti nella tabella di trabocco
+*/
+int aggiunti_perfetto(indice_perfetto p)
+{
+	return p->aggiunti;
+}
+
+/* Funzione: distruggi_perfetto
+*
+* Libera l'indice (gli abbonati non appartengono all'indice e non vengono toccati)
+*/
+void distruggi_perfetto(indice_perfetto p)
+{
+	if (p == NULL)
+		return;
+
+	free(p->spostamenti);
+	free(p->slot);
+	free(p->trabocco);
+	free(p);
+}
+
+/* Funzione: alloca_costruzione
+*
+* Alloca la memoria temporanea per costruire un indice su n chiavi
+*
+* Post-condizione:
+* Restituisce 1 se l'allocazione è riuscita, altrimenti 0 (e non resta nulla da liberare)
+*/
+static int alloca_costruzione(struct costruzione *l, int n, uint32_t numero_bucket, uint32_t numero_slot)
+{
+	size_t chiavi = n + 2; // Anche la dimensione massima di un bucket è al più n
+	l->coordinate = malloc(chiavi * sizeof(struct coordinate));
+	l->chiavi = malloc(chiavi * sizeof(uint32_t));
+	l->per_dimensione = malloc(chiavi * sizeof(uint32_t));
+	l->basi = malloc(chiavi * sizeof(uint32_t));
+	l->inizio = malloc((numero_bucket + 1) * sizeof(uint32_t));
+	l->riempiti = malloc(numero_bucket * sizeof(uint32_t));
+	l->ordine = malloc(numero_bucket * sizeof(uint32_t));
+	l->liberi = malloc(numero_slot * sizeof(uint32_t));
+	l->dove_libero = malloc(numero_slot * sizeof(uint32_t));
+
+	if (l->coordinate == NULL || l->chiavi == NULL || l->per_dimensione == NULL || l->basi == NULL ||
+		l->inizio == NULL || l->riempiti == NULL || l->ordine == NULL || l->liberi == NULL || l->dove_libero == NULL)
+	{
+		libera_costruzione(l);
+		return 0;
+	}
+	return 1;
+}
+
+/* Funzione: libera_costruzione
+*
+* Libera la memoria temporanea della costruzione
+*/
+static void libera_costruzione(struct costruzione *l)
+{
+	free(l->coordinate);
+	free(l->chiavi);
+	free(l->per_dimensione);
+	free(l->basi);
+	free(l->inizio);
+	free(l->riempiti);
+	free(l->ordine);
+	free(l->liberi);
+	free(l->dove_libero);
+}
+
+/* Funzione: prova_seme
+*
+* Prova a sistemare tutte le chiavi con il seme corrente dell'indice
+*
+* Descrizione:
+* Le chiavi vengono raggruppate per bucket con un conteggio (senza confronti), poi i bucket
+* vengono ordinati per dimensione decrescente nello stesso modo e sistemati uno alla volta.
+* Per ogni d0 i valori di d1 non vengono provati tutti: si parte dagli slot ancora liberi,
+* tenuti in un elenco, e si sceglie il d1 che porta la prima chiave del bucket su uno di essi.
+* Così anche gli ultimi bucket, quando gli slot liberi sono pochissimi, si sistemano
+* con un numero di tentativi proporzionale agli slot liberi e non a tutti gli slot
+*
+* Post-condizione:
+* Restituisce 1 se tutte le chiavi hanno uno slot, 0 se un bucket non si riesce a sistemare
+*/
+static int prova_seme(indice_perfetto p, abbonato **membri, int n, struct costruzione *l)
+{
+	uint32_t m = p->numero_slot;
+	uint32_t nb = p->numero_bucket;
+	struct coordinate *c = l->coordinate;
+
+	// Raggruppa le chiavi per bucket
+	memset(l->inizio, 0, (nb + 1) * sizeof(uint32_t));
+	memset(l->riempiti, 0, nb * sizeof(uint32_t));
+	for (int i = 0; i < n; i++)
+	{
+		c[i] = coordinate(p, membri[i]->hash);
+		l->inizio[c[i].bucket + 1]++;
+	}
+	uint32_t massima = 0;
+	for (uint32_t b = 0; b < nb; b++)
+	{
+		if (l->inizio[b + 1] > massima)
+			massima = l->inizio[b + 1];
+		l->inizio[b + 1] += l->inizio[b];
+	}
+	for (int i = 0; i < n; i++)
+		l->chiavi[l->inizio[c[i].bucket] + l->riempiti[c[i].bucket]++] = i;
+
+	// Ordina i bucket per dimensione decrescente
+	memset(l->per_dimensione, 0, (massima + 2) * sizeof(uint32_t));
+	for (uint32_t b = 0; b < nb; b++)
+		l->per_dimensione[massima - (l->inizio[b + 1] - l->inizio[b]) + 1]++;
+	for (uint32_t d = 0; d < massima; d++)
+		l->per_dimensione[d + 1] += l->per_dimensione[d];
+	for (uint32_t b = 0; b < nb; b++)
+		l->ordine[l->per_dimensione[massima - (l->inizio[b + 1] - l->inizio[b])]++] = b;
+
+	// Sistema i bucket
+	memset(p->slot, 0, m * sizeof(abbonato *));
+	for (uint32_t i = 0; i < m; i++)
+	{
+		l->liberi[i] = i;
+		l->dove_libero[i] = i;
+	}
+	uint32_t numero_liberi = m;
+	for (uint32_t o = 0; o < nb; o++)
+	{
+		uint32_t b = l->ordine[o];
+		uint32_t k = l->inizio[b + 1] - l->inizio[b];
+		uint32_t *del_bucket = &l->chiavi[l->inizio[b]];
+		uint32_t *basi = l->basi;
+		if (k == 0)
+		{
+			p->spostamenti[b] = 0;
+			continue;
+		}
+
+		int riuscito = 0;
+		long tentativi = 0;
+		uint32_t d0, d1 = 0;
+		for (d0 = 0; d0 < MASSIMO_D0 && tentativi < TENTATIVI_MASSIMI; d0++)
+		{
+			// Con d0 fissato le chiavi del bucket si spostano insieme: se due basi coincidono
+			// nessun d1 può separarle
+			uint32_t j, q;
+			for (j = 0; j < k; j++)
+			{
+				basi[j] = posizione(p, c[del_bucket[j]], d0, 0);
+				for (q = 0; q < j && basi[q] != basi[j]; q++)
+					;
+				if (q < j)
+					break;
+			}
+			if (j < k)
+				continue;
+
+			for (uint32_t i = 0; i < numero_liberi && !riuscito && tentativi < TENTATIVI_MASSIMI; i++, tentativi++)
+			{
+				d1 = (l->liberi[i] + m - basi[0]) % m;
+				for (j = 1; j < k && p->slot[(basi[j] + (uint64_t)d1) % m] == NULL; j++)
+					;
+				riuscito = j == k;
+			}
+			if (riuscito)
+				break;
+		}
+		if (!riuscito)
+			return 0;
+
+		p->spostamenti[b] = d0 << BIT_D1 | d1;
+		for (uint32_t j = 0; j < k; j++)
+		{
+			uint32_t slot = (basi[j] + (uint64_t)d1) % m;
+			p->slot[slot] = membri[del_bucket[j]];
+
+			// Toglie lo slot dall'elenco dei liberi mettendo al suo posto l'ultimo
+			uint32_t ultimo = l->liberi[--numero_liberi];
+			l->liberi[l->dove_libero[slot]] = ultimo;
+			l->dove_libero[ultimo] = l->dove_libero[slot];
+		}
+	}
+	return 1;
+}
+
+/* Funzione: coordinate
+*
+* Ricava dall'hash della chiave il bucket e i due valori f1, f2 in [0, numero_slot)
+*
+* Descrizione:
+* L'hash viene rimescolato con il seme, così un cambio di seme produce coordinate indipendenti
+* e l'indice non dipende dalla qualità dei bit bassi della funzione hash scelta.
+* Ogni valore è ridotto al suo intervallo con una moltiplicazione invece di un modulo
+*/
+static struct coordinate coordinate(indice_perfetto p, uint64_t hash)
+{
+	uint64_t a = mescola(hash ^ p->seme);
+	uint64_t b = mescola(a + p->seme);
+	struct coordinate c;
+	c.bucket = riduci(a >> 32, p->numero_bucket);
+	c.f1 = riduci((uint32_t)a, p->numero_slot);
+	c.f2 = riduci(b >> 32, p->numero_slot);
+	return c;
+}
+
+/* Funzione: posizione
+*
+* Restituisce lo slot di una chiave con le coordinate c in un bucket con spostamenti d0, d1
+*
+* Descrizione:
+* Quasi tutti i bucket hanno d0 = 0: la somma è allora minore di 2 * numero_slot
+* e basta una sottrazione al posto della divisione
+*/
+static uint32_t posizione(indice_perfetto p, struct coordinate c, uint32_t d0, uint32_t d1)
+{
+	uint64_t x = c.f1 + (uint64_t)d0 * c.f2 + d1;
+	if (x < 2 * (uint64_t)p->numero_slot)
+		return x >= p->numero_slot ? x - p->numero_slot : x;
+	return x % p->numero_slot;
+}
+
+/* Funzione: slot_di
+*
+* Restituisce l'unico slot dell'hash perfetto in cui può trovarsi la chiave con l'hash indicato
+*/
+static abbonato **slot_di(indice_perfetto p, uint64_t hash)
+{
+	struct coordinate c = coordinate(p, hash);
+	uint32_t d = p->spostamenti[c.bucket];
+	return &p->slot[posizione(p, c, d >> BIT_D1, d & ((1U << BIT_D1) - 1))];
+}
+
+/* Funzione: mescola
+*
+* Finalizzatore di MurmurHash3: ogni bit del risultato dipende da tutti i bit di x
+*/
+static uint64_t mescola(uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+/* Funzione: riduci
+*
+* Porta x da [0, 2^32) a [0, n) moltiplicando e tenendo i 32 bit alti
+*/
+static uint32_t riduci(uint32_t x, uint32_t n)
+{
+	return ((uint64_t)x * n) >> 32;
+}
+
+/* Funzione: cerca_trabocco
+*
+* Cerca la chiave nel trabocco seguendo la sequenza lineare che parte dai bit bassi dell'hash
+*
+* Post-condizione:
+* Restituisce lo slot dell'abbonato oppure NULL. Il ciclo termina sempre perché il trabocco
+* ha almeno metà degli slot vuoti
+*/
+static struct slot_perfetto *cerca_trabocco(indice_perfetto p, const char *chiave, uint64_t hash)
+{
+	uint32_t maschera = p->capacita_trabocco - 1;
+	for (uint32_t i = hash & maschera; p->trabocco[i].membro != NULL; i = (i + 1) & maschera)
+	{
+		struct slot_perfetto *s = &p->trabocco[i];
+		if (s->membro != RIMOSSO && s->hash == hash && strcmp(s->membro->chiave, chiave) == 0)
+			return s;
+	}
+	return NULL;
+}
@@ -0,0 +1,83 @@
+#ifndef HASH_PERFETTO_H
+#define HASH_PERFETTO_H
+
+#include <stdint.h>
+#include "abbonati.h"
+
+// Indice a hash perfetto minimo usato da hash.c davanti alle ricerche
+typedef struct c_perfetto *indice_perfetto;
+
+/* Funzione: costruisci_perfetto
+*
+* Costruisce un indice a hash perfetto minimo (schema CHD) sugli abbonati indicati
+*
+* Descrizione:
+* Ogni chiave finisce in uno slot diverso di un array grande quanto il numero di abbonati:
+* una ricerca legge lo spostamento del suo bucket, calcola lo slot ed esegue un solo confronto.
+* Gli abbonati aggiunti dopo la costruzione vanno in una piccola tabella di trabocco
+*
+* Parametri:
+* membri: puntatori agli abbonati, con l'hash già memorizzato in membri[i]->hash
+* n: numero di abbonati
+*
+* Pre-condizione:
+* n>=0, le chiavi sono tutte diverse e gli abbonati non vengono spostati in memoria
+* finché fanno parte dell'indice
+*
+* Post-condizione:
+* Restituisce l'indice oppure NULL se l'allocazione fallisce o se nessun seme separa le chiavi
+* (succede solo con hash a 64 bit identici per chiavi diverse)
+*
+* Side-effect:
+* Alloca memoria dinamica: circa 13 byte per abbonato più la memoria temporanea della costruzione
+*/
+indice_perfetto costruisci_perfetto(abbonato **membri, int n);
+
+/* Funzione: cerca_perfetto
+*
+* Cerca nell'indice l'abbonato con la chiave (e l'hash) indicati
+*
+* Post-condizione:
+* Restituisce il puntatore all'abbonato oppure NULL. Se non ci sono aggiunte dopo l'ultima
+* costruzione, la risposta richiede un solo slot e al più un confronto
+*/
+abbonato *cerca_perfetto(indice_perfetto p, const char *chiave, uint64_t hash);
+
+/* Funzione: aggiungi_perfetto
+*
+* Aggiunge alla tabella di trabocco un abbonato inserito dopo la costruzione
+*
+* Pre-condizione:
+* La chiave di nuovo non è presente nell'indice
+*
+* Post-condizione:
+* Restituisce 1 se l'abbonato è stato aggiunto, 0 se il trabocco è pieno:
+* in quel caso l'indice va ricostruito comprendendo anche nuovo
+*/
+int aggiungi_perfetto(indice_perfetto p, abbonato *nuovo);
+
+/* Funzione: rimuovi_perfetto
+*
+* Toglie dall'indice l'abbonato con la chiave (e l'hash) indicati, se presente
+*
+* Descrizione:
+* Lo slot dell'hash perfetto resta vuoto fino alla prossima costruzione
+*/
+void rimuovi_perfetto(indice_perfetto p, const char *chiave, uint64_t hash);
+
+/* Funzione: aggiunti_perfetto
+*
+* Restituisce il numero di abbonati presenti nella tabella di trabocco
+*/
+int aggiunti_perfetto(indice_perfetto p);
+
+/* Funzione: distruggi_perfetto
+*
+* Libera l'indice (gli abbonati non appartengono all'indice e non vengono toccati)
+*
+* Pre-condizione:
+* p è un indice valido oppure NULL
+*/
+void distruggi_perfetto(indice_perfetto p);
+
+#endif
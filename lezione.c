@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "lezione.h"
+
+// Fasce orarie delle lezioni: l'indice è la fascia salvata in ogni lezione
+static const struct
+{
+	const char *orario;
+	int ora_inizio;
+} fasce[] = {
+	{ "10-12", 10 },
+	{ "16-18", 16 },
+};
+
+#define NUMERO_FASCE ((int)(sizeof(fasce) / sizeof(fasce[0])))
+
+static const char *nomi_giorni[] = { "Domenica", "Lunedi", "Martedi", "Mercoledi", "Giovedi", "Venerdi", "Sabato" };
+
+static int64_t giorni_di(int64_t inizio);
+
+/* Funzione: giorno_civile
+*
+* Restituisce il numero di giorni tra l'1/1/1970 e la data indicata
+*
+* Descrizione:
+* Sposta l'inizio dell'anno a marzo, così il giorno bisestile è l'ultimo dell'anno,
+* e conta i giorni in cicli di 400 anni (146097 giorni), in cui il calendario si ripete
+*/
+int64_t giorno_civile(int anno, int mese, int giorno)
+{
+	int64_t a = anno - (mese <= 2);
+	int64_t ciclo = (a >= 0 ? a : a - 399) / 400;
+	int64_t anno_ciclo = a - ciclo * 400;
+	int64_t giorno_anno = (153 * (mese > 2 ? mese - 3 : mese + 9) + 2) / 5 + giorno - 1;
+	int64_t giorno_ciclo = anno_ciclo * 365 + anno_ciclo / 4 - anno_ciclo / 100 + giorno_anno;
+	return ciclo * 146097 + giorno_ciclo - 719468;
+}
+
+/* Funzione: data_civile
+*
+* Inverso di giorno_civile, con gli stessi cicli di 400 anni che iniziano a marzo
+*/
+void data_civile(int64_t giorni, int *anno, int *mese, int *giorno)
+{
+	giorni += 719468;
+	int64_t ciclo = (giorni >= 0 ? giorni : giorni - 146096) / 146097;
+	int64_t giorno_ciclo = giorni - ciclo * 146097;
+	int64_t anno_ciclo = (giorno_ciclo - giorno_ciclo / 1460 + giorno_ciclo / 36524 - giorno_ciclo / 146096) / 365;
+	int64_t giorno_anno = giorno_ciclo - (365 * anno_ciclo + anno_ciclo / 4 - anno_ciclo / 100);
+	int64_t mese_marzo = (5 * giorno_anno + 2) / 153;
+
+	*giorno = (int)(giorno_anno - (153 * mese_marzo + 2) / 5 + 1);
+	*mese = (int)(mese_marzo < 10 ? mese_marzo + 3 : mese_marzo - 9);
+	*anno = (int)(anno_ciclo + ciclo * 400 + (*mese <= 2));
+}
+
+/* Funzione: giorno_della_settimana
+*
+* Restituisce il giorno della settimana (0 = Domenica): l'1/1/1970 era un giovedì
+*/
+int giorno_della_settimana(int64_t giorni)
+{
+	return (int)(((giorni % 7) + 11) % 7);
+}
+
+/* Funzione: inizio_lezione
+*
+* Restituisce l'istante di inizio di una lezione del giorno indicato nella fascia indicata
+*/
+int64_t inizio_lezione(int64_t giorni, int fascia)
+{
+	if (fascia < 0 || fascia >= NUMERO_FASCE)
+		return NESSUN_INIZIO;
+
+	return giorni * SECONDI_GIORNO + fasce[fascia].ora_inizio * 3600;
+}
+
+/* Funzione: leggi_giorno
+*
+* Converte una data nel formato "gg/mm/aaaa" nel numero di giorni contato da giorno_civile
+*
+* Descrizione:
+* La data viene riconvertita con data_civile: se non torna uguale non esiste (es. 31/02)
+*/
+int leggi_giorno(const char *data, int64_t *giorni)
+{
+	int giorno, mese, anno;
+	if (sscanf(data, "%d/%d/%d", &giorno, &mese, &anno) != 3 || mese < 1 || mese > 12 || giorno < 1)
+		return 0;
+
+	int64_t letti = giorno_civile(anno, mese, giorno);
+	int controllo_anno, controllo_mese, controllo_giorno;
+	data_civile(letti, &controllo_anno, &controllo_mese, &controllo_giorno);
+	if (controllo_anno != anno || controllo_mese != mese || controllo_giorno != giorno)
+		return 0;
+
+	*giorni = letti;
+	return 1;
+}
+
+/* Funzione: leggi_inizio
+*
+* Converte data e orario scritti come nel file delle lezioni nell'istante di inizio e nella fascia
+*/
+int64_t leggi_inizio(const char *data, const char *orario, int *fascia)
+{
+	int64_t giorni;
+	if (!leggi_giorno(data, &giorni))
+		return NESSUN_INIZIO;
+
+	for (int i = 0; i < NUMERO_FASCE; i++)
+	{
+		if (strcmp(orario, fasce[i].orario) == 0)
+		{
+			*fascia = i;
+			return inizio_lezione(giorni, i);
+		}
+	}
+	return NESSUN_INIZIO;
+}
+
+/* Funzione: scrivi_data
+*
+* Scrive la data di un istante nel formato "gg/mm/aaaa"
+*/
+void scrivi_data(int64_t inizio, char *data)
+{
+	int giorno, mese, anno;
+	data_civile(giorni_di(inizio), &anno, &mese, &giorno);
+	snprintf(data, 11, "%02u/%02u/%04u", (unsigned)giorno % 100u, (unsigned)mese % 100u, (unsigned)anno % 10000u);
+}
+
+/* Funzione: nome_giorno
+*
+* Restituisce il nome del giorno della settimana di un istante
+*/
+const char *nome_giorno(int64_t inizio)
+{
+	return nomi_giorni[giorno_della_settimana(giorni_di(inizio))];
+}
+
+/* Funzione: orario_fascia
+*
+* Restituisce la fascia oraria come scritta nel file delle lezioni, oppure "" se non esiste
+*/
+const char *orario_fascia(int fascia)
+{
+	if (fascia < 0 || fascia >= NUMERO_FASCE)
+		return "";
+
+	return fasce[fascia].orario;
+}
+
+/* Funzione: istante_attuale
+*
+* Restituisce l'istante attuale nella stessa scala di inizio_lezione
+*/
+int64_t istante_attuale(void)
+{
+	time_t t = time(NULL);
+	struct tm adesso = *localtime(&t);
+
+	return giorno_civile(adesso.tm_year + 1900, adesso.tm_mon + 1, adesso.tm_mday) * SECONDI_GIORNO
+		+ adesso.tm_hour * 3600 + adesso.tm_min * 60 + adesso.tm_sec;
+}
+
+/* Funzione: giorni_di
+*
+* Restituisce il giorno, contato da giorno_civile, a cui appartiene un istante
+*/
+static int64_t giorni_di(int64_t inizio)
+{
+	return inizio >= 0 ? inizio / SECONDI_GIORNO : -((-inizio + SECONDI_GIORNO - 1) / SECONDI_GIORNO);
+}
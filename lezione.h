@@ -1,15 +1,126 @@
 #ifndef LEZIONE_H
 #define LEZIONE_H
 
+#include <stdint.h>
 #include "pila.h"
+#include "attesa.h"
+
+#define CAPIENZA_LEZIONE 20 // Posti di una lezione generata o salvata senza capienza
+#define CAPIENZA_ATTESA 10 // Posti nella lista d'attesa di ogni lezione
+#define SECONDI_GIORNO 86400
+#define NESSUN_INIZIO 0 // Inizio di una lezione non valida: nessuna fascia inizia a mezzanotte
+#define NESSUNA_FASCIA -1 // Orario non riconosciuto
 
 // Struttura della lezione
 typedef struct lezione
 {
-	pila iscritti; // Pila contenente i nomi dei partecipanti iscritti
-	char giorno[20]; // Giorno della settimana
-	char orario[20]; // Fascia oraria
-	char data[11]; // Data nel formato "gg/mm/aaaa"
+	pila iscritti; // Pila contenente i nomi dei partecipanti iscritti, con la capienza della lezione
+	int64_t inizio; // Secondi dall'1/1/1970 all'inizio della lezione, in ora locale (vedi inizio_lezione)
+	int fascia; // Fascia oraria, indice della tabella delle fasce (vedi orario_fascia)
+	lista_attesa attesa; // Partecipanti in attesa che si liberi un posto, in ordine di arrivo
 } lezione;
 
+/* Funzione: giorno_civile
+*
+* Restituisce il numero di giorni tra l'1/1/1970 e la data indicata
+*
+* Descrizione:
+* Conta i giorni del calendario gregoriano con sole operazioni intere,
+* senza mktime e senza consultare il fuso orario
+*
+* Parametri:
+* anno, mese, giorno: la data, con mese da 1 a 12
+*
+* Post-condizione:
+* Restituisce il numero di giorni, negativo per le date precedenti al 1970.
+* Una data inesistente (es. 31/02) viene contata come se proseguisse nel mese successivo
+*/
+int64_t giorno_civile(int anno, int mese, int giorno);
+
+/* Funzione: data_civile
+*
+* Inverso di giorno_civile: ricava anno, mese e giorno dal numero di giorni dall'1/1/1970
+*/
+void data_civile(int64_t giorni, int *anno, int *mese, int *giorno);
+
+/* Funzione: giorno_della_settimana
+*
+* Restituisce il giorno della settimana di un giorno contato da giorno_civile (0 = Domenica, 6 = Sabato)
+*/
+int giorno_della_settimana(int64_t giorni);
+
+/* Funzione: inizio_lezione
+*
+* Restituisce l'istante di inizio di una lezione del giorno indicato nella fascia indicata
+*
+* Descrizione:
+* L'istante conta i secondi del calendario locale dall'1/1/1970 come se ogni giorno
+* durasse SECONDI_GIORNO: due lezioni si confrontano come interi e un istante
+* vale sempre la stessa data, qualunque sia il fuso orario o l'ora legale
+*
+* Parametri:
+* giorni: il giorno, contato da giorno_civile
+* fascia: la fascia oraria
+*
+* Post-condizione:
+* Restituisce l'istante di inizio oppure NESSUN_INIZIO se la fascia non esiste
+*/
+int64_t inizio_lezione(int64_t giorni, int fascia);
+
+/* Funzione: leggi_giorno
+*
+* Converte una data nel formato "gg/mm/aaaa" nel numero di giorni contato da giorno_civile
+*
+* Post-condizione:
+* Restituisce 1 e scrive il giorno in 'giorni', oppure 0 se la data non esiste
+*/
+int leggi_giorno(const char *data, int64_t *giorni);
+
+/* Funzione: leggi_inizio
+*
+* Converte data e orario scritti come nel file delle lezioni nell'istante di inizio e nella fascia
+*
+* Parametri:
+* data: data nel formato "gg/mm/aaaa"
+* orario: fascia oraria nel formato "hh-hh", tra quelle conosciute
+* fascia: dove scrivere la fascia oraria
+*
+* Post-condizione:
+* Restituisce l'istante di inizio oppure NESSUN_INIZIO se la data non esiste
+* o l'orario non è una fascia conosciuta; in quel caso 'fascia' non viene modificata
+*/
+int64_t leggi_inizio(const char *data, const char *orario, int *fascia);
+
+/* Funzione: scrivi_data
+*
+* Scrive la data di un istante nel formato "gg/mm/aaaa"
+*
+* Parametri:
+* inizio: l'istante, come restituito da inizio_lezione
+* data: stringa di almeno 11 caratteri
+*/
+void scrivi_data(int64_t inizio, char *data);
+
+/* Funzione: nome_giorno
+*
+* Restituisce il nome del giorno della settimana di un istante (es. "Lunedi")
+*/
+const char *nome_giorno(int64_t inizio);
+
+/* Funzione: orario_fascia
+*
+* Restituisce la fascia oraria come scritta nel file delle lezioni (es. "10-12"), oppure "" se non esiste
+*/
+const char *orario_fascia(int fascia);
+
+/* Funzione: istante_attuale
+*
+* Restituisce l'istante attuale nella stessa scala di inizio_lezione
+*
+* Descrizione:
+* Chiama localtime una sola volta: chi deve confrontare molte lezioni con l'ora attuale
+* la legge una volta e confronta interi
+*/
+int64_t istante_attuale(void);
+
 #endif
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include "abbonati_bin.h"
 #include "coda.h"
 #include "hash.h"
 #include "lezione.h"
@@ -21,10 +23,20 @@
 *
 * Side-effect:
 * - Output a schermo
-* - Possibili modifiche al file "abbonati.txt" e "lezioni.txt"
+* - Possibili modifiche ai file "abbonati.txt", "abbonati.journal" e "lezioni.txt"
 */
 void abbonamenti(coda calendario);
 
+/* Funzione: amministrazione
+*
+* Gestisce le operazioni riservate al personale della palestra
+*
+* Side-effect:
+* - Output a schermo
+* - Possibili modifiche ai file "abbonati.txt", "abbonati.journal" e "abbonati.bin"
+*/
+void amministrazione(void);
+
 /* Funzione: contattaci
 *
 * Stampa a schermo le informazioni di contatto e attende che l'utente prema INVIO per continuare
@@ -71,7 +83,8 @@ int main()
     		printf("3 - Disdici\n");
     		printf("4 - Report mensili\n");
     		printf("5 - Contattaci\n");
-    		printf("6 - Esci\n\n");
+    		printf("6 - Amministrazione\n");
+    		printf("7 - Esci\n\n");
 		printf("La tua scelta: ");
 		fgets(scelta, sizeof(scelta), stdin);
 		scelta[strcspn(scelta, "\n")] = 0;
@@ -105,8 +118,13 @@ int main()
            			contattaci();
           			break;
         		case 6:
+				// Operazioni riservate al personale
+            			amministrazione();
+            			break;
+        		case 7:
 				// Uscita dal programma
             			printf("Arrivederci!\n");
+            			chiudi_registro_abbonati();
             			return 0;
         		default:
 				// Gestione input non valido
@@ -129,7 +147,8 @@ int main()
 * registrazione di un nuovo abbonamento, oppure ritorno al menu principale.
 *
 * Se l'utente è già registrato, può effettuare il login inserendo le proprie credenziali,
-* controllare le lezioni rimanenti, prenotare una lezione o ricaricare l’abbonamento con nuovi pacchetti.
+* controllare le lezioni rimanenti, prenotare una lezione, ricaricare l’abbonamento con nuovi pacchetti
+* o cambiare la password.
 *
 * Se l'utente non è registrato, può creare un nuovo account scegliendo nome utente e password.
 *
@@ -141,15 +160,16 @@ int main()
 *
 * Side-effect:
 * - Output a schermo
-* - Possibili modifiche al file "abbonati.txt" e "lezioni.txt"
+* - Possibili modifiche ai file "abbonati.txt", "abbonati.journal" e "lezioni.txt"
 */
 void abbonamenti(coda calendario)
 {
     char scelta[10];
-    tabella_hash tabella_abbonati = carica_abbonati("abbonati.txt"); // Carica la tabella hash degli abbonati dal file
 
     while (1)
     {
+	// Tabella condivisa, riletta solo se il file è cambiato: una ricarica libera la precedente
+	tabella_hash tabella_abbonati = registro_abbonati("abbonati.txt");
 	pulisci_schermo();
 	printf("--- Area Abbonati ---");
         printf("\nScegli il piano di allenamento adatto a te!\n\n");
@@ -191,14 +211,28 @@ void abbonamenti(coda calendario)
             		}
 
 			// Accesso riuscito
+            		accesso_abbonato(utente);
             		printf("\nBenvenuto %s, hai %d lezioni rimanenti.\n", utente->nomeutente, utente->lezioni_rimanenti);
             		int dentro_area = 1;
             		while (dentro_area)
 			{
+				// Se il registro è stato ricaricato, utente punta a memoria già liberata
+				tabella_abbonati = registro_abbonati("abbonati.txt");
+				utente = cerca_hash(nomeutente, tabella_abbonati);
+				if (!utente)
+				{
+					printf("\nL'abbonamento non esiste piu'.\nPremi INVIO per continuare...");
+					getchar();
+					break;
+				}
+
                 		char scelta_operazione[10];
                 		printf("\n1 - Prenota una lezione\n");
                 		printf("2 - Ricarica abbonamento\n");
-                		printf("3 - Torna al menu abbonamenti\n\n");
+                		printf("3 - Statistiche della tabella abbonati\n");
+                		printf("4 - Le mie prenotazioni\n");
+                		printf("5 - Cambia password\n");
+                		printf("6 - Torna al menu abbonamenti\n\n");
                 		printf("La tua scelta: ");
                 		fgets(scelta_operazione, sizeof(scelta_operazione), stdin);
                 		scelta[strcspn(scelta, "\n")] = 0;
@@ -208,7 +242,6 @@ void abbonamenti(coda calendario)
 						// Prenotazione lezione per abbonato
                     				pulisci_lezioni_passate(calendario, "storico.txt");
                     				prenota_lezione_abbonato(calendario, utente);
-                    				salva_abbonati(tabella_abbonati, "abbonati.txt");
                     				salva_lezioni(calendario, "lezioni.txt");
                     				break;
                 			case 2:
@@ -229,9 +262,8 @@ void abbonamenti(coda calendario)
                         				if (atoi(scelta_abbonamento) >= 1 && atoi(scelta_abbonamento) <= 3) 
                         				{
                             					int lezioni = atoi(scelta_abbonamento) * 12;
-                            					utente->lezioni_rimanenti += lezioni;
+                            					modifica_lezioni_abbonato(utente, lezioni);
                             					printf("Abbonamento aggiornato! Ora hai %d lezioni rimanenti.\n", utente->lezioni_rimanenti);
-                            					salva_abbonati(tabella_abbonati, "abbonati.txt");
                             					break;
                         				} 
                         				else if (atoi(scelta_abbonamento) == 4) 
@@ -247,6 +279,34 @@ void abbonamenti(coda calendario)
                     				break;
                 			}
                 			case 3:
+						// Stato della tabella hash degli abbonati
+                    				stampa_statistiche_hash(tabella_abbonati);
+                    				break;
+                			case 4:
+						// Lezioni a cui l'abbonato è iscritto o in attesa
+                    				pulisci_lezioni_passate(calendario, "storico.txt");
+                    				stampa_prenotazioni(calendario, utente->nomeutente);
+                    				break;
+                			case 5:
+					{
+						// Cambio password, annotato nel giornale degli abbonati
+                    				char nuova_password[MAX_CARATTERI];
+                    				printf("Inserisci la nuova password: ");
+                    				fgets(nuova_password, sizeof(nuova_password), stdin);
+                    				nuova_password[strcspn(nuova_password, "\n")] = 0;
+
+                    				if (strlen(nuova_password) == 0 || strpbrk(nuova_password, " ;") != NULL)
+                    				{
+                    					printf("La password non può essere vuota né contenere spazi o ';'.\n");
+                    				}
+                    				else
+                    				{
+                    					cambia_password_abbonato(utente, nuova_password);
+                    					printf("Password aggiornata.\n");
+                    				}
+                    				break;
+                			}
+                			case 6:
 						// Uscita dall'area riservata
                     				dentro_area = 0;
                     				break;
@@ -315,12 +375,12 @@ void abbonamenti(coda calendario)
             		abbonato nuovo;
             		strncpy(nuovo.nomeutente, nomeutente, MAX_CARATTERI);
             		strncpy(nuovo.password, password, MAX_CARATTERI);
-            		nuovo.chiave = strdup(nomeutente);
+            		nuovo.chiave = nuovo.nomeutente; // La tabella ne fa una copia
             		nuovo.lezioni_rimanenti = 0;
+            		nuovo.ultima_attivita = time(NULL);
 
-			// Inserimento nella tabella hash e salvataggio
-            		tabella_abbonati = inserisci_hash(nuovo, tabella_abbonati);
-            		salva_abbonati(tabella_abbonati, "abbonati.txt");
+			// Inserimento nella tabella hash, annotato nel giornale degli abbonati
+            		aggiungi_abbonato_registro(nuovo);
             		printf("Account creato con successo! Ora accedi dall'area riservata per attivare un abbonamento.\nPremi INVIO per continuare...");
             		getchar();
             		break;
@@ -337,6 +397,135 @@ void abbonamenti(coda calendario)
 	}
 }
 
+/* Funzione: amministrazione
+*
+* Gestisce le operazioni riservate al personale della palestra
+*
+* Descrizione:
+* Permette di rimuovere dal registro gli abbonati senza lezioni rimanenti la cui ultima attività
+* precede una data scelta dal personale. La rimozione non si può annullare, quindi viene eseguita
+* solo dopo una conferma esplicita e mai con una data futura; il numero di abbonati rimossi
+* viene stampato a schermo e le rimozioni vengono annotate nel giornale degli abbonati.
+*
+* Permette inoltre di ricostruire l'archivio binario dal file di testo (per esempio dopo averlo
+* corretto a mano) e, se il file di testo è andato perso o danneggiato, di riscriverlo dall'archivio.
+* Prima di entrambe le conversioni il registro viene chiuso, così l'archivio non resta mappato
+* mentre viene sostituito; il giornale non viene toccato e la prossima lettura del registro
+* lo riapplica al checkpoint convertito.
+*
+* Side-effect:
+* - Output a schermo
+* - Possibili modifiche ai file "abbonati.txt", "abbonati.journal" e "abbonati.bin"
+*/
+void amministrazione(void)
+{
+    char scelta[10];
+
+    while (1)
+    {
+	pulisci_schermo();
+	printf("--- Amministrazione ---\n\n");
+        printf("Seleziona un'opzione:\n");
+        printf("1 - Rimuovi gli abbonati inattivi\n");
+        printf("2 - Ricostruisci abbonati.bin da abbonati.txt\n");
+        printf("3 - Riscrivi abbonati.txt da abbonati.bin\n");
+        printf("4 - Torna al menu principale\n\n");
+        printf("La tua scelta: ");
+        fgets(scelta, sizeof(scelta), stdin);
+        scelta[strcspn(scelta, "\n")] = 0;
+
+        switch (atoi(scelta))
+	{
+        	case 1:
+		{
+			// Purga degli abbonati senza lezioni e inattivi da prima della data indicata
+			char data[20];
+			char conferma[10];
+			int64_t giorni;
+
+			printf("Verranno rimossi gli abbonati senza lezioni rimanenti e senza attivita' dalla data indicata.\n");
+			printf("Data limite (gg/mm/aaaa): ");
+			fgets(data, sizeof(data), stdin);
+			data[strcspn(data, "\n")] = 0;
+			if (!leggi_giorno(data, &giorni))
+			{
+				printf("Data non valida.\nPremi INVIO per continuare...");
+				getchar();
+				break;
+			}
+			if (giorni > istante_attuale() / SECONDI_GIORNO)
+			{
+				printf("La data limite non puo' essere nel futuro.\nPremi INVIO per continuare...");
+				getchar();
+				break;
+			}
+
+			printf("La rimozione non si puo' annullare. Confermi? (s/n): ");
+			fgets(conferma, sizeof(conferma), stdin);
+			if (conferma[0] != 's' && conferma[0] != 'S')
+			{
+				printf("Nessun abbonato rimosso.\nPremi INVIO per continuare...");
+				getchar();
+				break;
+			}
+
+			int rimossi = purga_abbonati(registro_abbonati("abbonati.txt"), (time_t)(giorni * SECONDI_GIORNO));
+			if (rimossi < 0)
+				printf("Memoria insufficiente: nessun abbonato rimosso.\n");
+			else
+				printf("Abbonati rimossi: %d\n", rimossi);
+			printf("Premi INVIO per continuare...");
+			getchar();
+			break;
+		}
+        	case 2:
+		{
+			// Archivio binario riscritto dal checkpoint di testo
+			chiudi_registro_abbonati();
+			int scritti = converti_testo_in_bin("abbonati.txt", "abbonati.bin");
+			if (scritti < 0)
+				printf("Conversione non riuscita: abbonati.txt manca o abbonati.bin non puo' essere scritto.\n");
+			else
+				printf("Abbonati scritti in abbonati.bin: %d\n", scritti);
+			printf("Premi INVIO per continuare...");
+			getchar();
+			break;
+		}
+        	case 3:
+		{
+			// Checkpoint di testo riscritto dall'archivio binario
+			char conferma[10];
+			printf("abbonati.txt verra' sostituito dal contenuto di abbonati.bin. Confermi? (s/n): ");
+			fgets(conferma, sizeof(conferma), stdin);
+			if (conferma[0] != 's' && conferma[0] != 'S')
+			{
+				printf("abbonati.txt non e' stato modificato.\nPremi INVIO per continuare...");
+				getchar();
+				break;
+			}
+
+			chiudi_registro_abbonati();
+			int scritti = converti_bin_in_testo("abbonati.bin", "abbonati.txt");
+			if (scritti < 0)
+				printf("Conversione non riuscita: abbonati.bin manca o non e' valido.\n");
+			else
+				printf("Abbonati scritti in abbonati.txt: %d\n", scritti);
+			printf("Premi INVIO per continuare...");
+			getchar();
+			break;
+		}
+        	case 4:
+            		// Ritorna al menu principale
+            		return;
+        	default:
+            		printf("Scelta non valida.\n");
+            		printf("Premi INVIO per riprovare...");
+            		getchar();
+            		break;
+        }
+    }
+}
+
 /* Funzione: contattaci
 *
 * Stampa a schermo le informazioni di contatto e attende che l'utente prema INVIO per continuare
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "benchmark.h"
+
+int main()
+{
+    char scelta[10];
+    int benchmark_scelta = 0;
+    do
+    {
+        printf("\n--- Segmentation Fit: Benchmark ---\n");
+        printf("Misura delle prestazioni delle strutture dati principali\n\n");
+        printf("1 - Tabella hash: catene e indirizzamento aperto\n");
+        printf("2 - Funzioni hash: velocità e distribuzione\n");
+        printf("3 - Avvio: file di testo e archivio binario degli abbonati\n");
+        printf("4 - Tabella concorrente: da 1 a N thread\n");
+        printf("5 - Indice a hash perfetto: un milione di abbonati\n");
+        printf("6 - Salvataggio del calendario: lettura degli iscritti sul posto\n");
+        printf("7 - Caricamento del calendario: iscritti inseriti a blocchi\n");
+        printf("8 - Prenotazioni di un partecipante: scansione SSE2/AVX2 delle pile e insieme dei presenti\n");
+        printf("9 - Pulizia delle lezioni passate: solo dalla testa del calendario\n");
+        printf("10 - Generazione delle lezioni: solo i giorni non ancora generati\n");
+        printf("11 - Esci\n\n");
+        printf("La tua scelta: ");
+        if (fgets(scelta, sizeof(scelta), stdin) == NULL)
+            break;
+        scelta[strcspn(scelta, "\n")] = 0;
+        benchmark_scelta = atoi(scelta);
+
+        switch (benchmark_scelta)
+        {
+            case 1:
+                benchmark_hash_login();
+                break;
+            case 2:
+                benchmark_funzioni_hash();
+                break;
+            case 3:
+                benchmark_avvio_abbonati();
+                break;
+            case 4:
+                benchmark_hash_concorrente();
+                break;
+            case 5:
+                benchmark_hash_perfetto();
+                break;
+            case 6:
+                benchmark_salva_lezioni();
+                break;
+            case 7:
+                benchmark_carica_lezioni();
+                break;
+            case 8:
+                benchmark_trova_prenotazioni();
+                break;
+            case 9:
+                benchmark_pulisci_lezioni();
+                break;
+            case 10:
+                benchmark_genera_lezioni();
+                break;
+            case 11:
+                printf("Uscita dai benchmark.\n");
+                break;
+            default:
+                printf("Scelta non valida.\n");
+                break;
+        }
+    } while (benchmark_scelta != 11);
+
+    return 0;
+}
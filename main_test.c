@@ -43,7 +43,13 @@ int main()
         printf("1 - Caso Test 1\n");
         printf("2 - Caso Test 2\n");
         printf("3 - Caso Test 3\n");
-        printf("4 - Esci\n\n");
+        printf("4 - Caso Test 4: purga degli abbonati inattivi\n");
+        printf("5 - Caso Test 5: giornale degli abbonati\n");
+        printf("6 - Caso Test 6: lista d'attesa\n");
+        printf("7 - Caso Test 7: ordine degli iscritti dopo le disdette\n");
+        printf("8 - Caso Test 8: ordine del calendario e ricerca delle lezioni\n");
+        printf("9 - Caso Test 9: giorno generato nel file delle lezioni\n");
+        printf("10 - Esci\n\n");
         printf("La tua scelta: ");
         fgets(scelta, sizeof(scelta), stdin);
         scelta[strcspn(scelta, "\n")] = 0;
@@ -61,6 +67,24 @@ int main()
                 caso_test_3(calendario);
                 break;
             case 4:
+                caso_test_4();
+                break;
+            case 5:
+                caso_test_5();
+                break;
+            case 6:
+                caso_test_6();
+                break;
+            case 7:
+                caso_test_7();
+                break;
+            case 8:
+                caso_test_8();
+                break;
+            case 9:
+                caso_test_9();
+                break;
+            case 10:
                 printf("Uscita dai casi di test.\n");
                 break;
             default:
@@ -69,7 +93,7 @@ int main()
                 getchar();
                 break;
         }
-    } while (test_scelta != 4);
+    } while (test_scelta != 10);
 
     return 0;
 }
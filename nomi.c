@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "arena.h"
+#include "partecipante.h"
+#include "nomi.h"
+
+#define SLOT_INIZIALI 64 // Slot della tabella alla prima registrazione, potenza di due
+#define BLOCCO_NOMI 4096 // Byte dei blocchi dell'arena che contiene i nomi
+
+// Registro dei nomi condiviso da tutte le pile degli iscritti
+static struct
+{
+	arena testi; // Copie dei nomi, liberate solo all'uscita del programma
+	const char **nomi; // nomi[p] è il nome con identificativo p; nomi[0] è NESSUN_PARTECIPANTE
+	uint32_t numero; // Identificativi assegnati, NESSUN_PARTECIPANTE compreso
+	uint32_t allocati; // Posizioni allocate in nomi
+	partecipante *slot; // Tabella a indirizzamento aperto: identificativo oppure NESSUN_PARTECIPANTE
+	uint32_t maschera; // Numero di slot meno uno
+} registro_nomi;
+
+static uint32_t hash_nome(const char *nome);
+static partecipante *slot_nome(const char *nome, uint32_t h);
+static int ingrandisci_slot(void);
+
+/* Funzione: interna_nome
+*
+* Restituisce l'identificativo del nome indicato, registrandolo se è la prima volta che compare
+*
+* Descrizione:
+* I nomi stanno in una tabella a indirizzamento aperto con scansione lineare, riempita
+* al più per metà; gli identificativi sono assegnati in ordine crescente a partire da 1 e
+* sono indici diretti dell'array dei nomi, quindi nome_partecipante non cerca nulla
+*
+* Side-effect:
+* Alla prima chiamata alloca l'arena e la tabella; può raddoppiare la tabella e l'array dei nomi
+*/
+partecipante interna_nome(const char *nome)
+{
+	if (registro_nomi.slot == NULL || 2 * (registro_nomi.numero + 1) > registro_nomi.maschera + 1)
+	{
+		if (!ingrandisci_slot())
+			return NESSUN_PARTECIPANTE;
+	}
+
+	uint32_t h = hash_nome(nome);
+	partecipante *s = slot_nome(nome, h);
+	if (*s != NESSUN_PARTECIPANTE)
+		return *s;
+
+	// Nome nuovo: lo copia nell'arena e gli assegna il prossimo identificativo
+	if (registro_nomi.numero == registro_nomi.allocati)
+	{
+		uint32_t allocati = registro_nomi.allocati * 2;
+		const char **nomi = realloc(registro_nomi.nomi, allocati * sizeof(const char *));
+		if (nomi == NULL)
+			return NESSUN_PARTECIPANTE;
+		registro_nomi.nomi = nomi;
+		registro_nomi.allocati = allocati;
+	}
+
+	char *copia = copia_stringa_arena(registro_nomi.testi, nome);
+	if (copia == NULL)
+		return NESSUN_PARTECIPANTE;
+
+	partecipante p = registro_nomi.numero++;
+	registro_nomi.nomi[p] = copia;
+	*s = p;
+	return p;
+}
+
+/* Funzione: cerca_nome
+*
+* Restituisce l'identificativo del nome indicato senza registrarlo
+*/
+partecipante cerca_nome(const char *nome)
+{
+	if (registro_nomi.slot == NULL)
+		return NESSUN_PARTECIPANTE;
+
+	return *slot_nome(nome, hash_nome(nome));
+}
+
+/* Funzione: nome_partecipante
+*
+* Restituisce il nome corrispondente a un identificativo
+*/
+const char *nome_partecipante(partecipante p)
+{
+	if (p == NESSUN_PARTECIPANTE || p >= registro_nomi.numero)
+		return "";
+
+	return registro_nomi.nomi[p];
+}
+
+/* Funzione: numero_nomi
+*
+* Restituisce il numero di nomi diversi registrati
+*/
+int numero_nomi(void)
+{
+	return registro_nomi.numero > 0 ? (int)registro_nomi.numero - 1 : 0;
+}
+
+/* Funzione: hash_nome
+*
+* Calcola l'hash FNV-1a a 32 bit del nome
+*
+* Descrizione:
+* Il registro non usa calcola_hash: la funzione delle tabelle può essere cambiata in ogni momento
+* con imposta_funzione_hash e le posizioni dei nomi già registrati non sarebbero più valide
+*/
+static uint32_t hash_nome(const char *nome)
+{
+	uint32_t h = 2166136261u;
+	for (const unsigned char *c = (const unsigned char *)nome; *c != '\0'; c++)
+	{
+		h ^= *c;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/* Funzione: slot_nome
+*
+* Restituisce lo slot che contiene il nome oppure il primo slot vuoto della sua sequenza di scansione
+*/
+static partecipante *slot_nome(const char *nome, uint32_t h)
+{
+	uint32_t i = h & registro_nomi.maschera;
+	while (registro_nomi.slot[i] != NESSUN_PARTECIPANTE &&
+		strcmp(registro_nomi.nomi[registro_nomi.slot[i]], nome) != 0)
+		i = (i + 1) & registro_nomi.maschera;
+
+	return &registro_nomi.slot[i];
+}
+
+/* Funzione: ingrandisci_slot
+*
+* Crea la tabella dei nomi oppure ne raddoppia gli slot, reinserendo gli identificativi già assegnati
+*
+* Post-condizione:
+* Restituisce 1 se la tabella è pronta, 0 se l'allocazione fallisce (il registro resta invariato)
+*/
+static int ingrandisci_slot(void)
+{
+	if (registro_nomi.slot == NULL)
+	{
+		registro_nomi.testi = nuova_arena(BLOCCO_NOMI);
+		registro_nomi.nomi = malloc(SLOT_INIZIALI / 2 * sizeof(const char *));
+		registro_nomi.slot = calloc(SLOT_INIZIALI, sizeof(partecipante));
+		if (registro_nomi.testi == NULL || registro_nomi.nomi == NULL || registro_nomi.slot == NULL)
+		{
+			distruggi_arena(registro_nomi.testi);
+			free(registro_nomi.nomi);
+			free(registro_nomi.slot);
+			registro_nomi.testi = NULL;
+			registro_nomi.nomi = NULL;
+			registro_nomi.slot = NULL;
+			return 0;
+		}
+		registro_nomi.nomi[NESSUN_PARTECIPANTE] = "";
+		registro_nomi.numero = 1;
+		registro_nomi.allocati = SLOT_INIZIALI / 2;
+		registro_nomi.maschera = SLOT_INIZIALI - 1;
+		return 1;
+	}
+
+	uint32_t maschera = registro_nomi.maschera * 2 + 1;
+	partecipante *slot = calloc((size_t)maschera + 1, sizeof(partecipante));
+	if (slot == NULL)
+		return 0;
+
+	for (partecipante p = 1; p < registro_nomi.numero; p++)
+	{
+		uint32_t i = hash_nome(registro_nomi.nomi[p]) & maschera;
+		while (slot[i] != NESSUN_PARTECIPANTE)
+			i = (i + 1) & maschera;
+		slot[i] = p;
+	}
+
+	free(registro_nomi.slot);
+	registro_nomi.slot = slot;
+	registro_nomi.maschera = maschera;
+	return 1;
+}
@@ -0,0 +1,58 @@
+#ifndef NOMI_H
+#define NOMI_H
+
+#include "partecipante.h"
+
+/* Funzione: interna_nome
+*
+* Restituisce l'identificativo del nome indicato, registrandolo se è la prima volta che compare
+*
+* Descrizione:
+* Il registro dei nomi è unico per tutto il programma: ogni nome viene copiato una sola volta
+* e le pile degli iscritti conservano solo il suo identificativo a 32 bit, così copiare
+* o confrontare partecipanti è un'operazione tra interi
+*
+* Parametri:
+* nome: nome del partecipante
+*
+* Pre-condizione:
+* nome è una stringa terminata da \0 più corta di LUNGHEZZA_PARTECIPANTE
+*
+* Post-condizione:
+* Restituisce un identificativo diverso da NESSUN_PARTECIPANTE, lo stesso per nomi uguali,
+* oppure NESSUN_PARTECIPANTE se l'allocazione fallisce
+*
+* Side-effect:
+* Può allocare memoria dinamica per il registro dei nomi
+*/
+partecipante interna_nome(const char *nome);
+
+/* Funzione: cerca_nome
+*
+* Restituisce l'identificativo del nome indicato senza registrarlo
+*
+* Post-condizione:
+* Restituisce NESSUN_PARTECIPANTE se il nome non è mai stato registrato:
+* in quel caso non compare in nessuna pila degli iscritti
+*/
+partecipante cerca_nome(const char *nome);
+
+/* Funzione: nome_partecipante
+*
+* Restituisce il nome corrispondente a un identificativo
+*
+* Pre-condizione:
+* p è stato restituito da interna_nome oppure è NESSUN_PARTECIPANTE
+*
+* Post-condizione:
+* Restituisce il nome, valido fino alla fine del programma, oppure "" per NESSUN_PARTECIPANTE
+*/
+const char *nome_partecipante(partecipante p);
+
+/* Funzione: numero_nomi
+*
+* Restituisce il numero di nomi diversi registrati
+*/
+int numero_nomi(void);
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef PARTECIPANTE_H
 #define PARTECIPANTE_H
 
-#define NESSUN_PARTECIPANTE "" // Assenza del partecipante
+#include <stdint.h>
 
-// Tipo per rappresentare un partecipante ad una lezione
-typedef char partecipante[50];
+#define LUNGHEZZA_PARTECIPANTE 50 // Lunghezza massima del nome di un partecipante, terminatore compreso
+#define NESSUN_PARTECIPANTE 0 // Assenza del partecipante
+
+// Tipo per rappresentare un partecipante ad una lezione: l'identificativo del suo nome
+// nel registro dei nomi (nomi.h), uguale per tutte le lezioni a cui è iscritto
+typedef uint32_t partecipante;
 
 #endif
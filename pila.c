@@ -1,23 +1,61 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
 #include "partecipante.h"
 #include "pila.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCANSIONE_VETTORIALE // Scansione con SSE2 o AVX2, scelta all'avvio in base al processore
+#endif
+
+#define ALLOCATI_INIZIALI 4 // Partecipanti allocati al primo inserimento
+
+// Voce dell'insieme dei partecipanti presenti nella pila
+struct voce
+{
+	partecipante persona; // NESSUN_PARTECIPANTE se la voce è libera
+	uint32_t volte; // Occorrenze di persona nella pila
+	int indice; // Posizione in vet dell'occorrenza più vicina alla cima
+};
+
 // Struttura della pila
 struct c_pila
  {
-	partecipante vet[MASSIMO_PILA];
-	int testa;
+	partecipante *vet; // NULL finché non viene inserito il primo partecipante
+	int testa; // Posizioni occupate di vet, comprese quelle cancellate; vet[testa - 1] non è mai cancellata
+	int cancellati; // Posizioni sotto la cima lasciate a NESSUN_PARTECIPANTE da rimuovi_partecipante_pila
+	int allocati; // Partecipanti che vet può contenere
+	int capienza; // Numero massimo di partecipanti presenti
+	struct voce *insieme; // Indirizzamento aperto, almeno il doppio delle voci rispetto ad allocati
+	uint32_t maschera; // Numero di voci dell'insieme meno uno
 };
 
+static uint32_t posizione_naturale(pila iscritti, partecipante persona);
+static uint32_t posizione_insieme(pila iscritti, partecipante persona);
+static int ricostruisci_insieme(pila iscritti, int allocati);
+static void aggiungi_insieme(pila iscritti, partecipante persona, int indice);
+static void togli_insieme(pila iscritti, partecipante persona);
+static void compatta_pila(pila iscritti);
+static void scopri_cima(pila iscritti);
+static int scansione_scalare(const partecipante *vet, int n, partecipante persona);
+#ifdef SCANSIONE_VETTORIALE
+static int scansione_sse2(const partecipante *vet, int n, partecipante persona);
+static int scansione_avx2(const partecipante *vet, int n, partecipante persona);
+#endif
+static int scegli_scansione(const partecipante *vet, int n, partecipante persona);
+
+// Scansione usata da cerca_pila: al primo uso viene sostituita con la più veloce disponibile
+static int (*scansione)(const partecipante *vet, int n, partecipante persona) = scegli_scansione;
+
 /* Funzione: nuova_pila
 *
-* Crea e inizializza una nuova pila vuota
+* Crea e inizializza una nuova pila vuota senza limite di capienza
 *
 * Descrizione:
-* Alloca dinamicamente una struttura di tipo pila, inizializza l'indice della cima a 0
-* Per indicare che la pila è vuota e restituisce un puntatore alla nuova pila
+* Equivale a nuova_pila_capienza con la capienza più grande rappresentabile
 *
 * Post-condizione:
 * Restituisce un puntatore a una pila vuota chiamata iscritti
@@ -27,15 +65,45 @@ struct c_pila
 */
 pila nuova_pila(void)
  {
-	// Alloca la struttura pila
-	pila iscritti;
-	iscritti = malloc(sizeof(struct c_pila));
+	return nuova_pila_capienza(INT_MAX);
+}
 
+/* Funzione: nuova_pila_capienza
+*
+* Crea una pila vuota che può contenere al più 'capienza' partecipanti
+*
+* Descrizione:
+* Alloca dinamicamente una struttura di tipo pila, inizializza l'indice della cima a 0
+* per indicare che la pila è vuota e memorizza la capienza.
+* Lo spazio per i partecipanti non viene ancora allocato
+*
+* Parametri:
+* capienza: numero massimo di partecipanti
+*
+* Pre-condizione:
+* capienza>0
+*
+* Post-condizione:
+* Restituisce una pila vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per la pila
+*/
+pila nuova_pila_capienza(int capienza)
+{
+	// Alloca la struttura pila
+	pila iscritti = malloc(sizeof(struct c_pila));
 	if (iscritti == NULL)
-	return NULL;
+		return NULL;
 
 	// Inizializza l'indice di testa
+	iscritti->vet = NULL;
 	iscritti->testa = 0;
+	iscritti->cancellati = 0;
+	iscritti->allocati = 0;
+	iscritti->capienza = capienza;
+	iscritti->insieme = NULL;
+	iscritti->maschera = 0;
 	return iscritti;
 }
 
@@ -45,6 +113,7 @@ pila nuova_pila(void)
 *
 *Descrizione:
 * Controlla se l'indice della cima (`testa`) è uguale a zero, condizione che indica che non ci sono elementi nella pila
+* (la posizione in cima non è mai una cancellata, quindi una pila con soli cancellati ha testa zero)
 *
 * Parametri:
 * iscritti: pila da controllare
@@ -65,9 +134,14 @@ int pila_vuota(pila iscritti)
 * Inserisce un partecipante in cima alla pila iscritti, se la pila non è piena
 *
 * Descrizione:
-* Verifica se la pila ha raggiunto la dimensione massima
+* Verifica se la pila ha raggiunto la sua capienza
 * Se piena, restituisce 0 per indicare che l'inserimento non è avvenuto
-* Altrimenti, copia il nome del partecipante nella posizione corrente della cima e incrementa l'indice
+* Se lo spazio allocato è esaurito e almeno metà delle posizioni sono cancellate, compatta la pila;
+* altrimenti raddoppia lo spazio (fino alla capienza, o al doppio della capienza se ci sono
+* posizioni cancellate), così il costo di riallocazioni e compattazioni resta costante in media
+* per inserimento, e ricostruisce l'insieme dei presenti.
+* Poi copia l'identificativo del partecipante nella posizione corrente della cima, incrementa l'indice
+* e aggiorna l'insieme
 * 
 * Parametri:
 * persona: il partecipante da inserire
@@ -77,25 +151,97 @@ int pila_vuota(pila iscritti)
 * iscritti è una pila inizializzata 
 *
 * Post-condizione:
-* Restituisce 1 se il partecipante viene copiato in cima altrimenti restituisce 0
+* Restituisce 1 se il partecipante viene copiato in cima, 0 se la pila è piena, se val
+* è NESSUN_PARTECIPANTE o se manca memoria
 *
 * Side-effect:
 * Modifica la pila iscritti incrementando testa e scrivendo in vet[testa].
+* Può riallocare vet e l'insieme dei presenti
 */
 int inserisci_pila(partecipante val, pila iscritti) 
 {
 	// Verifica se c'è spazio
-	if (iscritti->testa == MASSIMO_PILA)
+	if (iscritti->testa - iscritti->cancellati == iscritti->capienza || val == NESSUN_PARTECIPANTE)
     		return 0;
 
+	// Recupera le posizioni cancellate oppure fa crescere lo spazio allocato
+	if (iscritti->testa == iscritti->allocati)
+	{
+		int limite = iscritti->capienza;
+		if (iscritti->cancellati > 0)
+			limite = iscritti->capienza > INT_MAX / 2 ? INT_MAX : iscritti->capienza * 2;
+
+		if (iscritti->cancellati > 0 && (iscritti->cancellati * 2 >= iscritti->testa || iscritti->allocati >= limite))
+			compatta_pila(iscritti);
+		else
+		{
+			int allocati = iscritti->allocati > 0 ? iscritti->allocati : ALLOCATI_INIZIALI / 2;
+			allocati = allocati > limite / 2 ? limite : allocati * 2;
+			partecipante *vet = realloc(iscritti->vet, allocati * sizeof(partecipante));
+			if (vet == NULL)
+				return 0;
+			iscritti->vet = vet;
+			if (!ricostruisci_insieme(iscritti, allocati))
+				return 0;
+			iscritti->allocati = allocati;
+		}
+	}
+
 	// Copia il partecipante nella posizione corrente
-	strcpy(iscritti->vet[iscritti->testa], val);
-	
+	iscritti->vet[iscritti->testa] = val;
+	aggiungi_insieme(iscritti, val, iscritti->testa);
+
 	// Incrementa l'indice di testa
 	(iscritti->testa)++;
 	return 1;
 }
 
+/* Funzione: inserisci_blocco_pila
+*
+* Inserisce in cima alla pila, in un'unica operazione, n partecipanti consecutivi
+*
+* Descrizione:
+* Verifica una volta sola che ci sia posto per tutto il blocco. Se lo spazio allocato
+* non basta recupera prima le posizioni cancellate, poi porta vet alla dimensione esatta
+* con una sola riallocazione; infine copia il blocco con memcpy e registra i nuovi
+* partecipanti nell'insieme dei presenti
+*
+* Post-condizione:
+* Restituisce 1 se tutti i partecipanti sono stati inseriti, 0 se non c'è posto per tutti
+* o manca memoria (in quel caso la pila non viene modificata)
+*/
+int inserisci_blocco_pila(pila iscritti, const partecipante *blocco, int n)
+{
+	if (n > iscritti->capienza - (iscritti->testa - iscritti->cancellati))
+		return 0;
+	if (n <= 0)
+		return 1;
+
+	if (iscritti->testa + n > iscritti->allocati)
+	{
+		if (iscritti->cancellati > 0)
+			compatta_pila(iscritti);
+
+		if (iscritti->testa + n > iscritti->allocati)
+		{
+			int allocati = iscritti->testa + n;
+			partecipante *vet = realloc(iscritti->vet, allocati * sizeof(partecipante));
+			if (vet == NULL)
+				return 0;
+			iscritti->vet = vet;
+			if (!ricostruisci_insieme(iscritti, allocati))
+				return 0;
+			iscritti->allocati = allocati;
+		}
+	}
+
+	memcpy(&iscritti->vet[iscritti->testa], blocco, n * sizeof(partecipante));
+	for (int i = 0; i < n; i++)
+		aggiungi_insieme(iscritti, blocco[i], iscritti->testa + i);
+	iscritti->testa += n;
+	return 1;
+}
+
 /* Funzione: estrai_pila
 *
 * Estrae l'elemento in cima alla pila iscritti, se presente
@@ -103,15 +249,15 @@ int inserisci_pila(partecipante val, pila iscritti)
 * Descrizione:
 * Verifica se la pila contiene almeno un elemento
 * Se sì, decrementa l'indice della cima (`testa`), copia il valore dell'elemento in cima 
-* nella variabile `estratto`, e restituisce 1 per indicare il successo.
+* nella variabile `estratto`, scarta le posizioni cancellate rimaste in cima e restituisce 1 per indicare il successo.
 * Se la pila è vuota, restituisce 0.
 *
 * Parametri:
 * iscritti: pila da cui estrarre il partecipante
-* estratto: array di caratteri dove verrà copiato il partecipante rimosso dalla cima
+* estratto: puntatore alla variabile dove verrà copiato il partecipante rimosso dalla cima
 *
 * Pre-condizione:
-* iscritti è una pila inizializzata e `estratto` è una variabile di tipo partecipante
+* iscritti è una pila inizializzata e `estratto` punta a una variabile di tipo partecipante
 *
 * Post-condizione:
 * Se la pila contiene almeno un elemento, `estratto` conterrà una copia del partecipante in cima
@@ -120,14 +266,16 @@ int inserisci_pila(partecipante val, pila iscritti)
 * Side-effect:
 * Modifica la pila decrementando `testa`
 */
-int estrai_pila(pila iscritti, partecipante estratto)
+int estrai_pila(pila iscritti, partecipante *estratto)
 {
 	// Verifica se la pila è vuota
 	if (iscritti->testa == 0)
 		return 0;
 
     	iscritti->testa--; // Decrementa l'indice
-    	strcpy(estratto, iscritti->vet[iscritti->testa]); // Copia il partecipante estratto
+    	*estratto = iscritti->vet[iscritti->testa]; // Copia il partecipante estratto
+    	togli_insieme(iscritti, *estratto);
+    	scopri_cima(iscritti);
     	return 1;
 }
 
@@ -147,9 +295,9 @@ int estrai_pila(pila iscritti, partecipante estratto)
 * iscritti deve essere una pila inizializzata e non nulla
 *
 * Post-condizione:
-* se iscritti->testa>0  ritorna un puntatore al partecipante in cima alla pila altrimenti NESSUN_PARTECIPANTE
+* se iscritti->testa>0  ritorna il partecipante in cima alla pila altrimenti NESSUN_PARTECIPANTE
 */
-char* testa(pila iscritti)
+partecipante testa(pila iscritti)
  {
 	 // Verifica se la pila è vuota
 	if (iscritti->testa > 0)
@@ -159,6 +307,138 @@ char* testa(pila iscritti)
     		return NESSUN_PARTECIPANTE;
 }
 
+/* Funzione: elemento_pila
+*
+* Restituisce il partecipante che si trova 'posizione' elementi sotto la cima, senza modificare la pila
+*
+* Descrizione:
+* Senza posizioni cancellate la lettura è un accesso diretto all'indice testa - 1 - posizione.
+* Altrimenti scende dalla cima saltando le posizioni cancellate, che rimuovi_partecipante_pila
+* non lascia mai arrivare a metà di vet
+*
+* Parametri:
+* iscritti: pila da leggere
+* posizione: distanza dalla cima, 0 per l'elemento in cima
+*
+* Post-condizione:
+* Restituisce il partecipante oppure NESSUN_PARTECIPANTE se posizione è fuori dalla pila
+*/
+partecipante elemento_pila(pila iscritti, int posizione)
+{
+	if (posizione < 0 || posizione >= iscritti->testa - iscritti->cancellati)
+		return NESSUN_PARTECIPANTE;
+
+	if (iscritti->cancellati == 0)
+		return iscritti->vet[iscritti->testa - 1 - posizione];
+
+	int i = iscritti->testa - 1;
+	while (1)
+	{
+		if (iscritti->vet[i] != NESSUN_PARTECIPANTE && posizione-- == 0)
+			return iscritti->vet[i];
+		i--;
+	}
+}
+
+/* Funzione: visita_pila
+*
+* Applica la funzione visita a ogni partecipante della pila, dalla cima verso il fondo, senza modificarla
+*
+* Descrizione:
+* Scende una sola volta da vet[testa - 1] a vet[0] saltando le posizioni cancellate:
+* il costo è lineare, mentre elemento_pila chiamata per ogni posizione, con posizioni
+* cancellate, ripartirebbe ogni volta dalla cima
+*/
+void visita_pila(pila iscritti, void (*visita)(partecipante, void *), void *contesto)
+{
+	for (int i = iscritti->testa - 1; i >= 0; i--)
+		if (iscritti->vet[i] != NESSUN_PARTECIPANTE)
+			visita(iscritti->vet[i], contesto);
+}
+
+/* Funzione: rimuovi_partecipante_pila
+*
+* Toglie dalla pila l'occorrenza di un partecipante più vicina alla cima
+*
+* Descrizione:
+* L'insieme dei presenti conosce la posizione dell'occorrenza più vicina alla cima:
+* quella posizione viene segnata come cancellata, senza spostare nessun elemento.
+* Quando almeno metà delle posizioni sono cancellate la pila viene compattata: come in
+* inserisci_pila, il costo delle compattazioni resta costante in media per rimozione
+*
+* Post-condizione:
+* Restituisce 1 se il partecipante è stato tolto, 0 se non era nella pila
+*
+* Side-effect:
+* Modifica la pila lasciando una posizione cancellata (scartata subito se era in cima)
+* e, superata la soglia, compattandola
+*/
+int rimuovi_partecipante_pila(pila iscritti, partecipante persona)
+{
+	if (!contiene_pila(iscritti, persona))
+		return 0;
+
+	int indice = iscritti->insieme[posizione_insieme(iscritti, persona)].indice;
+	iscritti->vet[indice] = NESSUN_PARTECIPANTE;
+	iscritti->cancellati++;
+	togli_insieme(iscritti, persona);
+	scopri_cima(iscritti);
+	if (iscritti->cancellati * 2 >= iscritti->testa && iscritti->cancellati > 0)
+		compatta_pila(iscritti);
+	return 1;
+}
+
+/* Funzione: contiene_pila
+*
+* Controlla se un partecipante è presente nella pila
+*
+* Descrizione:
+* Consulta l'insieme dei presenti, tenuto allineato con la pila da ogni inserimento ed estrazione:
+* il costo non dipende dal numero di iscritti
+*
+* Post-condizione:
+* Restituisce 1 se persona compare almeno una volta nella pila, altrimenti 0
+*/
+int contiene_pila(pila iscritti, partecipante persona)
+{
+	if (iscritti->insieme == NULL || persona == NESSUN_PARTECIPANTE)
+		return 0;
+
+	return iscritti->insieme[posizione_insieme(iscritti, persona)].persona == persona;
+}
+
+/* Funzione: cerca_pila
+*
+* Restituisce la distanza dalla cima dell'occorrenza di un partecipante più vicina alla cima
+*
+* Descrizione:
+* Confronta persona con più posizioni di vet alla volta, partendo dalla cima:
+* otto per istruzione con AVX2, quattro con SSE2, una alla volta con la scansione
+* scalare se il processore non offre nessuna delle due. Le posizioni cancellate valgono
+* NESSUN_PARTECIPANTE e non corrispondono mai; quelle sopra l'occorrenza trovata
+* vengono escluse dalla distanza, così resta coerente con elemento_pila
+*
+* Post-condizione:
+* Restituisce la distanza dalla cima (0 per la cima) oppure -1 se persona non è nella pila
+*/
+int cerca_pila(pila iscritti, partecipante persona)
+{
+	if (persona == NESSUN_PARTECIPANTE || iscritti->testa == 0)
+		return -1;
+
+	int indice = scansione(iscritti->vet, iscritti->testa, persona);
+	if (indice < 0)
+		return -1;
+
+	int distanza = iscritti->testa - 1 - indice;
+	for (int i = indice + 1; iscritti->cancellati > 0 && i < iscritti->testa; i++)
+	{
+		if (iscritti->vet[i] == NESSUN_PARTECIPANTE)
+			distanza--;
+	}
+	return distanza;
+}
+
 /* Funzione: dimensione_pila
 *
 * Restituisce il numero di elementi attualmente presenti nella pila iscritti
@@ -174,7 +454,8 @@ char* testa(pila iscritti)
 * iscritti = <a1, a2, ..., an> n>0
 *
 * Post-condizione:
-* Se iscritti == NULL ritorna -1, altrimenti ritorna iscritti->testa (che può essere 0 se vuota)
+* Se iscritti == NULL ritorna -1, altrimenti ritorna il numero di partecipanti presenti,
+* cioè iscritti->testa meno le posizioni cancellate (che può essere 0 se vuota)
 */
 int dimensione_pila(pila iscritti)
  {
@@ -182,5 +463,296 @@ int dimensione_pila(pila iscritti)
 	if (iscritti == NULL)
     		return -1;  
 
-	return iscritti->testa; 
+	return iscritti->testa - iscritti->cancellati; 
+}
+
+/* Funzione: capienza_pila
+*
+* Restituisce il numero massimo di partecipanti che la pila può contenere
+*
+* Pre-condizione:
+* iscritti è una pila inizializzata
+*/
+int capienza_pila(pila iscritti)
+{
+	return iscritti->capienza;
+}
+
+/* Funzione: distruggi_pila
+*
+* Libera la pila e lo spazio dei suoi partecipanti
+*
+* Pre-condizione:
+* iscritti è una pila inizializzata oppure NULL
+*/
+void distruggi_pila(pila iscritti)
+{
+	if (iscritti == NULL)
+		return;
+
+	free(iscritti->vet);
+	free(iscritti->insieme);
+	free(iscritti);
+}
+
+/* Funzione: posizione_naturale
+*
+* Restituisce la voce da cui parte la scansione dell'insieme per persona
+*
+* Descrizione:
+* Gli identificativi sono interi consecutivi: la moltiplicazione per la costante di Fibonacci
+* li sparge su 32 bit, di cui vengono presi quelli alti
+*/
+static uint32_t posizione_naturale(pila iscritti, partecipante persona)
+{
+	return (uint32_t)((uint64_t)(persona * 2654435769u) * (iscritti->maschera + 1) >> 32);
+}
+
+/* Funzione: posizione_insieme
+*
+* Restituisce la voce dell'insieme che contiene persona oppure la prima voce libera della sua scansione
+*/
+static uint32_t posizione_insieme(pila iscritti, partecipante persona)
+{
+	uint32_t i = posizione_naturale(iscritti, persona);
+	while (iscritti->insieme[i].persona != NESSUN_PARTECIPANTE && iscritti->insieme[i].persona != persona)
+		i = (i + 1) & iscritti->maschera;
+
+	return i;
+}
+
+/* Funzione: ricostruisci_insieme
+*
+* Alloca un insieme dimensionato per 'allocati' partecipanti e vi reinserisce quelli presenti nella pila
+*
+* Post-condizione:
+* Restituisce 1 se l'insieme è stato ricostruito, 0 se l'allocazione fallisce (l'insieme resta quello di prima)
+*/
+static int ricostruisci_insieme(pila iscritti, int allocati)
+{
+	uint32_t voci = 1;
+	while (voci < 2 * (uint32_t)allocati)
+		voci *= 2;
+
+	struct voce *insieme = calloc(voci, sizeof(struct voce));
+	if (insieme == NULL)
+		return 0;
+
+	free(iscritti->insieme);
+	iscritti->insieme = insieme;
+	iscritti->maschera = voci - 1;
+	for (int i = 0; i < iscritti->testa; i++)
+	{
+		if (iscritti->vet[i] != NESSUN_PARTECIPANTE)
+			aggiungi_insieme(iscritti, iscritti->vet[i], i);
+	}
+	return 1;
+}
+
+/* Funzione: aggiungi_insieme
+*
+* Conta una occorrenza in più di persona, che si trova in vet[indice], nell'insieme dei presenti
+*
+* Pre-condizione:
+* Nessuna occorrenza di persona sta sopra vet[indice]
+*/
+static void aggiungi_insieme(pila iscritti, partecipante persona, int indice)
+{
+	struct voce *v = &iscritti->insieme[posizione_insieme(iscritti, persona)];
+	v->persona = persona;
+	v->volte++;
+	v->indice = indice;
+}
+
+/* Funzione: togli_insieme
+*
+* Conta una occorrenza in meno di persona e libera la sua voce quando non ne restano
+*
+* Descrizione:
+* Se restano altre occorrenze cerca, scendendo da quella appena tolta, la nuova più vicina alla cima:
+* succede solo con nomi ripetuti nella stessa pila, che le prenotazioni non consentono.
+* La voce liberata viene riempita spostando indietro le voci successive della stessa scansione
+* che non si trovano già nella loro posizione naturale: l'insieme non accumula voci cancellate
+*
+* Pre-condizione:
+* L'occorrenza più vicina alla cima è già stata tolta da vet
+*/
+static void togli_insieme(pila iscritti, partecipante persona)
+{
+	uint32_t libera = posizione_insieme(iscritti, persona);
+	struct voce *v = &iscritti->insieme[libera];
+	if (--v->volte > 0)
+	{
+		int i = v->indice - 1;
+		while (iscritti->vet[i] != persona)
+			i--;
+		v->indice = i;
+		return;
+	}
+
+	uint32_t j = libera;
+	while (1)
+	{
+		j = (j + 1) & iscritti->maschera;
+		partecipante p = iscritti->insieme[j].persona;
+		if (p == NESSUN_PARTECIPANTE)
+			break;
+
+		// La voce j può occupare la voce libera solo se la sua posizione naturale non sta tra le due
+		uint32_t naturale = posizione_naturale(iscritti, p);
+		if (((j - naturale) & iscritti->maschera) >= ((j - libera) & iscritti->maschera))
+		{
+			iscritti->insieme[libera] = iscritti->insieme[j];
+			libera = j;
+		}
+	}
+	iscritti->insieme[libera].persona = NESSUN_PARTECIPANTE;
+	iscritti->insieme[libera].volte = 0;
+}
+
+/* Funzione: compatta_pila
+*
+* Elimina le posizioni cancellate facendo scendere gli elementi che stanno sopra di esse
+*
+* Descrizione:
+* L'ordine degli elementi non cambia; le posizioni registrate nell'insieme vengono aggiornate
+* scorrendo dal fondo verso la cima, così per ogni persona vince l'occorrenza più alta
+*/
+static void compatta_pila(pila iscritti)
+{
+	int j = 0;
+	for (int i = 0; i < iscritti->testa; i++)
+	{
+		partecipante p = iscritti->vet[i];
+		if (p == NESSUN_PARTECIPANTE)
+			continue;
+
+		iscritti->vet[j] = p;
+		iscritti->insieme[posizione_insieme(iscritti, p)].indice = j;
+		j++;
+	}
+	iscritti->testa = j;
+	iscritti->cancellati = 0;
+}
+
+/* Funzione: scopri_cima
+*
+* Scarta le posizioni cancellate rimaste in cima, così vet[testa - 1] è sempre un partecipante
+*/
+static void scopri_cima(pila iscritti)
+{
+	while (iscritti->testa > 0 && iscritti->vet[iscritti->testa - 1] == NESSUN_PARTECIPANTE)
+	{
+		iscritti->testa--;
+		iscritti->cancellati--;
+	}
+}
+
+/* Funzione: scansione_scalare
+*
+* Restituisce l'ultimo indice di vet[0..n) che contiene persona, oppure -1
+*
+* Descrizione:
+* Versione di riferimento, usata quando il processore non offre istruzioni vettoriali
+* e per le posizioni che avanzano dai blocchi delle altre scansioni
+*/
+static int scansione_scalare(const partecipante *vet, int n, partecipante persona)
+{
+	for (int i = n - 1; i >= 0; i--)
+	{
+		if (vet[i] == persona)
+			return i;
+	}
+	return -1;
+}
+
+#ifdef SCANSIONE_VETTORIALE
+/* Funzione: scansione_sse2
+*
+* Come scansione_scalare, confrontando quattro identificativi per istruzione
+*
+* Descrizione:
+* Legge vet a blocchi di quattro partendo dalla fine; la maschera del confronto dice
+* quali posizioni del blocco corrispondono e il bit più alto è la più vicina alla cima
+*/
+__attribute__((target("sse2")))
+static int scansione_sse2(const partecipante *vet, int n, partecipante persona)
+{
+	__m128i cercato = _mm_set1_epi32((int)persona);
+	int i = n;
+
+	while (i >= 4)
+	{
+		i -= 4;
+		__m128i blocco = _mm_loadu_si128((const __m128i *)&vet[i]);
+		int maschera = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(blocco, cercato)));
+		if (maschera != 0)
+			return i + 31 - __builtin_clz(maschera);
+	}
+	return scansione_scalare(vet, i, persona);
+}
+
+/* Funzione: scansione_avx2
+*
+* Come scansione_sse2, con blocchi di otto identificativi e le posizioni rimanenti confrontate una alla volta
+*/
+__attribute__((target("avx2")))
+static int scansione_avx2(const partecipante *vet, int n, partecipante persona)
+{
+	__m256i cercato = _mm256_set1_epi32((int)persona);
+	int i = n;
+
+	while (i >= 8)
+	{
+		i -= 8;
+		__m256i blocco = _mm256_loadu_si256((const __m256i *)&vet[i]);
+		int maschera = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(blocco, cercato)));
+		if (maschera != 0)
+			return i + 31 - __builtin_clz(maschera);
+	}
+
+	// Le ultime posizioni restano nelle istruzioni AVX: passare al codice SSE2
+	// con i registri a 256 bit ancora in uso costerebbe più del ciclo stesso
+	while (--i >= 0)
+	{
+		if (vet[i] == persona)
+			return i;
+	}
+	return -1;
+}
+#endif
+
+/* Funzione: scegli_scansione
+*
+* Sceglie la scansione più veloce offerta dal processore, la memorizza in 'scansione'
+* per le chiamate successive ed esegue questa
+*/
+static int scegli_scansione(const partecipante *vet, int n, partecipante persona)
+{
+	scansione = scansione_scalare;
+#ifdef SCANSIONE_VETTORIALE
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		scansione = scansione_avx2;
+	else if (__builtin_cpu_supports("sse2"))
+		scansione = scansione_sse2;
+#endif
+	return scansione(vet, n, persona);
+}
+
+/* Funzione: nome_scansione_pila
+*
+* Restituisce il nome delle istruzioni usate da cerca_pila su questo processore
+*/
+const char *nome_scansione_pila(void)
+{
+	if (scansione == scegli_scansione)
+		scegli_scansione(NULL, 0, NESSUN_PARTECIPANTE);
+#ifdef SCANSIONE_VETTORIALE
+	if (scansione == scansione_avx2)
+		return "AVX2";
+	if (scansione == scansione_sse2)
+		return "SSE2";
+#endif
+	return "scalare";
 }
@@ -2,13 +2,15 @@
 #define PILA_H
 
 #include "partecipante.h"
-#define MASSIMO_PILA 20 // Capacità massima della pila
 
 typedef struct c_pila *pila;
 
 /* Funzione: nuova_pila
 *
-* Crea e inizializza una nuova pila vuota
+* Crea e inizializza una nuova pila vuota senza limite di capienza
+*
+* Descrizione:
+* Usata per le pile di appoggio, che devono poter contenere tutti gli iscritti di qualunque lezione
 *
 * Post-condizione:
 * Restituisce un puntatore a una pila vuota chiamata iscritti
@@ -18,6 +20,29 @@ typedef struct c_pila *pila;
 */
 pila nuova_pila(void);
 
+/* Funzione: nuova_pila_capienza
+*
+* Crea una pila vuota che può contenere al più 'capienza' partecipanti
+*
+* Descrizione:
+* Lo spazio per i partecipanti viene allocato solo al primo inserimento e poi raddoppiato
+* quando serve, senza mai superare la capienza: una lezione senza prenotazioni non occupa
+* memoria per gli iscritti
+*
+* Parametri:
+* capienza: numero massimo di partecipanti
+*
+* Pre-condizione:
+* capienza>0
+*
+* Post-condizione:
+* Restituisce una pila vuota oppure NULL se l'allocazione fallisce
+*
+* Side-effect:
+* Alloca memoria dinamica per la pila
+*/
+pila nuova_pila_capienza(int capienza);
+
 /* Funzione: pila_vuota
 *
 * Controlla se la pila iscritti è vuota
@@ -35,33 +60,61 @@ int pila_vuota(pila iscritti);
 
 /* Funzione: inserisci_pila
 *
-* Inserisce un partecipante in cima alla pila iscritti, se la pila non è piena
+* Inserisce un partecipante in cima alla pila iscritti, se la pila non ha raggiunto la sua capienza
 *
 * Parametri:
-* persona: il partecipante da inserire
+* persona: il partecipante da inserire, come restituito da interna_nome
 * iscritti: la pila in cui inserire i partecipanti 
 *
 * Pre-condizione:
 * 'iscritti' è una pila inizializzata 
 *
 * Post-condizione:
-* Restituisce 1 se il partecipante viene copiato in cima altrimenti restituisce 0
+* Restituisce 1 se il partecipante viene copiato in cima, 0 se la pila è piena, se val
+* è NESSUN_PARTECIPANTE o se manca memoria
 *
 * Side-effect:
 * Modifica la pila iscritti incrementando testa e scrivendo in vet[testa].
+* Può riallocare lo spazio dei partecipanti
 */
 int inserisci_pila(partecipante val, pila iscritti);
 
+/* Funzione: inserisci_blocco_pila
+*
+* Inserisce in cima alla pila, in un'unica operazione, n partecipanti consecutivi
+*
+* Descrizione:
+* Equivale a n chiamate di inserisci_pila con blocco[0], blocco[1], ..., blocco[n-1]
+* (blocco[n-1] finisce in cima), ma controlla la capienza una volta sola,
+* alloca al più una volta lo spazio esatto e copia il blocco intero
+*
+* Parametri:
+* iscritti: la pila in cui inserire i partecipanti
+* blocco: array contiguo di partecipanti
+* n: numero di partecipanti del blocco
+*
+* Pre-condizione:
+* 'iscritti' è una pila inizializzata, n>=0, nessun elemento di blocco è NESSUN_PARTECIPANTE
+*
+* Post-condizione:
+* Restituisce 1 se tutti i partecipanti sono stati inseriti, 0 se non c'è posto per tutti
+* o manca memoria (in quel caso la pila non viene modificata)
+*
+* Side-effect:
+* Può riallocare lo spazio dei partecipanti e l'insieme dei presenti
+*/
+int inserisci_blocco_pila(pila iscritti, const partecipante *blocco, int n);
+
 /* Funzione: estrai_pila
 *
 * Estrae l'elemento in cima alla pila iscritti, se presente
 *
 * Parametri:
 * iscritti: pila da cui estrarre il partecipante
-* estratto: array di caratteri dove verrà copiato il partecipante rimosso dalla cima
+* estratto: puntatore alla variabile dove verrà copiato il partecipante rimosso dalla cima
 *
 * Pre-condizione:
-* 'iscritti' è una pila inizializzata e `estratto` è una variabile di tipo partecipante
+* 'iscritti' è una pila inizializzata e `estratto` punta a una variabile di tipo partecipante
 *
 * Post-condizione:
 * Se la pila contiene almeno un elemento, `estratto` conterrà una copia del partecipante in cima
@@ -70,7 +123,7 @@ int inserisci_pila(partecipante val, pila iscritti);
 * Side-effect:
 * Modifica la pila decrementando `testa`
 */
-int estrai_pila(pila iscritti, partecipante estratto);
+int estrai_pila(pila iscritti, partecipante *estratto);
 
 /* Funzione: testa
 *
@@ -83,9 +136,117 @@ int estrai_pila(pila iscritti, partecipante estratto);
 * 'iscritti' deve essere una pila inizializzata e non nulla
 *
 * Post-condizione:
-* Se iscritti->testa>0 ritorna un puntatore al partecipante in cima alla pila altrimenti NESSUN_PARTECIPANTE
+* Se iscritti->testa>0 ritorna il partecipante in cima alla pila altrimenti NESSUN_PARTECIPANTE
+*/
+partecipante testa(pila iscritti);
+
+/* Funzione: elemento_pila
+*
+* Restituisce il partecipante che si trova 'posizione' elementi sotto la cima, senza modificare la pila
+*
+* Descrizione:
+* Permette di leggere gli iscritti nell'ordine in cui estrai_pila li restituirebbe,
+* scorrendo posizione da 0 a dimensione_pila - 1, senza pile di appoggio.
+* È un accesso diretto finché la pila non ha posizioni cancellate; altrimenti la lettura
+* scende dalla cima saltandole
+*
+* Parametri:
+* iscritti: pila da leggere
+* posizione: distanza dalla cima, 0 per l'elemento in cima
+*
+* Pre-condizione:
+* 'iscritti' è una pila inizializzata
+*
+* Post-condizione:
+* Restituisce il partecipante oppure NESSUN_PARTECIPANTE se posizione è fuori dalla pila
+*/
+partecipante elemento_pila(pila iscritti, int posizione);
+
+/* Funzione: visita_pila
+*
+* Applica la funzione visita a ogni partecipante della pila, dalla cima verso il fondo, senza modificarla
+*
+* Descrizione:
+* Visita gli iscritti nello stesso ordine di elemento_pila con posizione da 0 a dimensione_pila - 1,
+* ma con una sola passata su vet anche quando la pila ha posizioni cancellate
+*
+* Parametri:
+* iscritti: pila da leggere
+* visita: funzione chiamata per ogni partecipante
+* contesto: puntatore passato invariato a ogni chiamata di visita
+*
+* Pre-condizione:
+* 'iscritti' è una pila inizializzata e visita non la modifica
+*/
+void visita_pila(pila iscritti, void (*visita)(partecipante, void *), void *contesto);
+
+/* Funzione: rimuovi_partecipante_pila
+*
+* Toglie dalla pila l'occorrenza di un partecipante più vicina alla cima
+*
+* Descrizione:
+* Richiede tempo costante in media, qualunque sia il numero di iscritti: la posizione del partecipante
+* viene trovata tramite l'insieme dei presenti e segnata come cancellata; quando le posizioni
+* cancellate arrivano a metà la pila viene compattata. L'ordine degli altri iscritti non cambia
+*
+* Parametri:
+* iscritti: pila da modificare
+* persona: il partecipante da togliere
+*
+* Pre-condizione:
+* 'iscritti' è una pila inizializzata
+*
+* Post-condizione:
+* Restituisce 1 se il partecipante è stato tolto, 0 se non era nella pila
+*
+* Side-effect:
+* Modifica la pila lasciando una posizione cancellata, oppure compattandola
+*/
+int rimuovi_partecipante_pila(pila iscritti, partecipante persona);
+
+/* Funzione: contiene_pila
+*
+* Controlla se un partecipante è presente nella pila, in tempo costante
+*
+* Parametri:
+* iscritti: pila da controllare
+* persona: il partecipante da cercare
+*
+* Pre-condizione:
+* 'iscritti' è una pila inizializzata
+*
+* Post-condizione:
+* Restituisce 1 se persona compare almeno una volta nella pila, altrimenti 0
 */
-char* testa(pila iscritti);
+int contiene_pila(pila iscritti, partecipante persona);
+
+/* Funzione: cerca_pila
+*
+* Cerca un partecipante scorrendo la pila dalla cima
+*
+* Descrizione:
+* Confronta più partecipanti alla volta con istruzioni SSE2 o AVX2, scelte la prima
+* volta in base al processore; senza di esse la scansione è un ciclo semplice.
+* A differenza di contiene_pila dice anche dove si trova il partecipante
+*
+* Parametri:
+* iscritti: pila in cui cercare
+* persona: il partecipante da cercare
+*
+* Pre-condizione:
+* 'iscritti' è una pila inizializzata
+*
+* Post-condizione:
+* Restituisce la distanza dalla cima dell'occorrenza più vicina alla cima,
+* utilizzabile con elemento_pila, oppure -1 se persona non è nella pila
+*/
+int cerca_pila(pila iscritti, partecipante persona);
+
+/* Funzione: nome_scansione_pila
+*
+* Restituisce il nome delle istruzioni usate da cerca_pila: "AVX2", "SSE2" o "scalare"
+*/
+const char *nome_scansione_pila(void);
 
 /* Funzione: dimensione_pila
 *
@@ -98,8 +259,27 @@ char* testa(pila iscritti);
 * 'iscritti' è una pila inizializzata (può essere vuota)
 *
 * Post-condizione:
-* Se iscritti == NULL ritorna -1, altrimenti ritorna iscritti->testa (che può essere 0 se vuota)
+* Se iscritti == NULL ritorna -1, altrimenti ritorna il numero di partecipanti presenti,
+* escluse le posizioni cancellate (che può essere 0 se vuota)
 */
 int dimensione_pila(pila iscritti);
 
+/* Funzione: capienza_pila
+*
+* Restituisce il numero massimo di partecipanti che la pila può contenere
+*
+* Pre-condizione:
+* 'iscritti' è una pila inizializzata
+*/
+int capienza_pila(pila iscritti);
+
+/* Funzione: distruggi_pila
+*
+* Libera la pila e lo spazio dei suoi partecipanti
+*
+* Pre-condizione:
+* 'iscritti' è una pila inizializzata oppure NULL
+*/
+void distruggi_pila(pila iscritti);
+
 #endif
@@ -2,27 +2,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <sys/stat.h>
 #include "coda.h"
 #include "lezione.h"
 #include "hash.h"
 #include "utile_coda.h"
 #include "test_programma.h"
 #include "pila.h"
+#include "nomi.h"
 #include "utile_hash.h"
 
-// Nodo della coda
-struct nodo
-{
-	lezione valore;
-	struct nodo *prossimo;
-};
-
-// Struttura della coda
-struct c_coda
-{
-	struct nodo *testa,*coda;
-	int numel;
-};
+static void registra_esito(int numero, int esito);
+static int ordine_salvato(pila iscritti, const char *nome_file, const char *attesi[], int numero_attesi);
+static int calendario_coerente(coda calendario, lezione inserite[], int numero_inserite);
+static void libera_calendario(coda calendario);
 
 /* Funzione: confronta_file
 *
@@ -171,11 +164,11 @@ void caso_test_1()
         return;
     }
 
-    lezione *lez = &calendario->testa->valore;
+    lezione *lez = elemento_coda(calendario, 0);
     if (lez->iscritti == NULL) {
-        lez->iscritti = nuova_pila();
+        lez->iscritti = nuova_pila_capienza(CAPIENZA_LEZIONE);
     }
-    inserisci_pila(utenti[num_iscritti - 1], lez->iscritti);
+    inserisci_pila(interna_nome(utenti[num_iscritti - 1]), lez->iscritti);
 
     // 4. Salva output e oracle aggiornati
     salva_lezioni(calendario, "caso_test_1_output.txt");
@@ -247,8 +240,9 @@ void caso_test_2()
     abbonato nuovo;
     strcpy(nuovo.nomeutente, nomeutente);
     strcpy(nuovo.password, "1234");
-    nuovo.chiave = strdup(nuovo.nomeutente);
+    nuovo.chiave = nuovo.nomeutente;
     nuovo.lezioni_rimanenti = 0;
+    nuovo.ultima_attivita = time(NULL);
 
     tabella_hash tabella = carica_abbonati("caso_test_2_abbonati.txt");
     tabella = inserisci_hash(nuovo, tabella);
@@ -257,11 +251,13 @@ void caso_test_2()
     printf("Abbonato creato: %s\n", nuovo.nomeutente);
 
     // 4. Ricarica e verifica
+    distruggi_hash(tabella);
     tabella = carica_abbonati("caso_test_2_abbonati.txt");
     abbonato *trovato = cerca_hash(nomeutente, tabella);
     if (!trovato) {
         printf("ERRORE: Utente non trovato dopo la creazione.\n");
         getchar();
+        distruggi_hash(tabella);
         return;
     }
 
@@ -280,17 +276,18 @@ void caso_test_2()
 
     // 7. Prenotazione automatica
     printf("Prenotazione automatica della prima lezione...\n");
-    struct nodo *lezione_test = calendario->testa;
+    lezione *lezione_test = elemento_coda(calendario, 0);
     if (!lezione_test) {
         printf("ERRORE: Nessuna lezione disponibile.\n");
         getchar();
+        distruggi_hash(tabella);
         return;
     }
 
-    int iscritti_pre = dimensione_pila(lezione_test->valore.iscritti);
+    int iscritti_pre = dimensione_pila(lezione_test->iscritti);
     int lezioni_pre = trovato->lezioni_rimanenti;
 
-    if (inserisci_pila(trovato->nomeutente, lezione_test->valore.iscritti)) {
+    if (inserisci_pila(interna_nome(trovato->nomeutente), lezione_test->iscritti)) {
         trovato->lezioni_rimanenti--;
         salva_abbonati(tabella, "caso_test_2_abbonati.txt");
 
@@ -298,7 +295,7 @@ void caso_test_2()
         salva_lezioni(calendario, "caso_test_2_output.txt");
         salva_lezioni(calendario, "caso_test_2_oracle.txt");
 
-        int iscritti_post = dimensione_pila(lezione_test->valore.iscritti);
+        int iscritti_post = dimensione_pila(lezione_test->iscritti);
         printf("Prenotazione riuscita. Iscritti prima: %d, dopo: %d\n", iscritti_pre, iscritti_post);
         printf("Lezioni rimanenti: %d\n", trovato->lezioni_rimanenti);
 
@@ -325,6 +322,7 @@ void caso_test_2()
     } else {
         printf("ERRORE: Prenotazione fallita dopo ricarica.\n");
     }
+    distruggi_hash(tabella);
 
     printf("Premi INVIO per tornare al menu...");
     getchar();
@@ -359,41 +357,37 @@ void caso_test_3(coda calendario)
     srand(time(NULL));
 
     // 1. Leggi la data corrente da file o inizializza a 3 marzo 2025
-    struct tm data_corrente = {0};
+    // Il file conserva giorno, mese e anno come in struct tm (mese da 0, anno dal 1900)
+    int giorno_file = 3, mese_file = 2, anno_file = 2025 - 1900;
     FILE *data_file = fopen("ct3_data_corrente.txt", "r");
     if (data_file) {
-        fscanf(data_file, "%d %d %d", &data_corrente.tm_mday, &data_corrente.tm_mon, &data_corrente.tm_year);
+        fscanf(data_file, "%d %d %d", &giorno_file, &mese_file, &anno_file);
         fclose(data_file);
-    } else {
-        data_corrente.tm_mday = 3;
-        data_corrente.tm_mon = 2; // Marzo (0-based)
-        data_corrente.tm_year = 2025 - 1900;
     }
+    int64_t giorno = giorno_civile(anno_file + 1900, mese_file + 1, giorno_file);
 
     // 2. Cerca la prossima data valida e passata
     int lezione_generata = 0;
-    char data_str[11], giorno[20], orario[20];
-    int ora_inizio;
+    int fascia;
+    int64_t adesso = istante_attuale();
+    int64_t oggi = adesso / SECONDI_GIORNO;
     lezione l;
 
     while (!lezione_generata) {
-        mktime(&data_corrente);
-        strftime(data_str, sizeof(data_str), "%d/%m/%Y", &data_corrente);
-
-        if (giorno_lezione(data_corrente.tm_wday, giorno, orario, &ora_inizio) &&
-            data_passata(data_str, orario)) {
+        if (giorno_lezione(giorno_della_settimana(giorno), &fascia) &&
+            data_passata(inizio_lezione(giorno, fascia), adesso)) {
 
             // Crea la lezione
-            l.iscritti = nuova_pila();
-            strcpy(l.data, data_str);
-            strcpy(l.giorno, giorno);
-            strcpy(l.orario, orario);
+            l.iscritti = nuova_pila_capienza(CAPIENZA_LEZIONE);
+            l.attesa = nuova_attesa(CAPIENZA_ATTESA);
+            l.inizio = inizio_lezione(giorno, fascia);
+            l.fascia = fascia;
 
             int num_partecipanti = rand() % 10 + 1;
             for (int i = 1; i <= num_partecipanti; i++) {
                 char nome[50];
                 snprintf(nome, sizeof(nome), "utente%d", i);
-                inserisci_pila(nome, l.iscritti);
+                inserisci_pila(interna_nome(nome), l.iscritti);
             }
 
             inserisci_lezione(l, calendario);
@@ -402,52 +396,30 @@ void caso_test_3(coda calendario)
             // Scrive la lezione anche nel file di input
             FILE *input = fopen("caso_test_3_input.txt", "w");
             if (input) {
-                fprintf(input, "%s;%s;%s;%d\n", l.data, l.giorno, l.orario, num_partecipanti);
-                pila temp = nuova_pila();
-                partecipante p;
-                while (!pila_vuota(l.iscritti)) {
-                    if (estrai_pila(l.iscritti, p)) {
-                        fprintf(input, "%s\n", p);
-                        inserisci_pila(p, temp);
-                    }
-                }
-                while (!pila_vuota(temp)) {
-                    if (estrai_pila(temp, p)) {
-                        inserisci_pila(p, l.iscritti);
-                    }
+                char data_str[11];
+                scrivi_data(l.inizio, data_str);
+                fprintf(input, "%s;%s;%s;%d\n", data_str, nome_giorno(l.inizio), orario_fascia(l.fascia), num_partecipanti);
+                for (int i = 0; i < num_partecipanti; i++) {
+                    fprintf(input, "%s\n", nome_partecipante(elemento_pila(l.iscritti, i)));
                 }
                 fclose(input);
             }
 
             // Aggiorna la data per la prossima esecuzione
-            data_corrente.tm_mday++;
-            mktime(&data_corrente);
+            giorno++;
+            data_civile(giorno, &anno_file, &mese_file, &giorno_file);
             FILE *next = fopen("ct3_data_corrente.txt", "w");
             if (next) {
-                fprintf(next, "%d %d %d", data_corrente.tm_mday, data_corrente.tm_mon, data_corrente.tm_year);
+                fprintf(next, "%d %d %d", giorno_file, mese_file - 1, anno_file - 1900);
                 fclose(next);
             }
         } else {
             // Se la data non è valida o non è passata, passa al giorno successivo
-            data_corrente.tm_mday++;
-            mktime(&data_corrente);
+            giorno++;
         }
 
         // Se la data è oggi o futura, interrompi il ciclo
-        time_t oggi = time(NULL);
-        struct tm oggi_tm = *localtime(&oggi);
-        oggi_tm.tm_hour = 0;
-        oggi_tm.tm_min = 0;
-        oggi_tm.tm_sec = 0;
-        time_t tempo_oggi = mktime(&oggi_tm);
-
-        struct tm temp = data_corrente;
-        temp.tm_hour = 0;
-        temp.tm_min = 0;
-        temp.tm_sec = 0;
-        time_t tempo_data = mktime(&temp);
-
-        if (difftime(tempo_data, tempo_oggi) >= 0 && !lezione_generata) {
+        if (giorno >= oggi && !lezione_generata) {
             printf("Tutte le lezioni passate sono già state generate.\n");
             printf("Premi INVIO per tornare al menu principale...");
             getchar();
@@ -469,7 +441,7 @@ void caso_test_3(coda calendario)
     coda finali = nuova_coda();
     while (!coda_vuota(lezioni_precedenti)) {
         lezione lezione_corrente = rimuovi_lezione(lezioni_precedenti);
-        if (data_passata(lezione_corrente.data, lezione_corrente.orario)) {
+        if (data_passata(lezione_corrente.inizio, adesso)) {
             inserisci_lezione(lezione_corrente, finali);
         }
     }
@@ -500,4 +472,576 @@ void caso_test_3(coda calendario)
 
     printf("Verifica completata. Premi INVIO per tornare al menu principale...");
     getchar();
-}
\ No newline at end of file
+}
+
+/* Funzione: caso_test_4
+*
+* Verifica la rimozione degli abbonati senza lezioni e inattivi
+*
+* Descrizione:
+* Dei quattro abbonati scritti nel file, vanno rimossi solo quelli senza lezioni rimanenti
+* la cui ultima attività precede il limite: chi ha ancora lezioni o è attivo da poco resta.
+* Una seconda purga non deve trovare nessuno e il file salvato deve contenere solo i rimasti.
+*
+* Side-effect:
+* - Sovrascrive il file \"caso_test_4_abbonati.txt\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_4()
+{
+    printf("\n--- TEST 4: Purga degli abbonati inattivi ---\n");
+    printf("Rimuove gli abbonati senza lezioni inattivi da oltre un anno e verifica che gli altri restino.\n\n");
+    printf("Premi INVIO per iniziare...");
+    getchar();
+
+    time_t adesso = time(NULL);
+    time_t limite = adesso - (time_t)365 * SECONDI_GIORNO;
+
+    // 1. Scrive gli abbonati: due da rimuovere e due da tenere
+    FILE *f = fopen("caso_test_4_abbonati.txt", "w");
+    if (!f) {
+        printf("Errore nella scrittura dei file di test.\nPremi INVIO per tornare al menu...");
+        getchar();
+        return;
+    }
+    fprintf(f, "Inattivo_Senza;1234;0;%lld\n", (long long)(limite - 1));
+    fprintf(f, "Inattivo_Con;1234;3;%lld\n", (long long)(limite - 1));
+    fprintf(f, "Attivo_Senza;1234;0;%lld\n", (long long)adesso);
+    fprintf(f, "Mai_Attivo;1234;0;0\n");
+    fclose(f);
+
+    // 2. Purga
+    tabella_hash tabella = carica_abbonati("caso_test_4_abbonati.txt");
+    int rimossi = purga_abbonati(tabella, limite);
+    printf("Abbonati rimossi: %d (attesi 2)\n", rimossi);
+
+    int esito = rimossi == 2 &&
+        cerca_hash("Inattivo_Senza", tabella) == NULL &&
+        cerca_hash("Mai_Attivo", tabella) == NULL &&
+        cerca_hash("Inattivo_Con", tabella) != NULL &&
+        cerca_hash("Attivo_Senza", tabella) != NULL;
+
+    // 3. Una seconda purga non trova nessuno
+    int rimossi_ancora = purga_abbonati(tabella, limite);
+    printf("Abbonati rimossi dalla seconda purga: %d (attesi 0)\n", rimossi_ancora);
+    esito = esito && rimossi_ancora == 0;
+
+    // 4. Il file salvato contiene solo i rimasti
+    salva_abbonati(tabella, "caso_test_4_abbonati.txt");
+    distruggi_hash(tabella);
+    tabella = carica_abbonati("caso_test_4_abbonati.txt");
+    printf("Abbonati dopo il salvataggio: %d (attesi 2)\n", numero_abbonati_hash(tabella));
+    esito = esito && numero_abbonati_hash(tabella) == 2 && cerca_hash("Inattivo_Senza", tabella) == NULL;
+    distruggi_hash(tabella);
+
+    registra_esito(4, esito);
+    printf("Premi INVIO per tornare al menu...");
+    getchar();
+}
+
+/* Funzione: caso_test_5
+*
+* Verifica che le modifiche agli abbonati annotate nel giornale vengano riapplicate al checkpoint
+*
+* Descrizione:
+* Parte da un checkpoint con due abbonati e nessun giornale. Dopo una ricarica, un cambio di password,
+* un nuovo abbonato e una rimozione, il checkpoint deve essere identico a prima (le modifiche
+* sono solo nel giornale, una riga ciascuna) e il registro riaperto deve contenerle tutte.
+* Dopo la compattazione con salva_abbonati il giornale deve essere vuoto e il registro invariato.
+*
+* Side-effect:
+* - Sovrascrive i file \"caso_test_5_abbonati.txt\", \"caso_test_5_abbonati.journal\" e \"caso_test_5_abbonati.bin\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_5()
+{
+    printf("\n--- TEST 5: Giornale degli abbonati ---\n");
+    printf("Modifica gli abbonati senza riscrivere il checkpoint e verifica che il giornale venga riapplicato.\n\n");
+    printf("Premi INVIO per iniziare...");
+    getchar();
+
+    // 1. Checkpoint di partenza, senza giornale né archivio
+    remove("caso_test_5_abbonati.journal");
+    remove("caso_test_5_abbonati.bin");
+    FILE *f = fopen("caso_test_5_abbonati.txt", "w");
+    if (!f) {
+        printf("Errore nella scrittura dei file di test.\nPremi INVIO per tornare al menu...");
+        getchar();
+        return;
+    }
+    fprintf(f, "Giornale_Uno;1234;2;%lld\n", (long long)time(NULL));
+    fprintf(f, "Giornale_Due;1234;0;%lld\n", (long long)time(NULL));
+    fclose(f);
+    f = fopen("caso_test_5_abbonati.txt", "r");
+    char checkpoint[2 * MASSIMO_LINEA] = "";
+    size_t letti = fread(checkpoint, 1, sizeof(checkpoint) - 1, f);
+    checkpoint[letti] = '\0';
+    fclose(f);
+
+    // 2. Modifiche annotate nel giornale
+    tabella_hash tabella = registro_abbonati("caso_test_5_abbonati.txt");
+    modifica_lezioni_abbonato(cerca_hash("Giornale_Uno", tabella), 12);
+    cambia_password_abbonato(cerca_hash("Giornale_Uno", tabella), "nuova");
+    abbonato nuovo;
+    strcpy(nuovo.nomeutente, "Giornale_Tre");
+    strcpy(nuovo.password, "1234");
+    nuovo.chiave = nuovo.nomeutente;
+    nuovo.lezioni_rimanenti = 5;
+    nuovo.ultima_attivita = time(NULL);
+    aggiungi_abbonato_registro(nuovo);
+    purga_abbonati(tabella, time(NULL) + 1); // Solo Giornale_Due non ha lezioni
+    chiudi_registro_abbonati();
+
+    // 3. Il checkpoint non è stato riscritto e il giornale ha una riga per modifica
+    f = fopen("caso_test_5_abbonati.txt", "r");
+    char dopo[2 * MASSIMO_LINEA] = "";
+    letti = f ? fread(dopo, 1, sizeof(dopo) - 1, f) : 0;
+    dopo[letti] = '\0';
+    if (f) fclose(f);
+    int righe = 0;
+    char linea[MASSIMO_LINEA];
+    f = fopen("caso_test_5_abbonati.journal", "r");
+    while (f && fgets(linea, sizeof(linea), f))
+        righe++;
+    if (f) fclose(f);
+    printf("Checkpoint invariato: %s, righe del giornale: %d (attese 4)\n", strcmp(checkpoint, dopo) == 0 ? "si" : "no", righe);
+    int esito = strcmp(checkpoint, dopo) == 0 && righe == 4;
+
+    // 4. Il registro riaperto riapplica il giornale, prima e dopo la compattazione
+    for (int passo = 0; passo < 2; passo++) {
+        tabella = registro_abbonati("caso_test_5_abbonati.txt");
+        abbonato *uno = cerca_hash("Giornale_Uno", tabella);
+        abbonato *tre = cerca_hash("Giornale_Tre", tabella);
+        int corretto = uno && uno->lezioni_rimanenti == 14 && strcmp(uno->password, "nuova") == 0 &&
+            tre && tre->lezioni_rimanenti == 5 && cerca_hash("Giornale_Due", tabella) == NULL &&
+            numero_abbonati_hash(tabella) == 2;
+        printf("%s: %s\n", passo == 0 ? "Giornale riapplicato" : "Dopo la compattazione", corretto ? "corretto" : "ERRATO");
+        esito = esito && corretto;
+        if (passo == 0)
+            salva_abbonati(tabella, "caso_test_5_abbonati.txt");
+        chiudi_registro_abbonati();
+    }
+
+    struct stat info;
+    int giornale_vuoto = stat("caso_test_5_abbonati.journal", &info) == 0 && info.st_size == 0;
+    printf("Giornale vuoto dopo la compattazione: %s\n", giornale_vuoto ? "si" : "no");
+    esito = esito && giornale_vuoto;
+
+    registra_esito(5, esito);
+    printf("Premi INVIO per tornare al menu...");
+    getchar();
+}
+
+/* Funzione: caso_test_6
+*
+* Verifica la lista d'attesa: promozione dopo una disdetta, addebito dell'abbonato e salvataggio
+*
+* Descrizione:
+* Una lezione da due posti è piena e ha in attesa, nell'ordine, un abbonato senza lezioni, un abbonato
+* con tre lezioni e due ospiti. Tolto il primo iscritto, promuovi_attesa deve saltare il primo abbonato,
+* iscrivere il secondo scalandogli una lezione e lasciare in attesa i due ospiti.
+* La lezione viene poi salvata e ricaricata: devono ritrovarsi gli stessi iscritti e la lista d'attesa
+* nello stesso ordine.
+*
+* Side-effect:
+* - Sovrascrive i file \"caso_test_6_abbonati.txt\" (con giornale e archivio) e \"caso_test_6_lezioni.txt\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_6()
+{
+    printf("\n--- TEST 6: Lista d'attesa ---\n");
+    printf("Libera un posto in una lezione piena e verifica promozione, addebito e salvataggio.\n\n");
+    printf("Premi INVIO per iniziare...");
+    getchar();
+
+    // 1. Abbonati di prova: uno senza lezioni e uno con tre lezioni
+    remove("caso_test_6_abbonati.journal");
+    remove("caso_test_6_abbonati.bin");
+    FILE *f = fopen("caso_test_6_abbonati.txt", "w");
+    if (!f) {
+        printf("Errore nella scrittura dei file di test.\nPremi INVIO per tornare al menu...");
+        getchar();
+        return;
+    }
+    fprintf(f, "Attesa_Senza;1234;0;%lld\n", (long long)time(NULL));
+    fprintf(f, "Attesa_Abbonato;1234;3;%lld\n", (long long)time(NULL));
+    fclose(f);
+    tabella_hash tabella = registro_abbonati("caso_test_6_abbonati.txt");
+
+    // 2. Lezione piena con quattro persone in attesa
+    lezione l;
+    l.inizio = inizio_lezione(istante_attuale() / SECONDI_GIORNO + 1, 0);
+    l.fascia = 0;
+    l.iscritti = nuova_pila_capienza(2);
+    l.attesa = nuova_attesa(CAPIENZA_ATTESA);
+    inserisci_pila(interna_nome("Attesa_Primo"), l.iscritti);
+    inserisci_pila(interna_nome("Attesa_Secondo"), l.iscritti);
+    const char *in_attesa[] = { "Attesa_Senza", "Attesa_Abbonato", "Attesa_Ospite_A", "Attesa_Ospite_B" };
+    for (int i = 0; i < 4; i++)
+        accoda_attesa(l.attesa, interna_nome(in_attesa[i]));
+
+    // 3. Disdetta del primo iscritto e promozione
+    rimuovi_partecipante_pila(l.iscritti, cerca_nome("Attesa_Primo"));
+    promuovi_attesa(&l, tabella);
+    abbonato *promosso = cerca_hash("Attesa_Abbonato", tabella);
+    int esito = contiene_pila(l.iscritti, cerca_nome("Attesa_Abbonato")) &&
+        !contiene_pila(l.iscritti, cerca_nome("Attesa_Senza")) &&
+        dimensione_pila(l.iscritti) == 2 && dimensione_attesa(l.attesa) == 2 &&
+        promosso->lezioni_rimanenti == 2;
+    printf("Promozione: %s (lezioni rimanenti dell'abbonato: %d, attese 2)\n", esito ? "corretta" : "ERRATA", promosso->lezioni_rimanenti);
+    chiudi_registro_abbonati();
+
+    // 4. Salvataggio e caricamento della lezione
+    coda calendario = nuova_coda();
+    inserisci_lezione(l, calendario);
+    salva_lezioni(calendario, "caso_test_6_lezioni.txt");
+    coda ricaricato = nuova_coda();
+    carica_lezioni(ricaricato, "caso_test_6_lezioni.txt");
+    lezione *letta = elemento_coda(ricaricato, 0);
+    int conservata = letta != NULL && dimensione_coda(ricaricato) == 1 &&
+        dimensione_pila(letta->iscritti) == dimensione_pila(l.iscritti) &&
+        dimensione_attesa(letta->attesa) == dimensione_attesa(l.attesa);
+    for (int i = 0; conservata && i < dimensione_pila(l.iscritti); i++)
+        conservata = contiene_pila(letta->iscritti, elemento_pila(l.iscritti, i));
+    for (int i = 0; conservata && i < dimensione_attesa(l.attesa); i++)
+        conservata = elemento_attesa(letta->attesa, i) == elemento_attesa(l.attesa, i);
+    printf("Iscritti e lista d'attesa dopo il salvataggio: %s\n", conservata ? "conservati" : "ERRATI");
+    esito = esito && conservata;
+
+    libera_calendario(ricaricato);
+    rimuovi_lezione(calendario);
+    distruggi_coda(calendario);
+    distruggi_pila(l.iscritti);
+    distruggi_attesa(l.attesa);
+
+    registra_esito(6, esito);
+    printf("Premi INVIO per tornare al menu...");
+    getchar();
+}
+
+/* Funzione: caso_test_7
+*
+* Verifica che le disdette lascino invariato l'ordine degli altri iscritti, in memoria e nel file salvato
+*
+* Descrizione:
+* Sei iscritti, da Ordine_A (fondo) a Ordine_F (cima). Togliendo Ordine_C e Ordine_E restano due
+* posizioni cancellate su sei, sotto la soglia di compattazione: letture e salvataggio devono
+* saltarle senza modificare la pila (due letture consecutive danno lo stesso risultato e cerca_pila
+* restituisce distanze coerenti con elemento_pila). Togliendo anche Ordine_A la pila viene compattata
+* e l'ordine deve restare lo stesso.
+*
+* Side-effect:
+* - Sovrascrive il file \"caso_test_7_lezioni.txt\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_7()
+{
+    printf("\n--- TEST 7: Ordine degli iscritti dopo le disdette ---\n");
+    printf("Toglie alcuni iscritti da una lezione e verifica l'ordine letto e salvato.\n\n");
+    printf("Premi INVIO per iniziare...");
+    getchar();
+
+    pila iscritti = nuova_pila_capienza(CAPIENZA_LEZIONE);
+    const char *nomi[] = { "Ordine_A", "Ordine_B", "Ordine_C", "Ordine_D", "Ordine_E", "Ordine_F" };
+    for (int i = 0; i < 6; i++)
+        inserisci_pila(interna_nome(nomi[i]), iscritti);
+
+    // 1. Due disdette: restano posizioni cancellate
+    rimuovi_partecipante_pila(iscritti, cerca_nome("Ordine_C"));
+    rimuovi_partecipante_pila(iscritti, cerca_nome("Ordine_E"));
+    const char *dopo_due[] = { "Ordine_F", "Ordine_D", "Ordine_B", "Ordine_A" };
+    int esito = ordine_salvato(iscritti, "caso_test_7_lezioni.txt", dopo_due, 4) &&
+        ordine_salvato(iscritti, "caso_test_7_lezioni.txt", dopo_due, 4) &&
+        cerca_pila(iscritti, cerca_nome("Ordine_B")) == 2 && cerca_pila(iscritti, cerca_nome("Ordine_C")) == -1;
+    printf("Dopo due disdette: %s\n", esito ? "ordine conservato" : "ordine ERRATO");
+
+    // 2. Terza disdetta: la pila viene compattata
+    rimuovi_partecipante_pila(iscritti, cerca_nome("Ordine_A"));
+    const char *dopo_tre[] = { "Ordine_F", "Ordine_D", "Ordine_B" };
+    int compattata = ordine_salvato(iscritti, "caso_test_7_lezioni.txt", dopo_tre, 3) &&
+        cerca_pila(iscritti, cerca_nome("Ordine_B")) == 2;
+    printf("Dopo la compattazione: %s\n", compattata ? "ordine conservato" : "ordine ERRATO");
+    esito = esito && compattata;
+
+    distruggi_pila(iscritti);
+    registra_esito(7, esito);
+    printf("Premi INVIO per tornare al menu...");
+    getchar();
+}
+
+/* Funzione: caso_test_8
+*
+* Verifica che il calendario resti ordinato per inizio con inserimenti fuori ordine e che cerca_lezione
+* trovi sempre la lezione giusta, anche con più lezioni dallo stesso inizio
+*
+* Descrizione:
+* Inserisce dieci lezioni, una al giorno, in ordine sparso, poi altre due con l'inizio del quarto e
+* dell'ottavo giorno. Le lezioni si riconoscono dalla pila degli iscritti, diversa per ognuna.
+* Dopo gli inserimenti e dopo ogni rimozione dalla testa il calendario deve essere ordinato
+* (le lezioni dallo stesso inizio nell'ordine di inserimento) e cerca_lezione deve restituire,
+* per ogni inizio, la prima lezione rimasta con quell'inizio (vedi calendario_coerente).
+*
+* Side-effect:
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_8()
+{
+    printf("\n--- TEST 8: Ordine del calendario e ricerca delle lezioni ---\n");
+    printf("Inserisce lezioni fuori ordine, anche con lo stesso inizio, e verifica ordine e ricerche.\n\n");
+    printf("Premi INVIO per iniziare...");
+    getchar();
+
+    const int giorni[] = { 6, 2, 9, 0, 4, 7, 1, 8, 3, 5, 3, 7 };
+    const int numero = sizeof(giorni) / sizeof(giorni[0]);
+    int64_t primo_giorno = istante_attuale() / SECONDI_GIORNO + 1;
+    lezione inserite[sizeof(giorni) / sizeof(giorni[0])];
+    coda calendario = nuova_coda();
+    for (int i = 0; i < numero; i++) {
+        inserite[i].inizio = inizio_lezione(primo_giorno + giorni[i], 0);
+        inserite[i].fascia = 0;
+        inserite[i].iscritti = nuova_pila_capienza(CAPIENZA_LEZIONE);
+        inserite[i].attesa = nuova_attesa(CAPIENZA_ATTESA);
+        inserisci_lezione(inserite[i], calendario);
+    }
+
+    int esito = dimensione_coda(calendario) == numero && calendario_coerente(calendario, inserite, numero);
+    printf("Dopo gli inserimenti: %s\n", esito ? "ordinato, ricerche corrette" : "ERRATO");
+
+    // Rimozioni dalla testa: le lezioni dallo stesso inizio devono restare raggiungibili
+    int rimozioni_corrette = 1;
+    while (!coda_vuota(calendario)) {
+        lezione tolta = rimuovi_lezione(calendario);
+        for (int i = 0; i < numero; i++) {
+            if (inserite[i].iscritti == tolta.iscritti)
+                inserite[i].iscritti = NULL; // Segna la lezione come tolta
+        }
+        distruggi_pila(tolta.iscritti);
+        distruggi_attesa(tolta.attesa);
+        rimozioni_corrette = rimozioni_corrette && calendario_coerente(calendario, inserite, numero);
+    }
+    printf("Dopo le rimozioni dalla testa: %s\n", rimozioni_corrette ? "ricerche corrette" : "ERRATE");
+    esito = esito && rimozioni_corrette;
+    distruggi_coda(calendario);
+
+    registra_esito(8, esito);
+    printf("Premi INVIO per tornare al menu...");
+    getchar();
+}
+
+/* Funzione: caso_test_9
+*
+* Verifica che l'ultimo giorno generato sopravviva a salvataggio e caricamento tramite la riga \"generate;gg/mm/aaaa\"
+*
+* Descrizione:
+* Genera le lezioni dei prossimi giorni e le salva: la prima riga del file deve riportare l'ultimo giorno
+* generato. Ricaricato il file, il calendario deve avere lo stesso giorno generato e le stesse lezioni;
+* tolta la prima lezione, una nuova generazione non deve ricrearla e un giorno precedente non deve
+* far tornare indietro quello registrato. Lo stesso file senza la prima riga, come quelli salvati
+* prima che esistesse, deve caricarsi con tutte le lezioni e senza giorno generato.
+*
+* Side-effect:
+* - Sovrascrive i file \"caso_test_9_lezioni.txt\" e \"caso_test_9_senza_riga.txt\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_9()
+{
+    printf("\n--- TEST 9: Giorno generato nel file delle lezioni ---\n");
+    printf("Salva e ricarica le lezioni generate e verifica che non vengano generate di nuovo.\n\n");
+    printf("Premi INVIO per iniziare...");
+    getchar();
+
+    // 1. Generazione e salvataggio
+    coda generato = nuova_coda();
+    genera_lezioni(generato);
+    int64_t ultimo = giorno_generato(generato);
+    int numero_lezioni = dimensione_coda(generato);
+    salva_lezioni(generato, "caso_test_9_lezioni.txt");
+    libera_calendario(generato);
+
+    char attesa[MASSIMO_LINEA];
+    char data[11];
+    scrivi_data(ultimo * SECONDI_GIORNO, data);
+    snprintf(attesa, sizeof(attesa), "generate;%s\n", data);
+    char linea[MASSIMO_LINEA] = "";
+    FILE *f = fopen("caso_test_9_lezioni.txt", "r");
+    FILE *senza_riga = fopen("caso_test_9_senza_riga.txt", "w");
+    if (f == NULL || senza_riga == NULL || !fgets(linea, sizeof(linea), f)) {
+        if (f) fclose(f);
+        if (senza_riga) fclose(senza_riga);
+        printf("Errore nella lettura o scrittura dei file di test.\nPremi INVIO per tornare al menu...");
+        getchar();
+        return;
+    }
+    int esito = strcmp(linea, attesa) == 0;
+    printf("Prima riga del file: %s", linea);
+
+    // Copia delle righe delle lezioni, senza la riga del giorno generato
+    while (fgets(linea, sizeof(linea), f))
+        fputs(linea, senza_riga);
+    fclose(f);
+    fclose(senza_riga);
+
+    // 2. Caricamento: stesso giorno generato, stesse lezioni, nessuna lezione ricreata
+    coda ricaricato = nuova_coda();
+    carica_lezioni(ricaricato, "caso_test_9_lezioni.txt");
+    int caricato = giorno_generato(ricaricato) == ultimo && dimensione_coda(ricaricato) == numero_lezioni;
+    lezione tolta = rimuovi_lezione(ricaricato);
+    distruggi_pila(tolta.iscritti);
+    distruggi_attesa(tolta.attesa);
+    genera_lezioni(ricaricato);
+    segna_giorno_generato(ricaricato, ultimo - 5);
+    caricato = caricato && dimensione_coda(ricaricato) == numero_lezioni - 1 && giorno_generato(ricaricato) == ultimo;
+    printf("Giorno generato dopo il caricamento: %s\n", caricato ? "conservato, nessuna lezione ricreata" : "ERRATO");
+    esito = esito && caricato;
+    libera_calendario(ricaricato);
+
+    // 3. File senza la riga del giorno generato
+    coda vecchio = nuova_coda();
+    carica_lezioni(vecchio, "caso_test_9_senza_riga.txt");
+    int compatibile = giorno_generato(vecchio) == NESSUN_GIORNO_GENERATO && dimensione_coda(vecchio) == numero_lezioni;
+    printf("File senza la riga: %s\n", compatibile ? "caricato senza giorno generato" : "ERRATO");
+    esito = esito && compatibile;
+    libera_calendario(vecchio);
+
+    registra_esito(9, esito);
+    printf("Premi INVIO per tornare al menu...");
+    getchar();
+}
+
+/* Funzione: libera_calendario
+*
+* Toglie tutte le lezioni dal calendario, liberandone iscritti e lista d'attesa, poi libera il calendario
+*/
+static void libera_calendario(coda calendario)
+{
+    while (!coda_vuota(calendario)) {
+        lezione tolta = rimuovi_lezione(calendario);
+        distruggi_pila(tolta.iscritti);
+        distruggi_attesa(tolta.attesa);
+    }
+    distruggi_coda(calendario);
+}
+
+/* Funzione: calendario_coerente
+*
+* Controlla ordine e ricerche del calendario rispetto alle lezioni inserite
+*
+* Descrizione:
+* Le lezioni ancora nel calendario sono quelle di 'inserite' con la pila degli iscritti diversa da NULL.
+* Il calendario deve contenerle tutte, ordinate per inizio e, a parità di inizio, nell'ordine
+* di 'inserite'; per ognuna cerca_lezione deve restituire la prima rimasta con il suo inizio.
+*
+* Post-condizione:
+* Restituisce 1 se il calendario è coerente, altrimenti 0
+*/
+static int calendario_coerente(coda calendario, lezione inserite[], int numero_inserite)
+{
+    int rimaste = 0;
+    for (int i = 0; i < numero_inserite; i++) {
+        if (inserite[i].iscritti == NULL)
+            continue;
+        rimaste++;
+
+        // La prima rimasta con lo stesso inizio, in ordine di inserimento
+        int prima = i;
+        for (int j = 0; j < i; j++) {
+            if (inserite[j].iscritti != NULL && inserite[j].inizio == inserite[i].inizio) {
+                prima = j;
+                break;
+            }
+        }
+        lezione *trovata = cerca_lezione(calendario, inserite[i].inizio);
+        if (trovata == NULL || trovata->iscritti != inserite[prima].iscritti)
+            return 0;
+    }
+    if (dimensione_coda(calendario) != rimaste)
+        return 0;
+
+    for (int n = 1; n < rimaste; n++) {
+        lezione *precedente = elemento_coda(calendario, n - 1);
+        lezione *corrente = elemento_coda(calendario, n);
+        if (precedente->inizio > corrente->inizio)
+            return 0;
+
+        // A parità di inizio la precedente deve essere stata inserita prima
+        if (precedente->inizio == corrente->inizio) {
+            int ordine_precedente = -1, ordine_corrente = -1;
+            for (int i = 0; i < numero_inserite; i++) {
+                if (inserite[i].iscritti == precedente->iscritti)
+                    ordine_precedente = i;
+                if (inserite[i].iscritti == corrente->iscritti)
+                    ordine_corrente = i;
+            }
+            if (ordine_precedente > ordine_corrente)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+/* Funzione: ordine_salvato
+*
+* Controlla che la pila contenga gli iscritti attesi, dalla cima al fondo, sia letta con elemento_pila
+* sia salvata su file con salva_lezioni
+*
+* Descrizione:
+* La pila viene prestata a una lezione di un calendario di appoggio, salvata su nome_file
+* e poi tolta dal calendario, che viene liberato senza toccarla.
+*
+* Post-condizione:
+* Restituisce 1 se entrambi gli ordini coincidono con 'attesi', altrimenti 0
+*/
+static int ordine_salvato(pila iscritti, const char *nome_file, const char *attesi[], int numero_attesi)
+{
+    int corretto = dimensione_pila(iscritti) == numero_attesi;
+    for (int i = 0; corretto && i < numero_attesi; i++)
+        corretto = elemento_pila(iscritti, i) == cerca_nome(attesi[i]);
+
+    lezione l;
+    l.inizio = inizio_lezione(istante_attuale() / SECONDI_GIORNO + 1, 0);
+    l.fascia = 0;
+    l.iscritti = iscritti;
+    l.attesa = nuova_attesa(CAPIENZA_ATTESA);
+    coda calendario = nuova_coda();
+    inserisci_lezione(l, calendario);
+    salva_lezioni(calendario, nome_file);
+    rimuovi_lezione(calendario);
+    distruggi_coda(calendario);
+    distruggi_attesa(l.attesa);
+
+    // La prima riga descrive la lezione, le successive sono gli iscritti
+    FILE *f = fopen(nome_file, "r");
+    char linea[MASSIMO_LINEA];
+    if (f == NULL || !fgets(linea, sizeof(linea), f))
+        corretto = 0;
+    for (int i = 0; corretto && i < numero_attesi; i++) {
+        corretto = fgets(linea, sizeof(linea), f) != NULL;
+        if (corretto) {
+            linea[strcspn(linea, "\n")] = 0;
+            corretto = strcmp(linea, attesi[i]) == 0;
+        }
+    }
+    if (f) fclose(f);
+    return corretto;
+}
+
+/* Funzione: registra_esito
+*
+* Stampa l'esito di un caso di test e lo aggiunge ai file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+static void registra_esito(int numero, int esito)
+{
+    printf("RISULTATO TEST %d: %s\n", numero, esito ? "PASSATO" : "FALLIMENTO");
+
+    FILE *res = fopen("esiti_test.txt", "a");
+    if (res) {
+        fprintf(res, "Caso Test %d: %s\n", numero, esito ? "PASSATO" : "FALLIMENTO");
+        fclose(res);
+    }
+
+    FILE *elenco = fopen("elenco_test.txt", "a");
+    if (elenco) {
+        fprintf(elenco, "Caso Test %d: %s\n", numero, esito ? "PASSATO" : "FALLIMENTO");
+        fclose(elenco);
+    }
+}
@@ -98,4 +98,94 @@ void caso_test_2();
 * - Aggiorna i file di output e oracle
 * - Esegue il report mensile e scrive l’esito nei file \"esiti_test.txt\" e \"elenco_test.txt\"
 */
-void caso_test_3(coda calendario);
\ No newline at end of file
+void caso_test_3(coda calendario);
+
+/* Funzione: caso_test_4
+*
+* Verifica la rimozione degli abbonati senza lezioni e inattivi
+*
+* Descrizione:
+* La funzione scrive un file con quattro abbonati, di cui due senza lezioni e inattivi da prima
+* del limite di GIORNI_INATTIVITA giorni, esegue purga_abbonati e controlla che siano stati rimossi
+* solo quei due, anche dopo aver salvato e ricaricato il file.
+*
+* Side-effect:
+* - Sovrascrive il file \"caso_test_4_abbonati.txt\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_4();
+
+/* Funzione: caso_test_5
+*
+* Verifica che le modifiche agli abbonati annotate nel giornale vengano riapplicate al checkpoint
+*
+* Descrizione:
+* La funzione carica il registro da un checkpoint di prova, ricarica un abbonato, ne cambia la password,
+* aggiunge e rimuove abbonati, poi chiude il registro e lo riapre: il checkpoint non deve essere
+* stato riscritto e le modifiche devono essere ritrovate riapplicando il giornale.
+* Infine salva_abbonati compatta il giornale nel checkpoint senza perdere nulla.
+*
+* Side-effect:
+* - Sovrascrive i file \"caso_test_5_abbonati.txt\", \"caso_test_5_abbonati.journal\" e \"caso_test_5_abbonati.bin\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_5();
+
+/* Funzione: caso_test_6
+*
+* Verifica la lista d'attesa: promozione dopo una disdetta, addebito dell'abbonato e salvataggio
+*
+* Descrizione:
+* La funzione riempie una lezione, mette in attesa un abbonato senza lezioni, un abbonato con lezioni
+* e due ospiti, poi libera un posto: deve essere promosso l'abbonato con lezioni, pagando una lezione.
+* Salva e ricarica la lezione e controlla gli iscritti e l'ordine della lista d'attesa.
+*
+* Side-effect:
+* - Sovrascrive i file \"caso_test_6_abbonati.txt\" (con giornale e archivio) e \"caso_test_6_lezioni.txt\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_6();
+
+/* Funzione: caso_test_7
+*
+* Verifica che le disdette lascino invariato l'ordine degli altri iscritti, in memoria e nel file salvato
+*
+* Descrizione:
+* La funzione toglie due iscritti da una lezione di sei, senza far scattare la compattazione,
+* e poi un terzo, che la fa scattare; ogni volta salva la lezione e confronta l'ordine letto
+* con elemento_pila e quello scritto nel file con l'ordine atteso.
+*
+* Side-effect:
+* - Sovrascrive il file \"caso_test_7_lezioni.txt\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_7();
+
+/* Funzione: caso_test_8
+*
+* Verifica che il calendario resti ordinato per inizio con inserimenti fuori ordine e che cerca_lezione
+* trovi sempre la lezione giusta, anche con più lezioni dallo stesso inizio
+*
+* Descrizione:
+* La funzione inserisce lezioni in ordine sparso, più due lezioni con l'inizio di lezioni già presenti,
+* controlla l'ordine e le ricerche, poi toglie le lezioni dalla testa una alla volta controllando
+* a ogni passo che le lezioni rimaste siano ancora trovate.
+*
+* Side-effect:
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_8();
+
+/* Funzione: caso_test_9
+*
+* Verifica che l'ultimo giorno generato sopravviva a salvataggio e caricamento tramite la riga \"generate;gg/mm/aaaa\"
+*
+* Descrizione:
+* La funzione genera le lezioni, le salva e le ricarica, controlla il giorno generato e che una nuova
+* generazione non ricrei una lezione tolta; un file senza la riga deve caricarsi senza giorno generato.
+*
+* Side-effect:
+* - Sovrascrive i file \"caso_test_9_lezioni.txt\" e \"caso_test_9_senza_riga.txt\"
+* - Scrive l’esito del test nei file \"esiti_test.txt\" e \"elenco_test.txt\"
+*/
+void caso_test_9();
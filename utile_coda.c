@@ -5,22 +5,15 @@
 #include "coda.h"
 #include "hash.h"
 #include "lezione.h"
+#include "nomi.h"
 #include "utile_coda.h"
 #include "utile_hash.h"
 
-// Nodo della coda
-struct nodo
-{
-	lezione valore;
-	struct nodo *prossimo;
-};
+#define GIORNI_GENERATI 30 // Giorni, a partire da oggi, per cui genera_lezioni prepara le lezioni
+#define RIGA_GENERATO "generate" // Inizio della riga del file delle lezioni con il giorno generato
+#define PRENOTAZIONI_ELENCATE 64 // Iscrizioni mostrate da stampa_prenotazioni; le altre vengono solo contate
 
-// Struttura della coda
-struct c_coda
-{
-	struct nodo *testa,*coda;
-	int numel;
-};
+static void scrivi_iscritto(partecipante persona, void *file);
 
 /* Funzione: carica_lezioni
 *
@@ -28,9 +21,20 @@ struct c_coda
 *
 * Descrizione:
 * La funzione apre il file indicato in modalità lettura e scrittura.
-* Per ogni lezione trovata nel file legge la data, il giorno, l'orario e il numero di iscritti.
-* Crea una nuova pila per gli iscritti e li inserisce uno alla volta leggendo righe successive.
+* Per ogni lezione trovata nel file legge la data, il giorno, l'orario, il numero di iscritti
+* e, se presenti, la capienza (altrimenti CAPIENZA_LEZIONE, come nei file salvati prima che esistesse)
+* e il numero di partecipanti in lista d'attesa, elencati subito dopo gli iscritti.
+* Legge le righe successive con gli iscritti, registrando ogni nome con interna_nome (chi frequenta
+* molte lezioni viene copiato una sola volta), e raccoglie gli identificativi in un blocco riusato
+* da una lezione all'altra; crea poi una pila con quella capienza e la riempie con un solo
+* inserisci_blocco_pila. Se il file elenca più iscritti della capienza, la capienza viene alzata
+* per non perderne nessuno.
+* Data e orario vengono convertiti subito nell'istante di inizio e nella fascia (leggi_inizio):
+* le lezioni con una data inesistente o un orario sconosciuto vengono scartate.
 * Alla fine, inserisce la lezione completa nella coda calendario.
+* La riga RIGA_GENERATO, scritta da salva_lezioni prima delle lezioni, riporta l'ultimo giorno
+* con le lezioni già generate, che viene registrato nel calendario (segna_giorno_generato);
+* i file che non la contengono si caricano come prima.
 * Se il file non esiste, viene creato automaticamente.
 *
 * Parametri:
@@ -58,30 +62,89 @@ void carica_lezioni(coda calendario, const char *nome_file)
 	rewind(fp); // Torna all'inizio del file
 
 	char linea[256]; // Buffer per la lettura delle righe
+	partecipante *blocco = NULL; // Iscritti della lezione corrente, passati alla pila in un'unica chiamata
+	int allocati_blocco = 0;
 
 	// Legge il file riga per riga
 	while (fgets(linea, sizeof(linea), fp))
 	{
 		lezione l;
+		char data[11], giorno[20], orario[20];
 		int numero_iscritti;
+		int capienza = CAPIENZA_LEZIONE;
+		int numero_attesa = 0;
+		int64_t generato;
+
+		// Riga con l'ultimo giorno generato: non ha i quattro campi di una lezione
+		if (sscanf(linea, RIGA_GENERATO ";%10[^;\n]", data) == 1)
+		{
+			if (leggi_giorno(data, &generato))
+				segna_giorno_generato(calendario, generato);
+			continue;
+		}
 
-        	if (sscanf(linea, "%[^;];%[^;];%[^;];%d", l.data, l.giorno, l.orario, &numero_iscritti) == 4)
+        	if (sscanf(linea, "%10[^;];%19[^;];%19[^;];%d;%d;%d", data, giorno, orario,
+			&numero_iscritti, &capienza, &numero_attesa) >= 4)
 		{
-        		l.iscritti = nuova_pila(); // Inizializza la pila degli iscritti
+			// Data e orario diventano un istante una volta sola; il giorno si ricava dalla data
+			l.inizio = leggi_inizio(data, orario, &l.fascia);
 
+			if (capienza < numero_iscritti)
+				capienza = numero_iscritti;
+			if (capienza < 1)
+				capienza = CAPIENZA_LEZIONE;
+
+			// Fa crescere il blocco se la lezione ha più iscritti di quelle lette finora
+			if (numero_iscritti > allocati_blocco)
+			{
+				partecipante *nuovo = realloc(blocco, numero_iscritti * sizeof(partecipante));
+				if (nuovo == NULL)
+				{
+					perror("Errore allocazione iscritti");
+					break;
+				}
+				blocco = nuovo;
+				allocati_blocco = numero_iscritti;
+			}
+
+			// Legge tutti gli iscritti della lezione
+			int letti = 0;
         		for (int i = 0; i < numero_iscritti; i++)
 			{
                 		if (fgets(linea, sizeof(linea), fp))
 				{
                 			linea[strcspn(linea, "\n")] = 0;
-                			inserisci_pila(linea, l.iscritti);
+                			partecipante p = interna_nome(linea);
+                			if (p != NESSUN_PARTECIPANTE)
+                				blocco[letti++] = p;
         			}
             		}
 
+        		l.iscritti = nuova_pila_capienza(capienza); // Inizializza la pila degli iscritti
+        		inserisci_blocco_pila(l.iscritti, blocco, letti);
+        		l.attesa = nuova_attesa(numero_attesa > CAPIENZA_ATTESA ? numero_attesa : CAPIENZA_ATTESA);
+
+        		for (int i = 0; i < numero_attesa; i++)
+			{
+                		if (fgets(linea, sizeof(linea), fp))
+				{
+                			linea[strcspn(linea, "\n")] = 0;
+                			accoda_attesa(l.attesa, interna_nome(linea));
+        			}
+            		}
+
+			// Una lezione con data o orario non validi viene letta per intero ma scartata
+			if (l.inizio == NESSUN_INIZIO)
+			{
+				distruggi_pila(l.iscritti);
+				distruggi_attesa(l.attesa);
+				continue;
+			}
         		inserisci_lezione(l, calendario); // Inserisce la lezione nella coda
         	}
 	}
 
+    free(blocco);
     fclose(fp); // Chiude il file
 }
 
@@ -91,9 +154,13 @@ void carica_lezioni(coda calendario, const char *nome_file)
 *
 * Descrizione:
 * La funzione salva tutte le lezioni contenute nella coda 'calendario' in un file.
-* Ogni lezione viene scritta con data, giorno, orario e numero di iscritti.
-* Gli iscritti vengono temporaneamente estratti dalla pila per essere scritti su file,
-* quindi la pila originale viene ripristinata mantenendo intatto l’ordine.
+* Se genera_lezioni ha già preparato delle lezioni, la prima riga riporta l'ultimo giorno
+* generato (RIGA_GENERATO;gg/mm/aaaa), così al riavvio non vengono generate di nuovo.
+* Ogni lezione viene scritta con data, giorno, orario, numero di iscritti, capienza e numero in attesa.
+* Gli iscritti vengono letti sul posto con visita_pila, dalla cima verso il fondo,
+* senza pile di appoggio: una sola passata salta le posizioni lasciate dalle disdette senza
+* toccare la pila; seguono i partecipanti in lista d'attesa,
+* dal primo all'ultimo, così il caricamento ne conserva l'ordine.
 *
 * Parametri:
 * calendario: la coda contenente le lezioni da salvare.
@@ -105,8 +172,7 @@ void carica_lezioni(coda calendario, const char *nome_file)
 *
 * Side-effect:
 * - Apre il file in modalità scrittura.
-* - Estrae temporaneamente gli iscritti dalle pile per scriverli su file.
-* - Ripristina le pile originali degli iscritti al termine della scrittura.
+* - Scrive su file tutte le lezioni e i relativi iscritti.
 */
 void salva_lezioni(coda calendario, const char *nome_file)
 {
@@ -120,39 +186,35 @@ void salva_lezioni(coda calendario, const char *nome_file)
         	return;
     	}
 
-	// Scorre tutta la coda
-    	struct nodo *corrente = calendario->testa; 
-    	while (corrente != NULL)
+	if (giorno_generato(calendario) != NESSUN_GIORNO_GENERATO)
 	{
-        	fprintf(fp, "%s;%s;%s;%d\n", 
-            	corrente->valore.data,
-            	corrente->valore.giorno,
-            	corrente->valore.orario,
-            	dimensione_pila(corrente->valore.iscritti));
-
-        	pila iscritti_tmp = nuova_pila(); // Crea una pila temporanea per invertire l'ordine
-        	partecipante p;
-
-		// Estrai tutti gli iscritti dalla pila originale
-        	while (!pila_vuota(corrente->valore.iscritti)) 
-		{
-            		if (estrai_pila(corrente->valore.iscritti, p))
-			{
-                		fprintf(fp, "%s\n", p); // Scrivi l'iscritto sul file
-                		inserisci_pila(p, iscritti_tmp); // Inserisci nella pila temporanea
-            		}
-        	}
-
-        	// Ripristina la pila originale
-        	while (!pila_vuota(iscritti_tmp))
-		{
-            		if (estrai_pila(iscritti_tmp, p))
-			{
-                		inserisci_pila(p, corrente->valore.iscritti);
-            		}
-        	}
+		char data[11];
+		scrivi_data(giorno_generato(calendario) * SECONDI_GIORNO, data);
+		fprintf(fp, "%s;%s\n", RIGA_GENERATO, data);
+	}
 
-        	corrente = corrente->prossimo; // Passa alla prossima lezione
+	// Scorre tutta la coda
+    	int numero_lezioni = dimensione_coda(calendario);
+    	for (int n = 0; n < numero_lezioni; n++)
+	{
+        	lezione *corrente = elemento_coda(calendario, n);
+        	char data[11];
+        	scrivi_data(corrente->inizio, data);
+        	fprintf(fp, "%s;%s;%s;%d;%d;%d\n", 
+            	data,
+            	nome_giorno(corrente->inizio),
+            	orario_fascia(corrente->fascia),
+            	dimensione_pila(corrente->iscritti),
+            	capienza_pila(corrente->iscritti),
+            	dimensione_attesa(corrente->attesa));
+
+		// Scrive gli iscritti dalla cima della pila verso il fondo
+        	visita_pila(corrente->iscritti, scrivi_iscritto, fp);
+
+		// Scrive la lista d'attesa dal primo all'ultimo
+        	int numero_attesa = dimensione_attesa(corrente->attesa);
+        	for (int i = 0; i < numero_attesa; i++)
+            		fprintf(fp, "%s\n", nome_partecipante(elemento_attesa(corrente->attesa, i)));
     	}
 
     	fclose(fp);
@@ -165,47 +227,34 @@ void salva_lezioni(coda calendario, const char *nome_file)
 * Descrizione:
 * La funzione controlla se il valore del giorno della settimana corrisponde
 * a uno dei giorni in cui sono previste lezioni.
-* Se il giorno è valido copia il nome del giorno e la fascia oraria corrispondente
-* nelle stringhe passate come parametri, e assegna l’ora di inizio.
+* Se il giorno è valido assegna la fascia oraria corrispondente (vedi orario_fascia).
 * Restituisce 1 se il giorno è valido, altrimenti 0.
 *
 * Parametri:
 * giorno_settimana: intero rappresentante il giorno della settimana (0 = Domenica, 6 = Sabato)
-* giorno: stringa (allocata dall'esterno) dove verrà salvato il nome del giorno (es. "Lunedi")
-* orario: stringa (allocata dall'esterno) dove verrà salvata la fascia oraria della lezione (es. "10-12")
-* ora_inizio: puntatore a intero dove viene salvata l'ora di inizio della lezione
+* fascia: puntatore a intero dove viene salvata la fascia oraria della lezione
 *
 * Pre-condizione:
-* - Le stringhe 'giorno' e 'orario' devono essere allocate con dimensione sufficiente (almeno 10 caratteri).
-* - 'ora_inizio' deve essere un puntatore valido.
+* - 'fascia' deve essere un puntatore valido.
 *
 * Post-condizione:
-* - Se il giorno è valido per una lezione, restituisce 1 e riempie le stringhe giorno e orario, 
-*   e imposta 'ora_inizio', altrimenti restituisce 0.
+* - Se il giorno è valido per una lezione, restituisce 1 e imposta 'fascia', altrimenti restituisce 0.
 */
-int giorno_lezione(int giorno_settimana, char *giorno, char *orario, int *ora_inizio)
+int giorno_lezione(int giorno_settimana, int *fascia)
 {
 	switch (giorno_settimana)
     	{
         	case 1: // Lunedì
-            		strcpy(giorno, "Lunedi");
-            		strcpy(orario, "10-12");
-            		*ora_inizio = 10;
+            		*fascia = 0; // 10-12
             		return 1;
         	case 3: // Mercoledì
-            		strcpy(giorno, "Mercoledi");
-            		strcpy(orario, "16-18");
-            		*ora_inizio = 16;
+            		*fascia = 1; // 16-18
             		return 1;
         	case 5: // Venerdì
-            		strcpy(giorno, "Venerdi");
-            		strcpy(orario, "16-18");
-            		*ora_inizio = 16;
+            		*fascia = 1; // 16-18
             		return 1;
         	case 6: // Sabato
-            		strcpy(giorno, "Sabato");
-            		strcpy(orario, "10-12");
-            		*ora_inizio = 10;
+            		*fascia = 0; // 10-12
             		return 1;
         	default:
             		return 0;
@@ -217,10 +266,12 @@ int giorno_lezione(int giorno_settimana, char *giorno, char *orario, int *ora_in
 * Genera e aggiunge alla coda calendario le lezioni previste nei prossimi 30 giorni, evitando duplicati.
 *
 * Descrizione:
-* La funzione analizza i prossimi 30 giorni a partire dalla data odierna.
-* Per ciascun giorno verifica se è previsto lo svolgimento di una lezione (Lunedì, Mercoledì, Venerdì, Sabato).
-* Se il giorno è valido e non è già presente una lezione con la stessa data e orario nella coda,
-* crea una nuova lezione vuota (senza iscritti) e la inserisce nel calendario.
+* La funzione considera i prossimi GIORNI_GENERATI giorni a partire dalla data odierna,
+* saltando quelli fino al giorno già generato del calendario (giorno_generato): di solito
+* sono tutti già generati e la funzione termina senza lavoro. Al termine registra l'ultimo giorno.
+* Per ciascun giorno rimasto verifica se è previsto lo svolgimento di una lezione (Lunedì, Mercoledì, Venerdì, Sabato).
+* Se il giorno è valido e non è già presente una lezione con la stessa data e orario nella coda
+* (controllo in tempo costante con cerca_lezione), crea una nuova lezione vuota (senza iscritti) con CAPIENZA_LEZIONE posti e la inserisce nel calendario.
 *
 * Parametri:
 * - calendario: la coda dove inserire le nuove lezioni generate.
@@ -229,60 +280,44 @@ int giorno_lezione(int giorno_settimana, char *giorno, char *orario, int *ora_in
 * - 'calendario' deve essere una coda inizializzata, eventualmente già contenente lezioni caricate da file.
 *
 * Side-effect:
-* - Analizza le prossime 30 date a partire da oggi.
+* - Analizza le date non ancora generate tra oggi e i prossimi 30 giorni.
 * - Verifica i giorni validi per le lezioni.
 * - Controlla la presenza di duplicati nella coda.
 * - Alloca dinamicamente nuove lezioni da inserire nella coda.
+* - Aggiorna il giorno generato del calendario.
 */
 void genera_lezioni(coda calendario)
 {
-	// Ottiene la data corrente
-	time_t t = time(NULL);
-	struct tm oggi = *localtime(&t);
-
-	// Itera sui prossimi 30 giorni
-	for (int i = 0; i < 30; i++)
-	{
-		// Calcola la data del giorno i-esimo
-        	struct tm temp = oggi;
-        	temp.tm_mday += i;
-        	mktime(&temp); // Normalizza la data
+	// Ottiene il giorno corrente, contato come in giorno_civile
+	int64_t oggi = istante_attuale() / SECONDI_GIORNO;
+	int64_t ultimo = oggi + GIORNI_GENERATI - 1;
 
-        	char data[11];
-        	char giorno[20];
-        	char orario[20];
+	// Parte dal giorno dopo l'ultimo già generato, se è successivo a oggi
+	int64_t primo = oggi;
+	if (giorno_generato(calendario) != NESSUN_GIORNO_GENERATO && giorno_generato(calendario) >= oggi)
+		primo = giorno_generato(calendario) + 1;
 
+	// Itera sui giorni non ancora generati
+	for (int64_t giorno = primo; giorno <= ultimo; giorno++)
+	{
 		// Verifica se il giorno è valido per le lezioni
-		int ora_inizio;
-		if (giorno_lezione(temp.tm_wday, giorno, orario, &ora_inizio))
+		int fascia;
+		if (giorno_lezione(giorno_della_settimana(giorno), &fascia))
 		{
-            		strftime(data, sizeof(data), "%d/%m/%Y", &temp); // Formatta la data come stringa
-
-            		// Controlla se esiste già una lezione in questa data e orario
-            		struct nodo *corrente = calendario->testa;
-            		int trovata = 0;
-            		while (corrente != NULL)
-			{
-                		if (strcmp(corrente->valore.data, data) == 0 && strcmp(corrente->valore.orario, orario) == 0)
-				{
-                    			trovata = 1;
-                    			break;
-                		}
-                		corrente = corrente->prossimo;
-            		}
-
-			// Se non esiste, crea la nuova lezione
-            		if (!trovata)
+            		// Se non esiste già una lezione in questa data e orario, la crea
+            		int64_t inizio = inizio_lezione(giorno, fascia);
+            		if (cerca_lezione(calendario, inizio) == NULL)
 			{
                 		lezione l;
-                		l.iscritti = nuova_pila();
-                		strcpy(l.data, data);
-                		strcpy(l.giorno, giorno);
-                		strcpy(l.orario, orario);
+                		l.iscritti = nuova_pila_capienza(CAPIENZA_LEZIONE);
+                		l.attesa = nuova_attesa(CAPIENZA_ATTESA);
+                		l.inizio = inizio;
+                		l.fascia = fascia;
                 		inserisci_lezione(l, calendario);
             		}
         	}
     	}
+	segna_giorno_generato(calendario, ultimo);
 }
 
 /* Funzione: stampa_lezioni
@@ -293,7 +328,7 @@ void genera_lezioni(coda calendario)
 * La funzione scorre la coda delle lezioni e, per ciascuna di esse, mostra le informazioni principali:
 * data, giorno, orario e disponibilità di posti. Le lezioni sono numerate progressivamente per agevolare
 * una possibile selezione da parte dell'utente.
-* Se il numero massimo di partecipanti è stato raggiunto, viene indicato che i posti sono esauriti.
+* Se la capienza della lezione è stata raggiunta, viene indicato che i posti sono esauriti.
 *
 * Parametri:
 * calendario: la coda contenente le lezioni da stampare.
@@ -306,29 +341,118 @@ void genera_lezioni(coda calendario)
 */
 void stampa_lezioni(coda calendario)
 {
-	// Puntatore per scorrere la coda
-	struct nodo *corrente = calendario->testa;
-	int indice = 1;
+	int numero_lezioni = dimensione_coda(calendario);
 
 	printf("\nLezioni di fitness disponibili:\n");
 
-	// Itera su tutte le lezioni
-	while (corrente != NULL)
+	// Itera su tutte le lezioni, numerate da 1
+	for (int indice = 1; indice <= numero_lezioni; indice++)
 	{
-    		int num_iscritti = dimensione_pila(corrente->valore.iscritti); // Calcola numero iscritti
+    		lezione *corrente = elemento_coda(calendario, indice - 1);
+    		int num_iscritti = dimensione_pila(corrente->iscritti); // Calcola numero iscritti
+    		int capienza = capienza_pila(corrente->iscritti);
+    		char data[11];
+    		scrivi_data(corrente->inizio, data);
     		printf("%d) Data: %s - Giorno: %s - Orario: %s - ",
-		indice, corrente->valore.data, corrente->valore.giorno, corrente->valore.orario); // Stampa info lezione
+		indice, data, nome_giorno(corrente->inizio), orario_fascia(corrente->fascia)); // Stampa info lezione
 
 		// Stampa disponibilità
-    		if (num_iscritti >= MASSIMO_PILA)
-        		printf("Posti esauriti\n");
+    		if (num_iscritti >= capienza)
+        		printf("Posti esauriti - In attesa: %d/%d\n",
+        			dimensione_attesa(corrente->attesa), capienza_attesa(corrente->attesa));
     		else
-        		printf("Posti disponibili: %d/%d\n", MASSIMO_PILA - num_iscritti, MASSIMO_PILA);
+        		printf("Posti disponibili: %d/%d\n", capienza - num_iscritti, capienza);
+	}
+}
+
+/* Funzione: trova_prenotazioni
+*
+* Trova le lezioni del calendario a cui è iscritto un partecipante.
+*
+* Descrizione:
+* Per ogni lezione controlla il partecipante con contiene_pila, che consulta l'insieme
+* dei presenti della pila: il costo per lezione non dipende dal numero di iscritti.
+*
+* Parametri:
+* - calendario: la coda in cui cercare.
+* - persona: il partecipante da cercare.
+* - trovate: array in cui scrivere le lezioni trovate.
+* - massimo: numero di posizioni disponibili in 'trovate'.
+*
+* Post-condizione:
+* - Restituisce il numero totale di lezioni trovate; ne scrive in 'trovate' al più 'massimo'.
+*/
+int trova_prenotazioni(coda calendario, partecipante persona, lezione *trovate[], int massimo)
+{
+	int numero = 0;
+
+	if (persona == NESSUN_PARTECIPANTE)
+		return 0;
 
-		// Avanza al prossimo elemento
-    		corrente = corrente->prossimo;
-    		indice++;
+	int numero_lezioni = dimensione_coda(calendario);
+	for (int n = 0; n < numero_lezioni; n++)
+	{
+		lezione *corrente = elemento_coda(calendario, n);
+		if (contiene_pila(corrente->iscritti, persona))
+		{
+			if (numero < massimo)
+				trovate[numero] = corrente;
+			numero++;
+		}
 	}
+	return numero;
+}
+
+/* Funzione: stampa_prenotazioni
+*
+* Stampa le lezioni a cui un partecipante è iscritto o in lista d'attesa.
+*
+* Descrizione:
+* Un nome mai registrato non può comparire in nessuna lezione: in quel caso non scorre il calendario.
+* Le iscrizioni vengono raccolte con trova_prenotazioni, le liste d'attesa controllate una per una.
+*
+* Parametri:
+* - calendario: la coda contenente le lezioni.
+* - nome: il nome del partecipante.
+*
+* Side-effect:
+* - Stampa a schermo le lezioni trovate.
+*/
+void stampa_prenotazioni(coda calendario, const char *nome)
+{
+	partecipante persona = cerca_nome(nome);
+	int iscrizioni = 0;
+	int attese = 0;
+
+	printf("\nLe tue prenotazioni:\n");
+	if (persona != NESSUN_PARTECIPANTE)
+	{
+		lezione *trovate[PRENOTAZIONI_ELENCATE];
+		iscrizioni = trova_prenotazioni(calendario, persona, trovate, PRENOTAZIONI_ELENCATE);
+		char data[11];
+		for (int i = 0; i < iscrizioni && i < PRENOTAZIONI_ELENCATE; i++)
+		{
+			scrivi_data(trovate[i]->inizio, data);
+			printf("- Data: %s - Giorno: %s - Orario: %s\n", data, nome_giorno(trovate[i]->inizio), orario_fascia(trovate[i]->fascia));
+		}
+		if (iscrizioni > PRENOTAZIONI_ELENCATE)
+			printf("... e altre %d lezioni\n", iscrizioni - PRENOTAZIONI_ELENCATE);
+
+		for (int n = 0; n < dimensione_coda(calendario); n++)
+		{
+			lezione *corrente = elemento_coda(calendario, n);
+			if (contiene_attesa(corrente->attesa, persona))
+			{
+				scrivi_data(corrente->inizio, data);
+				printf("- Data: %s - Giorno: %s - Orario: %s - In lista d'attesa\n",
+					data, nome_giorno(corrente->inizio), orario_fascia(corrente->fascia));
+				attese++;
+			}
+		}
+	}
+
+	if (iscrizioni == 0 && attese == 0)
+		printf("Nessuna prenotazione.\n");
 }
 
 /* Funzione: prenota_lezione
@@ -338,7 +462,9 @@ void stampa_lezioni(coda calendario)
 * Descrizione:
 * La funzione mostra l’elenco delle lezioni attualmente disponibili e consente all’utente di selezionarne una.
 * Dopo la selezione, l’utente inserisce il proprio nome per completare la prenotazione.
-* Se la lezione scelta ha posti disponibili, il nome viene aggiunto alla pila degli iscritti.
+* Se la lezione scelta ha posti disponibili e il nome non è già tra gli iscritti,
+* il nome viene aggiunto alla pila degli iscritti. Se la lezione è al completo,
+* l'utente può mettersi in lista d'attesa e verrà iscritto quando qualcuno disdice.
 *
 * Parametri:
 * calendario: la coda da cui selezionare la lezione da prenotare.
@@ -348,7 +474,7 @@ void stampa_lezioni(coda calendario)
 *
 * Side-effect:
 * - Interagisce con l’utente tramite input/output.
-* - Modifica la pila degli iscritti della lezione scelta aggiungendo un nuovo partecipante.
+* - Modifica la pila degli iscritti o la lista d'attesa della lezione scelta aggiungendo un nuovo partecipante.
 */
 void prenota_lezione(coda calendario)
 {
@@ -383,14 +509,8 @@ void prenota_lezione(coda calendario)
 	printf("Inserisci il numero della lezione a cui vuoi iscriverti: ");
 	fgets(scelta, sizeof(scelta), stdin);
 
-	// Naviga alla lezione scelta
-	struct nodo *corrente = calendario->testa;
-	int indice = 1;
-	while (corrente != NULL && indice < atoi(scelta))
-	{
-    		corrente = corrente->prossimo;
-    		indice++;
-	}
+	// Accede direttamente alla lezione scelta (numerate da 1)
+	lezione *corrente = elemento_coda(calendario, atoi(scelta) - 1);
 
 	// Verifica la validità della selezione
 	if (corrente == NULL)
@@ -401,23 +521,63 @@ void prenota_lezione(coda calendario)
     		return;
 	}
 
-	// Controlla disponibilità posti
-	if (dimensione_pila(corrente->valore.iscritti) >= MASSIMO_PILA)
+	// Controlla disponibilità posti, proponendo la lista d'attesa se la lezione è al completo
+	lista_attesa attesa = corrente->attesa;
+	int al_completo = dimensione_pila(corrente->iscritti) >= capienza_pila(corrente->iscritti);
+	if (al_completo)
 	{
     		printf("Mi dispiace, la lezione è al completo!\n");
-		printf("Premi INVIO per tornare al menu principale...");
-        	getchar();
-    		return;
+		if (dimensione_attesa(attesa) >= capienza_attesa(attesa))
+		{
+			printf("Anche la lista d'attesa è piena.\n");
+			printf("Premi INVIO per tornare al menu principale...");
+        		getchar();
+    			return;
+		}
+
+		printf("Desideri metterti in lista d'attesa? Se si libera un posto verrai iscritto automaticamente (s/n): ");
+		scanf(" %c", &risposta);
+		getchar();  // consuma il newline
+		if (risposta != 's' && risposta != 'S')
+		{
+        		printf("Prenotazione annullata.\n");
+			printf("Premi INVIO per tornare al menu principale...");
+        		getchar();
+			return;
+		}
 	}
 
 	// Acquisisce il nome dell'utente
-	partecipante nome;
+	char nome[LUNGHEZZA_PARTECIPANTE];
 	printf("Inserisci il tuo nome per prenotarti: ");
 	fgets(nome, sizeof(nome), stdin);
 	nome[strcspn(nome, "\n")] = 0; // Rimuove newline
 
+	// Controllo se il nome è già iscritto o in attesa
+	partecipante persona = cerca_nome(nome);
+	if (contiene_pila(corrente->iscritti, persona) || contiene_attesa(attesa, persona))
+	{
+		printf("Risulta già una prenotazione a nome %s per questa lezione.\n", nome);
+		printf("Premi INVIO per tornare al menu principale...");
+		getchar();
+		return;
+	}
+
+	// Lezione al completo: accoda in lista d'attesa
+	if (al_completo)
+	{
+		if (accoda_attesa(attesa, interna_nome(nome)))
+			printf("%s è in lista d'attesa, posizione %d.\nIl costo di 15€ verrà addebitato solo se si libera un posto.\n",
+				nome, dimensione_attesa(attesa));
+		else
+			printf("Errore nella prenotazione.\n");
+		printf("Premi INVIO per tornare al menu principale...");
+		getchar();
+		return;
+	}
+
 	// Effettua la prenotazione
-	if (inserisci_pila(nome, corrente->valore.iscritti))
+	if (inserisci_pila(interna_nome(nome), corrente->iscritti))
 	{
         	printf("Prenotazione completata per %s\nTi è stato addebitato il costo di 15€\n", nome);
 		printf("Premi INVIO per tornare al menu principale...");
@@ -440,7 +600,8 @@ void prenota_lezione(coda calendario)
 * La funzione mostra l'elenco delle lezioni disponibili e permette all'utente abbonato di selezionare una lezione.
 * Verifica che ci siano posti disponibili, che l’utente non sia già iscritto e che abbia lezioni rimanenti.
 * In caso positivo, l’utente viene aggiunto alla pila degli iscritti della lezione e le sue lezioni rimanenti
-* vengono decrementate.
+* vengono decrementate. Se la lezione è al completo l’utente può mettersi in lista d'attesa:
+* la lezione gli verrà scalata solo quando otterrà un posto.
 *
 * Parametri:
 * calendario: la coda contenente le lezioni disponibili.
@@ -452,7 +613,7 @@ void prenota_lezione(coda calendario)
 *
 * Side-effect:
 * - Interagisce con l’utente tramite input/output.
-* - Modifica la pila degli iscritti della lezione selezionata.
+* - Modifica la pila degli iscritti o la lista d'attesa della lezione selezionata.
 * - Decrementa il numero di lezioni rimanenti dell’abbonato.
 */
 void prenota_lezione_abbonato(coda calendario, abbonato *utente_loggato)
@@ -496,14 +657,8 @@ void prenota_lezione_abbonato(coda calendario, abbonato *utente_loggato)
 	fgets(scelta, sizeof(scelta), stdin);
 	scelta[strcspn(scelta, "\n")] = 0;
 
-	// Naviga alla lezione selezionata
-	struct nodo *corrente = calendario->testa;
-	int indice = 1;
-	while (corrente != NULL && indice < atoi(scelta))
-	{
-    		corrente = corrente->prossimo;
-    		indice++;
-	}
+	// Accede direttamente alla lezione selezionata (numerate da 1)
+	lezione *corrente = elemento_coda(calendario, atoi(scelta) - 1);
 
 	// Verifica validità selezione
 	if (corrente == NULL)
@@ -514,49 +669,51 @@ void prenota_lezione_abbonato(coda calendario, abbonato *utente_loggato)
     		return;
 	}
 
-	// Controlla disponibilità posti
-	if (dimensione_pila(corrente->valore.iscritti) >= MASSIMO_PILA)
-	{
-    		printf("Mi dispiace, la lezione è al completo!\n");
-		printf("Premi INVIO per tornare alla tua area riservata...");
-        	getchar();
-    		return;
-	}
-
-	// Controllo se l'utente è già iscritto
-	pila temp = nuova_pila();
-	partecipante p;
-	int duplicato = 0;
-	while (!pila_vuota(corrente->valore.iscritti))
-	{
- 		estrai_pila(corrente->valore.iscritti, p);
- 		if (strcmp(p, utente_loggato->nomeutente) == 0)
-		{
-	        	duplicato = 1;
-	    	}
-		inserisci_pila(p, temp);
-	}
-
-	// Ripristina la pila originale
-	while (!pila_vuota(temp))
-	{
-		estrai_pila(temp, p);
-		inserisci_pila(p, corrente->valore.iscritti);
-	}
-	free(temp);
-
-	if (duplicato)
+	// Controllo se l'utente è già iscritto o in attesa
+	lista_attesa attesa = corrente->attesa;
+	partecipante utente = interna_nome(utente_loggato->nomeutente);
+	if (contiene_pila(corrente->iscritti, utente) || contiene_attesa(attesa, utente))
 	{
 		printf("Sei già iscritto a questa lezione.\n");
 	    	printf("Premi INVIO per tornare alla tua area riservata...");
  	   	getchar();
 	    	return;
 	}
+
+	// Controlla disponibilità posti, proponendo la lista d'attesa se la lezione è al completo
+	if (dimensione_pila(corrente->iscritti) >= capienza_pila(corrente->iscritti))
+	{
+    		printf("Mi dispiace, la lezione è al completo!\n");
+		if (dimensione_attesa(attesa) >= capienza_attesa(attesa))
+		{
+			printf("Anche la lista d'attesa è piena.\n");
+			printf("Premi INVIO per tornare alla tua area riservata...");
+        		getchar();
+    			return;
+		}
+
+		printf("Desideri metterti in lista d'attesa? Se si libera un posto verrai iscritto automaticamente (s/n): ");
+		scanf(" %c", &risposta);
+		getchar();  // Consuma newline
+		if (risposta == 's' || risposta == 'S')
+		{
+			if (accoda_attesa(attesa, utente))
+				printf("Sei in lista d'attesa, posizione %d.\nLa lezione ti verrà scalata solo se otterrai un posto.\n",
+					dimensione_attesa(attesa));
+			else
+				printf("Errore nella prenotazione.\n");
+		}
+		else
+			printf("Prenotazione annullata.\n");
+		printf("Premi INVIO per tornare alla tua area riservata...");
+        	getchar();
+    		return;
+	}
 	
 	// Effettua la prenotazione
-	if (inserisci_pila(utente_loggato->nomeutente, corrente->valore.iscritti))
+	if (inserisci_pila(utente, corrente->iscritti))
 	{
-    		utente_loggato->lezioni_rimanenti--;
+    		modifica_lezioni_abbonato(utente_loggato, -1);
     		printf("Prenotazione completata per %s.\n", utente_loggato->nomeutente);
     		printf("Lezioni rimanenti: %d\n", utente_loggato->lezioni_rimanenti);
 		printf("Premi INVIO per tornare alla tua area riservata...");
@@ -574,12 +731,12 @@ void prenota_lezione_abbonato(coda calendario, abbonato *utente_loggato)
 * Consente a un utente (abbonato o non) di annullare l’iscrizione a una lezione precedentemente prenotata.
 *
 * Descrizione:
-* La funzione mostra l'elenco delle lezioni disponibili, consente all’utente di selezionarne una
-* e rimuove il proprio nome dalla pila degli iscritti, se presente.
+* La funzione mostra l'elenco delle lezioni disponibili, consente all’utente di selezionarne una,
+* per numero oppure per data e orario (cercata con cerca_lezione), e rimuove il proprio nome dalla pila degli iscritti, se presente, oppure dalla lista d'attesa.
 * Se l’utente è un abbonato, viene richiesta la password per autorizzare l’operazione e,
 * in caso di conferma, viene incrementato il numero di lezioni rimanenti.
-* Infine, aggiorna il file delle lezioni rimuovendo l’utente dalla lezione specificata
-* e aggiornando in numero di iscritti alla lezione.
+* Il posto liberato va al primo della lista d'attesa (vedi promuovi_attesa).
+* Infine, salva il calendario nel file delle lezioni.
 *
 * Parametri:
 * calendario: la coda contenente le lezioni.
@@ -591,8 +748,8 @@ void prenota_lezione_abbonato(coda calendario, abbonato *utente_loggato)
 *
 * Side-effect:
 * - Interazione con l’utente tramite input/output.
-* - Modifica la pila degli iscritti della lezione selezionata.
-* - Scrive sul file 'lezioni' e su 'abbonati.txt' (se l’utente è abbonato).
+* - Modifica la pila degli iscritti e la lista d'attesa della lezione selezionata.
+* - Scrive sul file 'lezioni' e annota nel giornale degli abbonati le lezioni restituite (se l’utente è abbonato).
 */
 void disdici_iscrizione(coda calendario, const char* lezioni)
 {
@@ -623,22 +780,28 @@ void disdici_iscrizione(coda calendario, const char* lezioni)
     	}
 
 	// Acquisisce la scelta dell'utente
-    	char scelta[10];
-    	printf("Inserisci il numero della lezione a cui vuoi disdire la tua iscrizione: ");
+    	char scelta[40];
+    	printf("Inserisci il numero della lezione a cui vuoi disdire la tua iscrizione\n");
+    	printf("oppure la sua data e il suo orario (es. 21/10/2026 16-18): ");
     	fgets(scelta, sizeof(scelta), stdin);
 
-    	// Calcola il numero totale di lezioni
-    	int max_lezioni = 0;
-    	struct nodo* temp = calendario->testa;
-	while (temp != NULL) 
+	// Cerca la lezione per data e orario tramite l'indice del calendario, altrimenti per numero
+    	lezione* selezionata = NULL;
+    	if (strchr(scelta, '/') != NULL)
     	{
-        	max_lezioni++;
-        	temp = temp->prossimo;
+        	char data[11];
+        	char orario[20];
+        	int fascia;
+        	if (sscanf(scelta, "%10s %19s", data, orario) == 2)
+            		selezionata = cerca_lezione(calendario, leggi_inizio(data, orario, &fascia));
+    	}
+    	else
+    	{
+        	selezionata = elemento_coda(calendario, atoi(scelta) - 1);
     	}
 
 	// Verifica validità input
-    	int num_scelta = atoi(scelta);
-    	if (num_scelta < 1 || num_scelta > max_lezioni)
+    	if (selezionata == NULL)
     	{
         	printf("Scelta non valida.\n");
         	printf("Possiamo fare altro per te? Premi INVIO...");
@@ -646,25 +809,6 @@ void disdici_iscrizione(coda calendario, const char* lezioni)
 		return;
     	}
 
-	// Naviga alla lezione selezionata
-    	struct nodo* corrente = calendario->testa;
-    	int indice = 0;
-    	while (corrente != NULL && indice < num_scelta - 1) 
-    	{
-      		corrente = corrente->prossimo;
-        	indice++;
-    	}
-
-    	if (corrente == NULL)
-    	{
-        	printf("Errore: lezione non trovata.\n");
-        	printf("Possiamo fare altro per te? Premi INVIO...");
-        	getchar();
-        	return;
-    	}
-
-    	lezione* selezionata = &corrente->valore; 
-
 	// Acquisisce l'identità dell'utente
     	char nome[50];
     	printf("Inserisci il tuo nome oppure, se sei abbonato, il tuo nome utente: ");
@@ -672,7 +816,7 @@ void disdici_iscrizione(coda calendario, const char* lezioni)
     	nome[strcspn(nome, "\n")] = 0;  // rimuove newline
 
     	// Verifica se è un abbonato
-    	tabella_hash tabella = carica_abbonati("abbonati.txt");
+    	tabella_hash tabella = registro_abbonati("abbonati.txt");
     	abbonato* utente = cerca_hash(nome, tabella);
 
 	// Se abbonato, richiede la password
@@ -688,185 +832,114 @@ void disdici_iscrizione(coda calendario, const char* lezioni)
             		printf("Password errata. Disdetta annullata.\n");
             		printf("Possiamo fare altro per te? Premi INVIO...");
             		getchar();
-            		free(tabella);
             		return;
         	}
 	}
 
 	// Cerca e rimuove l'utente dalla lista iscritti
-    	int trovato = 0;
-    	pila supporto = nuova_pila();
-    	if (supporto == NULL)
-    	{
-       		printf("Errore nell'allocazione della pila di supporto.\n");
-        	printf("Possiamo fare altro per te? Premi INVIO...");
-        	getchar();
-        	return;
-    	}
+    	partecipante cercato = cerca_nome(nome); // NESSUN_PARTECIPANTE se il nome non è mai stato iscritto
+    	int trovato = rimuovi_partecipante_pila(selezionata->iscritti, cercato);
 
-    	partecipante p;
-
-    	while (!pila_vuota(selezionata->iscritti))
+    	// Se abbonato, incrementa le lezioni rimanenti
+    	if (trovato && utente != NULL)
     	{
-        	strcpy(p, testa(selezionata->iscritti));
-        	estrai_pila(selezionata->iscritti, p);
-
-        	if (strcmp(p, nome) == 0 && !trovato)
-        	{
-            		trovato = 1;
-            		// Se abbonato, incrementa le lezioni rimanenti
-            		if (utente != NULL)
-			{
-                		utente->lezioni_rimanenti++;
-                		salva_abbonati(tabella, "abbonati.txt");
-                		printf("Lezione disdetta. Lezioni rimanenti: %d\n", utente->lezioni_rimanenti);
-            		}
-        	}
-        	else
-        	{
-            		inserisci_pila(p, supporto);
-        	}
+        	modifica_lezioni_abbonato(utente, 1);
+        	printf("Lezione disdetta. Lezioni rimanenti: %d\n", utente->lezioni_rimanenti);
     	}
 
-	// Ripristina la pila originale
-    	while (!pila_vuota(supporto))
-    	{
-        	strcpy(p, testa(supporto));
-        	estrai_pila(supporto, p);
-        	inserisci_pila(p, selezionata->iscritti);
-    	}
-    	free(supporto);
+    	// Chi è solo in lista d'attesa ne esce senza variazioni di lezioni
+    	int in_attesa = !trovato && rimuovi_attesa(selezionata->attesa, cercato);
 
-    	if (!trovato)
+    	if (!trovato && !in_attesa)
     	{
         	printf("Partecipante non trovato.\n");
         	printf("Possiamo fare altro per te? Premi INVIO...");
         	getchar();
-        	remove("temp.txt");
         	return;
     	}
 
-	// Aggiorna il file delle lezioni
-	FILE* file = fopen(lezioni, "r");
-    	if (!file)
-    	{
-        	printf("Errore nell'apertura del file.\n");
-        	printf("Premi INVIO\n");
-        	getchar();
-        	return;
-	}
-
-    	FILE* temp_file = fopen("temp_file.txt", "w");
-    	if (!temp_file)
-    	{
-        	fclose(file);
-        	printf("Errore nella creazione del file temporaneo.\n");
-        	printf("Possiamo fare altro per te? Premi INVIO...");
-        	getchar();
-        	return;
-   	}
-
-    	char riga[256];
-    	int in_lezione_target = 0;
-    	int nuovo_numero_iscritti = dimensione_pila(selezionata->iscritti); // Ottieni il nuovo numero di iscritti
-
-    	while (fgets(riga, sizeof(riga), file))
-    	{
-        	// Rimuove newline
-        	riga[strcspn(riga, "\n")] = 0;
-
-        	// Se contiene la data, è intestazione di una nuova lezione
-        	if (strstr(riga, "/") && strstr(riga, ";"))
-        	{
-            		if (strstr(riga, selezionata->data))
-            		{
-                		in_lezione_target = 1;
-                		// Modifica la riga con il nuovo numero di iscritti
-                		char data[11], giorno[15], orario[10];
-                		int vecchio_numero;
-                		sscanf(riga, "%[^;];%[^;];%[^;];%d", data, giorno, orario, &vecchio_numero);
-                		fprintf(temp_file, "%s;%s;%s;%d\n", data, giorno, orario, nuovo_numero_iscritti);
-                		continue;
-            		}
-            		else
-            		{
-                		in_lezione_target = 0;
-            		}
-            
-            		fputs(riga, temp_file);
-            		fputc('\n', temp_file);
-            		continue;
-        	}
-
-		// Se è partecipante nella lezione giusta e corrisponde al nome da eliminare, salta la riga
-        	if (in_lezione_target && strcmp(riga, nome) == 0)
-            		continue;
+    	// Il posto liberato va al primo della lista d'attesa
+    	if (trovato)
+        	promuovi_attesa(selezionata, tabella);
 
-        	// Altrimenti scrive normalmente
-        	fputs(riga, temp_file);
-        	fputc('\n', temp_file);
-    	}
-
-    	fclose(file);
-    	fclose(temp_file);
-    	remove(lezioni);
-    	rename("temp_file.txt", lezioni);
+	// Aggiorna il file delle lezioni
+    	salva_lezioni(calendario, lezioni);
 
-    	printf("Iscrizione disdetta con successo.\nPremi INVIO per continuare...");
+    	if (in_attesa)
+        	printf("Sei stato tolto dalla lista d'attesa.\nPremi INVIO per continuare...");
+    	else
+        	printf("Iscrizione disdetta con successo.\nPremi INVIO per continuare...");
     	getchar();
 }
 
-/* Funzione: data_passata
+/* Funzione: promuovi_attesa
 *
-* Verifica se una data nel formato "gg/mm/aaaa" con orario associato è precedente alla data e ora attuali.
+* Assegna i posti liberi di una lezione ai primi partecipanti della sua lista d'attesa
 *
 * Descrizione:
-* La funzione analizza la stringa 'data_str' contenente la data nel formato "gg/mm/aaaa"
-* e la stringa 'orario' (es. "10-12" o "16-18") per determinare l'ora di inizio della lezione.
-* Converte queste informazioni in una struttura 'tm' e successivamente in un valore 'time_t'.
-* Confronta quindi questa data/ora con il tempo attuale usando 'difftime'.
-* Se la data/ora è nel passato rispetto al momento corrente, restituisce 1, altrimenti 0.
+* Legge il primo della lista, lo inserisce in cima alla pila degli iscritti e solo allora lo preleva
+* dalla lista, tutte operazioni a costo costante: se l'inserimento fallisce (memoria esaurita)
+* il partecipante resta primo in lista d'attesa. Se il promosso è un abbonato gli viene scalata
+* una lezione; un abbonato rimasto senza lezioni mentre era in attesa perde il turno
+* e il posto passa al successivo
 *
 * Parametri:
-* - data_str: stringa con la data da verificare (formato "gg/mm/aaaa")
-* - orario: stringa che indica l'orario della lezione ("10-12" o "16-18")
+* l: la lezione in cui si è liberato almeno un posto
+* tabella: la tabella degli abbonati, per riconoscere chi va addebitato
 *
 * Pre-condizione:
-* - 'data_str' deve essere valida e ben formattata
-* - 'orario' deve essere uno dei valori riconosciuti
+* - 'tabella' deve essere il registro degli abbonati (registro_abbonati), perché gli addebiti
+*   passano da modifica_lezioni_abbonato
+*
+* Side-effect:
+* - Modifica la lista d'attesa e la pila degli iscritti della lezione
+* - Annota nel giornale degli abbonati le lezioni scalate
+*/
+void promuovi_attesa(lezione *l, tabella_hash tabella)
+{
+	while (dimensione_pila(l->iscritti) < capienza_pila(l->iscritti) && dimensione_attesa(l->attesa) > 0)
+	{
+		partecipante promosso = elemento_attesa(l->attesa, 0);
+		char nome[LUNGHEZZA_PARTECIPANTE];
+		strcpy(nome, nome_partecipante(promosso));
+		abbonato *utente = cerca_hash(nome, tabella);
+
+		if (utente != NULL && utente->lezioni_rimanenti <= 0)
+		{
+			preleva_attesa(l->attesa);
+			printf("%s esce dalla lista d'attesa: non ha lezioni rimanenti.\n", nome);
+			continue;
+		}
+
+		if (!inserisci_pila(promosso, l->iscritti))
+			return; // Resta primo in lista: verrà promosso al prossimo posto liberato
+		preleva_attesa(l->attesa);
+
+		if (utente != NULL)
+			modifica_lezioni_abbonato(utente, -1);
+		printf("Il posto liberato va a %s, primo in lista d'attesa.\n", nome);
+	}
+}
+
+/* Funzione: data_passata
+*
+* Verifica se una lezione è iniziata prima dell'istante indicato.
+*
+* Descrizione:
+* L'inizio della lezione è già un intero, calcolato una volta al caricamento o alla generazione:
+* il confronto non richiede né sscanf né mktime. Chi controlla molte lezioni legge l'ora attuale
+* una sola volta con istante_attuale e la passa a ogni chiamata.
+*
+* Parametri:
+* - inizio: istante di inizio della lezione (campo 'inizio' di lezione)
+* - adesso: istante con cui confrontarlo, di solito istante_attuale()
 *
 * Post-condizione:
-* - Ritorna 1 se la data/orario indicati sono passati rispetto all'ora corrente, 0 altrimenti
+* - Ritorna 1 se la lezione è iniziata prima di 'adesso', 0 altrimenti
 */
-int data_passata(const char *data_str, const char *orario)
+int data_passata(int64_t inizio, int64_t adesso)
 {
-	struct tm data_lezione = {0};
-    	int giorno, mese, anno;
-    	int ora_inizio;
-    
-    	if (sscanf(data_str, "%d/%d/%d", &giorno, &mese, &anno) != 3)
-        	return 0;  // Formato invalido
-    
-    	// Determina l'ora di inizio in base all'orario
-    	if (strcmp(orario, "10-12") == 0)
-        	ora_inizio = 10;
-    	else if (strcmp(orario, "16-18") == 0)
-        	ora_inizio = 16;
-    	else
-        	return 0;  // Orario non riconosciuto
-    
-	data_lezione.tm_mday = giorno;
-    	data_lezione.tm_mon = mese - 1;  // mesi da 0 a 11
-    	data_lezione.tm_year = anno - 1900;
-    	data_lezione.tm_hour = ora_inizio;  // Ora di inizio lezione
-    	data_lezione.tm_min = 0;
-    	data_lezione.tm_sec = 0;
-    	data_lezione.tm_isdst = -1;     // Ignora daylight saving
-
-    	time_t tempo_lezione = mktime(&data_lezione);
-    	time_t tempo_attuale = time(NULL);
-
-    	return difftime(tempo_lezione, tempo_attuale) < 0;
+	return inizio < adesso;
 }
 
 /* Funzione: pulisci_lezioni_passate
@@ -875,10 +948,12 @@ int data_passata(const char *data_str, const char *orario)
 *
 * Descrizione:
 * La funzione scorre la coda delle lezioni e rimuove tutte quelle con data passata,
-* confrontando con la data odierna tramite la funzione data_passata.
+* confrontando con l'istante attuale, letto una sola volta, tramite la funzione data_passata.
 * Ogni lezione eliminata, con i relativi iscritti, viene salvata in append su file storico.
-* La struttura della coda viene modificata rimuovendo i nodi corrispondenti,
-* la memoria dei nodi eliminati viene liberata.
+* La coda è ordinata per inizio, quindi le lezioni passate sono tutte in testa: vengono tolte
+* dalla testa fermandosi alla prima ancora da svolgere, e il file non viene aperto se non ce
+* ne sono. La memoria delle pile di iscritti e delle liste d'attesa delle lezioni eliminate
+* viene liberata.
 *
 * Parametri:
 * - calendario: coda contenente le lezioni da analizzare.
@@ -890,14 +965,19 @@ int data_passata(const char *data_str, const char *orario)
 *
 * Side-effect:
 * - Apre il file in modalità append ("a").
-* - Modifica la struttura della coda rimuovendo nodi.
+* - Modifica la struttura della coda rimuovendo le lezioni passate.
 * - Scrive su file le lezioni passate e i relativi iscritti.
-* - Libera la memoria dei nodi eliminati.
+* - Libera la memoria delle lezioni eliminate.
 */
 void pulisci_lezioni_passate(coda calendario, const char *nome_file)
 {
 	if (calendario == NULL || coda_vuota(calendario)) return;
 
+	// La coda è ordinata per inizio: se la prima lezione non è passata, nessuna lo è
+    	int64_t adesso = istante_attuale();
+    	if (!data_passata(elemento_coda(calendario, 0)->inizio, adesso))
+    		return;
+
     	FILE *fp = fopen(nome_file, "a");
     	if (fp == NULL)
     	{
@@ -905,61 +985,25 @@ void pulisci_lezioni_passate(coda calendario, const char *nome_file)
         	return;
     	}
 
-    	struct nodo *corrente = calendario->testa;
-    	struct nodo *precedente = NULL;
-
-    	while (corrente != NULL)
+	// Toglie le lezioni passate dalla testa, fermandosi alla prima ancora da svolgere
+    	while (!coda_vuota(calendario) && data_passata(elemento_coda(calendario, 0)->inizio, adesso))
     	{
-        	struct nodo *prossimo = corrente->prossimo;
-
-        	if (data_passata(corrente->valore.data, corrente->valore.orario))
-        	{
-            		// Archivia la lezione
-            		fprintf(fp, "%s;%s;%s;%d\n",
-                	corrente->valore.data,
-                	corrente->valore.giorno,
-                	corrente->valore.orario,
-                	dimensione_pila(corrente->valore.iscritti));
-
-            		// Archivia gli iscritti
-            		pila iscritti_tmp = nuova_pila();
-            		partecipante p;
-            		while (!pila_vuota(corrente->valore.iscritti))
-            		{
-                		if (estrai_pila(corrente->valore.iscritti, p))
-                		{
-                    			fprintf(fp, "%s\n", p);
-                    			inserisci_pila(p, iscritti_tmp);
-                		}
-            		}
+        	lezione corrente = rimuovi_lezione(calendario);
 
-            		// Ripristina la pila
-            		while (!pila_vuota(iscritti_tmp))
-            		{
-                		if (estrai_pila(iscritti_tmp, p))
-                    			inserisci_pila(p, corrente->valore.iscritti);
-            		}
-
-            		// Rimuove il nodo dalla coda
-            		if (precedente == NULL)
-                		calendario->testa = prossimo;
-            		else
-                		precedente->prossimo = prossimo;
-
-            		if (corrente == calendario->coda)
-            		{
-                		calendario->coda = precedente;
-            		}
-
-            		free(corrente);
-            		calendario->numel--;
- 		}
-        else 
-        {
-        	precedente = corrente;
-        }
-
-        corrente = prossimo;
+        	// Archivia la lezione
+        	char data[11];
+        	scrivi_data(corrente.inizio, data);
+        	fprintf(fp, "%s;%s;%s;%d\n",
+                	data,
+                	nome_giorno(corrente.inizio),
+                	orario_fascia(corrente.fascia),
+                	dimensione_pila(corrente.iscritti));
+
+        	// Archivia gli iscritti, dalla cima della pila verso il fondo
+        	visita_pila(corrente.iscritti, scrivi_iscritto, fp);
+
+        	distruggi_pila(corrente.iscritti);
+        	distruggi_attesa(corrente.attesa);
 	}
 
 	fclose(fp);
@@ -1177,3 +1221,11 @@ void report_mensile(const char* nome_file)
     	}
 }
 
+/* Funzione: scrivi_iscritto
+*
+* Scrive su file il nome di un partecipante, uno per riga (usata con visita_pila)
+*/
+static void scrivi_iscritto(partecipante persona, void *file)
+{
+	fprintf(file, "%s\n", nome_partecipante(persona));
+}
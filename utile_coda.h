@@ -3,6 +3,7 @@
 
 #include "abbonati.h"
 #include "coda.h"
+#include "hash.h"
 #include "lezione.h"
 
 /* Funzione: carica_lezioni
@@ -20,6 +21,7 @@
 * Side-effect:
 * - Legge da file.
 * - Alloca dinamicamente memoria per le pile di iscritti e per i nodi della coda.
+* - Registra nel calendario l'ultimo giorno generato, se il file lo riporta.
 */
 void carica_lezioni(coda calendario, const char *nome_file);
 
@@ -37,8 +39,7 @@ void carica_lezioni(coda calendario, const char *nome_file);
 *
 * Side-effect:
 * - Apre il file in modalità scrittura.
-* - Estrae temporaneamente gli iscritti dalle pile per scriverli su file.
-* - Ripristina le pile originali degli iscritti al termine della scrittura.
+* - Scrive su file l'ultimo giorno generato, tutte le lezioni e i relativi iscritti.
 */
 void salva_lezioni(coda calendario, const char *nome_file);
 
@@ -48,19 +49,15 @@ void salva_lezioni(coda calendario, const char *nome_file);
 *
 * Parametri:
 * giorno_settimana: intero rappresentante il giorno della settimana (0 = Domenica, 6 = Sabato)
-* giorno: stringa (allocata dall'esterno) dove verrà salvato il nome del giorno (es. "Lunedi")
-* orario: stringa (allocata dall'esterno) dove verrà salvata la fascia oraria della lezione (es. "10-12")
-* ora_inizio: puntatore a intero dove viene salvata l'ora di inizio della lezione
+* fascia: puntatore a intero dove viene salvata la fascia oraria della lezione (vedi orario_fascia)
 *
 * Pre-condizione:
-* - Le stringhe 'giorno' e 'orario' devono essere allocate con dimensione sufficiente (almeno 10 caratteri).
-* - 'ora_inizio' deve essere un puntatore valido.
+* - 'fascia' deve essere un puntatore valido.
 *
 * Post-condizione:
-* - Se il giorno è valido per una lezione, restituisce 1 e riempie le stringhe giorno e orario, 
-*   e imposta 'ora_inizio', altrimenti restituisce 0.
+* - Se il giorno è valido per una lezione, restituisce 1 e imposta 'fascia', altrimenti restituisce 0.
 */
-int giorno_lezione(int giorno_settimana, char *giorno, char *orario, int *ora_inizio);
+int giorno_lezione(int giorno_settimana, int *fascia);
 
 /* Funzione: genera_lezioni
 *
@@ -73,10 +70,11 @@ int giorno_lezione(int giorno_settimana, char *giorno, char *orario, int *ora_in
 * - 'calendario' deve essere una coda inizializzata, eventualmente già contenente lezioni caricate da file.
 *
 * Side-effect:
-* - Analizza le prossime 30 date a partire da oggi.
+* - Analizza le date non ancora generate tra oggi e i prossimi 30 giorni (vedi giorno_generato).
 * - Verifica i giorni validi per le lezioni.
 * - Controlla la presenza di duplicati nella coda.
 * - Alloca dinamicamente nuove lezioni da inserire nella coda.
+* - Aggiorna il giorno generato del calendario.
 */
 void genera_lezioni(coda calendario);
 
@@ -95,6 +93,46 @@ void genera_lezioni(coda calendario);
 */
 void stampa_lezioni(coda calendario);
 
+/* Funzione: trova_prenotazioni
+*
+* Trova le lezioni del calendario a cui è iscritto un partecipante.
+*
+* Descrizione:
+* Scorre tutte le lezioni e controlla il partecipante con contiene_pila, in tempo costante
+* per lezione qualunque sia il numero di iscritti.
+*
+* Parametri:
+* - calendario: la coda in cui cercare.
+* - persona: il partecipante da cercare, come restituito da cerca_nome o interna_nome.
+* - trovate: array in cui vengono scritti i puntatori alle lezioni trovate, in ordine di calendario.
+* - massimo: numero di posizioni disponibili in 'trovate'.
+*
+* Pre-condizione:
+* - 'calendario' deve essere una coda inizializzata.
+*
+* Post-condizione:
+* - Restituisce il numero di lezioni a cui persona è iscritta, anche se maggiore di 'massimo':
+*   solo le prime 'massimo' vengono scritte in 'trovate'. I puntatori restano validi fino
+*   al prossimo inserimento o rimozione nel calendario (vedi elemento_coda).
+*/
+int trova_prenotazioni(coda calendario, partecipante persona, lezione *trovate[], int massimo);
+
+/* Funzione: stampa_prenotazioni
+*
+* Stampa le lezioni a cui un partecipante è iscritto o in lista d'attesa.
+*
+* Parametri:
+* - calendario: la coda contenente le lezioni.
+* - nome: il nome del partecipante.
+*
+* Pre-condizione:
+* - 'calendario' deve essere una coda inizializzata.
+*
+* Side-effect:
+* - Stampa a schermo le lezioni trovate.
+*/
+void stampa_prenotazioni(coda calendario, const char *nome);
+
 /* Funzione: prenota_lezione
 *
 * Permette all’utente di prenotare una lezione tra quelle disponibili nella coda.
@@ -144,27 +182,45 @@ void prenota_lezione_abbonato(coda calendario, abbonato *utente_loggato);
 *
 * Side-effect:
 * - Interazione con l’utente tramite input/output.
-* - Modifica la pila degli iscritti della lezione selezionata.
-* - Scrive sul file 'lezioni' e su 'abbonati.txt' (se l’utente è abbonato).
+* - Modifica la pila degli iscritti e la lista d'attesa della lezione selezionata.
+* - Scrive sul file 'lezioni' e annota nel giornale degli abbonati le lezioni restituite (se l’utente è abbonato).
 */
 void disdici_iscrizione(coda calendario, const char* lezioni);
 
-/* Funzione: data_passata
+/* Funzione: promuovi_attesa
+*
+* Assegna i posti liberi di una lezione ai primi partecipanti della sua lista d'attesa
 *
-* Verifica se una data nel formato "gg/mm/aaaa" con orario associato è precedente alla data e ora attuali.
+* Descrizione:
+* Usata da disdici_iscrizione dopo ogni disdetta. Un abbonato promosso paga una lezione;
+* un abbonato senza lezioni rimanenti perde il turno e il posto passa al successivo.
+* Se l'inserimento nella pila fallisce il partecipante resta primo in lista d'attesa.
 *
 * Parametri:
-* - data_str: stringa con la data da verificare (formato "gg/mm/aaaa")
-* - orario: stringa che indica l'orario della lezione ("10-12" o "16-18")
+* l: la lezione in cui si è liberato almeno un posto
+* tabella: la tabella degli abbonati, per riconoscere chi va addebitato
 *
 * Pre-condizione:
-* - 'data_str' deve essere valida e ben formattata
-* - 'orario' deve essere uno dei valori riconosciuti
+* - 'tabella' deve essere il registro degli abbonati (registro_abbonati)
+*
+* Side-effect:
+* - Modifica la lista d'attesa e la pila degli iscritti della lezione
+* - Annota nel giornale degli abbonati le lezioni scalate
+*/
+void promuovi_attesa(lezione *l, tabella_hash tabella);
+
+/* Funzione: data_passata
+*
+* Verifica se una lezione è iniziata prima dell'istante indicato, con un confronto tra interi.
+*
+* Parametri:
+* - inizio: istante di inizio della lezione (campo 'inizio' di lezione)
+* - adesso: istante con cui confrontarlo, di solito istante_attuale() letto una volta per tutte le lezioni
 *
 * Post-condizione:
-* - Ritorna 1 se la data/orario indicati sono passati rispetto all'ora corrente, 0 altrimenti
+* - Ritorna 1 se la lezione è iniziata prima di 'adesso', 0 altrimenti
 */
-int data_passata(const char *data_str, const char *orario);
+int data_passata(int64_t inizio, int64_t adesso);
 
 /* Funzione: pulisci_lezioni_passate
 *
@@ -1,24 +1,72 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 #include "hash.h"
 #include "utile_hash.h"
+#include "abbonati_bin.h"
 
-// Struttura della tabella hash
-struct c_hash 
+#define DIMENSIONE_MINIMA 10 // Slot della tabella quando il file è vuoto o assente, o quando gli abbonati arrivano dall'archivio
+
+#define MASSIMO_NOME_FILE 256
+#define SOGLIA_MINIMA_GIORNALE 65536 // Byte del giornale oltre i quali si valuta la compattazione
+
+// Dati di stat con cui il registro si accorge delle modifiche fatte da altri processi
+struct stato_file
+{
+	int presente; // 0 se il file non esisteva
+	dev_t dispositivo;
+	ino_t inode;
+	off_t dimensione;
+	struct timespec modifica;
+};
+
+// Tabella degli abbonati condivisa, con lo stato dei file al momento dell'ultima lettura o scrittura
+static struct
+{
+	tabella_hash tabella; // NULL finché il registro non è stato caricato
+	char nome_file[MASSIMO_NOME_FILE]; // Checkpoint: tutti gli abbonati, riscritto solo dalla compattazione
+	char nome_giornale[MASSIMO_NOME_FILE]; // Modifiche successive al checkpoint, una per riga
+	char nome_archivio[MASSIMO_NOME_FILE]; // Copia binaria del checkpoint, caricata senza analizzare il testo
+	archivio_abbonati archivio; // Archivio mappato, NULL se manca o non corrisponde al checkpoint
+	int collegato; // 1 se la tabella prende dall'archivio gli abbonati non ancora copiati (riserva_archivio)
+	struct stato_file checkpoint;
+	struct stato_file giornale;
+} registro;
+
+// Chiavi raccolte da purga_abbonati durante la visita della tabella
+struct da_purgare
 {
-  int dimensione;
-  abbonato **tabella;
+	time_t limite;
+	char (*chiavi)[MAX_CARATTERI];
+	int numero; // -1 dopo un errore di allocazione
+	int capacita;
 };
 
+static int conta_righe(FILE *file);
+static void raccogli_inattivo(abbonato *corrente, void *elenco);
+static void scrivi_abbonato(abbonato *corrente, void *file);
+static void memorizza_stato(const char *nome_file, struct stato_file *stato);
+static int stato_cambiato(const char *nome_file, const struct stato_file *stato);
+static void nome_derivato(const char *nome_file, const char *estensione, char *derivato);
+static void riscrivi_archivio(void);
+static void riapplica_giornale(tabella_hash h, const char *giornale);
+static void annota(const char *formato, ...);
+
 /* Funzione: carica_abbonati
 *
 * Carica da file i dati degli abbonati e li inserisce in una nuova tabella hash
 *
 * Descrizione:
 * Apre il file specificato in modalità lettura e, per ogni riga correttamente formattata,
-* crea un nuovo oggetto abbonato con i dati letti (nome utente, password, lezioni rimanenti).
-* Ogni abbonato viene poi inserito nella tabella hash appena creata.
+* crea un nuovo oggetto abbonato con i dati letti (nome utente, password, lezioni rimanenti
+* e, se presente, la data dell'ultima attività; i file scritti dalle versioni precedenti non la hanno
+* e in quel caso viene usata la data di caricamento, così nessuno risulta inattivo da sempre).
+* Ogni abbonato viene poi inserito nella tabella hash appena creata, dimensionata in anticipo
+* in base al numero di righe del file così da non doverla ridimensionare durante il caricamento.
 * Se il file non esiste, viene creata una nuova tabella hash vuota con dimensione predefinita.
 *
 * Parametri:
@@ -41,28 +89,34 @@ tabella_hash carica_abbonati(const char *nome_file)
     	if (!file)
 	{
         	printf("File abbonati non trovato. Verra' creato un nuovo file.\n");
-        	return nuova_hash(10);
+        	return nuova_hash(DIMENSIONE_MINIMA);
     	}
 
-	// Crea una nuova tabella hash
-    	tabella_hash h = nuova_hash(10);
+	// Crea una nuova tabella hash con uno slot per ogni riga del file
+	int righe = conta_righe(file);
+    	tabella_hash h = nuova_hash(righe > DIMENSIONE_MINIMA ? righe : DIMENSIONE_MINIMA);
     	char riga[200];
+	time_t adesso = time(NULL);
 
 	// Legge il file riga per riga
 	while (fgets(riga, sizeof(riga), file))
 	{
         	char *nomeutente = strtok(riga, ";");
         	char *password = strtok(NULL, ";");
-       		char *lezioni_str = strtok(NULL, "\n");
+       		char *lezioni_str = strtok(NULL, ";\n");
+		char *attivita_str = strtok(NULL, "\n");
 
 		// Crea un nuovo abbonato
         	if (nomeutente && password && lezioni_str)
 		{
             		abbonato nuovo;
-            		strncpy(nuovo.nomeutente, nomeutente, MAX_CARATTERI);
-            		strncpy(nuovo.password, password, MAX_CARATTERI);
+            		strncpy(nuovo.nomeutente, nomeutente, MAX_CARATTERI - 1);
+            		nuovo.nomeutente[MAX_CARATTERI - 1] = '\0';
+            		strncpy(nuovo.password, password, MAX_CARATTERI - 1);
+            		nuovo.password[MAX_CARATTERI - 1] = '\0';
             		nuovo.lezioni_rimanenti = atoi(lezioni_str);
-            		nuovo.chiave = strdup(nuovo.nomeutente);
+			nuovo.ultima_attivita = attivita_str ? (time_t)atoll(attivita_str) : adesso;
+            		nuovo.chiave = nuovo.nomeutente; // La tabella ne fa una copia
             		h = inserisci_hash(nuovo, h); // Inserisce nella tabella
         	}
     	}
@@ -76,9 +130,15 @@ tabella_hash carica_abbonati(const char *nome_file)
 * Salva su file i dati degli abbonati presenti nella tabella hash
 *
 * Descrizione:
-* Apre il file specificato in modalità scrittura e, per ogni elemento presente nella tabella hash,
-* scrive una riga contenente nome utente, password e numero di lezioni rimanenti separati da punto e virgola.
+* Apre il file specificato in modalità scrittura e, per ogni elemento presente nella tabella hash
+* (visitato con visita_hash),
+* scrive una riga contenente nome utente, password, numero di lezioni rimanenti e data dell'ultima attività
+* (secondi dall'epoch) separati da punto e virgola.
 * Ogni riga rappresenta un abbonato.
+* Il file viene scritto con un nome temporaneo e poi rinominato, così un'interruzione
+* a metà scrittura lascia intatta la versione precedente.
+* Se h è la tabella del registro, il file salvato diventa il nuovo checkpoint
+* e il giornale delle modifiche viene svuotato.
 *
 * Parametri:
 * h: tabella hash contenente gli abbonati da salvare
@@ -92,25 +152,554 @@ tabella_hash carica_abbonati(const char *nome_file)
 */
 void salva_abbonati(tabella_hash h, const char *nome_file)
 {
-	// Apre il file in scrittura
-	FILE *file = fopen(nome_file, "w");
+	// Apre il file temporaneo in scrittura
+	char temporaneo[MASSIMO_NOME_FILE + 4];
+	snprintf(temporaneo, sizeof(temporaneo), "%s.tmp", nome_file);
+	FILE *file = fopen(temporaneo, "w");
     	if (!file)
 	{
         	printf("Errore nell'apertura del file per il salvataggio.\n");
         	return;
     	}
 
-	// Scorre tutti gli slot della tabella
-    	for (int i = 0; i < h->dimensione; i++)
+	// Scrive gli abbonati
+	visita_hash(h, scrivi_abbonato, file);
+
+	if (fclose(file) != 0 || rename(temporaneo, nome_file) != 0)
+	{
+		printf("Errore nel salvataggio del file degli abbonati.\n");
+		remove(temporaneo);
+		return;
+	}
+
+	if (h != registro.tabella || strcmp(nome_file, registro.nome_file) != 0)
+		return;
+
+	// Il checkpoint contiene ormai tutte le modifiche annotate nel giornale
+	file = fopen(registro.nome_giornale, "w");
+	if (file != NULL)
+		fclose(file);
+	riscrivi_archivio();
+
+	// Il registro non deve considerare "esterna" una modifica fatta da noi
+	memorizza_stato(registro.nome_file, &registro.checkpoint);
+	memorizza_stato(registro.nome_giornale, &registro.giornale);
+}
+
+/* Funzione: purga_abbonati
+*
+* Rimuove dalla tabella gli abbonati senza lezioni rimanenti e inattivi da prima di limite
+*
+* Descrizione:
+* Raccoglie con visita_hash le chiavi degli abbonati da eliminare (la tabella non può essere
+* modificata durante la visita) e poi le rimuove una alla volta con rimuovi_hash.
+* Le chiavi vengono copiate perché la rimozione invalida il membro che le contiene
+*
+* Parametri:
+* h: tabella hash da cui rimuovere gli abbonati
+* limite: istante prima del quale un abbonato è considerato inattivo
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce il numero di abbonati rimossi, -1 se l'allocazione della lista di chiavi fallisce
+*
+* Side-effect:
+* I puntatori agli abbonati rimossi non sono più validi. Se h è la tabella del registro
+* ogni rimozione viene annotata nel giornale, altrimenti va chiamata salva_abbonati
+*/
+int purga_abbonati(tabella_hash h, time_t limite)
+{
+	struct da_purgare elenco = { limite, NULL, 0, 0 };
+	visita_hash(h, raccogli_inattivo, &elenco);
+	if (elenco.numero < 0)
+	{
+		free(elenco.chiavi);
+		return -1;
+	}
+
+	int rimossi = 0;
+	for (int i = 0; i < elenco.numero; i++)
+	{
+		if (!rimuovi_hash(elenco.chiavi[i], h))
+			continue;
+		rimossi++;
+		if (h == registro.tabella)
+			annota("R;%s\n", elenco.chiavi[i]);
+	}
+
+	free(elenco.chiavi);
+	return rimossi;
+}
+
+/* Funzione: registro_abbonati
+*
+* Restituisce la tabella degli abbonati condivisa da tutto il programma
+*
+* Descrizione:
+* Alla prima chiamata (o se viene chiesto un file diverso) carica la tabella del checkpoint
+* e vi riapplica in ordine le modifiche annotate nel giornale (nome_file con estensione .journal);
+* poi memorizza dispositivo, inode, dimensione e data di modifica di entrambi i file.
+* Se l'archivio binario (nome_file con estensione .bin) esiste ed è stato scritto dalla versione
+* attuale di nome_file, il checkpoint non viene letto affatto: la tabella parte vuota e collegata
+* all'archivio con riserva_archivio, così ogni abbonato viene copiato dall'indice mappato solo
+* quando viene cercato, modificato o rimosso e l'avvio non dipende dal numero di abbonati.
+* Altrimenti viene letto nome_file con carica_abbonati, l'archivio viene riscritto e sulla tabella
+* completa vengono attivati il filtro di Bloom e l'indice a hash perfetto.
+* L'archivio resta mappato: modifica_lezioni_abbonato vi aggiorna sul posto i record. Le righe
+* del giornale riportano valori e non differenze, quindi riapplicarle a un archivio che le contiene già
+* non cambia il risultato.
+* Alle chiamate successive confronta questi valori con quelli restituiti da stat:
+* se coincidono restituisce la tabella già in memoria senza leggere i file,
+* altrimenti libera la vecchia tabella e la ricarica. La ricarica libera anche tutti gli abbonati
+* che conteneva: chi conserva la tabella o un puntatore ad abbonato deve richiamare registro_abbonati
+* e ricercare l'abbonato per nome dopo ogni chiamata, anche se fatta da un'altra funzione.
+* Se il giornale riapplicato è già oltre la soglia viene subito compattato nel checkpoint
+*
+* Parametri:
+* nome_file: nome del file degli abbonati
+*
+* Pre-condizione:
+* nome_file è un puntatore a stringa non nullo
+*
+* Post-condizione:
+* Restituisce la tabella aggiornata rispetto al contenuto del file
+*
+* Side-effect:
+* Esegue stat sul file; se serve, lo rilegge e libera la tabella precedente con i suoi abbonati
+*/
+tabella_hash registro_abbonati(const char *nome_file)
+{
+	if (registro.tabella != NULL && strcmp(nome_file, registro.nome_file) == 0 &&
+		!stato_cambiato(registro.nome_file, &registro.checkpoint) &&
+		!stato_cambiato(registro.nome_giornale, &registro.giornale))
+		return registro.tabella;
+
+	distruggi_hash(registro.tabella);
+	chiudi_archivio(registro.archivio);
+	strncpy(registro.nome_file, nome_file, MASSIMO_NOME_FILE - 1);
+	registro.nome_file[MASSIMO_NOME_FILE - 1] = '\0';
+	nome_derivato(registro.nome_file, ".journal", registro.nome_giornale);
+	nome_derivato(registro.nome_file, ".bin", registro.nome_archivio);
+
+	registro.collegato = 0;
+	registro.archivio = apri_archivio(registro.nome_archivio);
+	if (registro.archivio != NULL && archivio_aggiornato(registro.archivio, registro.nome_file))
+	{
+		// Nessun record viene copiato: ogni abbonato passa dall'indice mappato alla tabella al primo uso
+		registro.tabella = nuova_hash(DIMENSIONE_MINIMA);
+		collega_riserva_hash(registro.tabella, riserva_archivio(registro.archivio));
+		registro.collegato = 1;
+	}
+	else
 	{
-        	abbonato *corrente = h->tabella[i];
-		// Scrive gli abbonati
-        	while (corrente != NULL)
+		registro.tabella = carica_abbonati(nome_file);
+		riscrivi_archivio();
+		attiva_bloom_hash(registro.tabella); // Login falliti e ingressi singoli cercano soprattutto nomi assenti
+		costruisci_perfetto_hash(registro.tabella); // I login sono molti più delle iscrizioni
+	}
+	riapplica_giornale(registro.tabella, registro.nome_giornale);
+	memorizza_stato(registro.nome_file, &registro.checkpoint);
+	memorizza_stato(registro.nome_giornale, &registro.giornale);
+
+	if (registro.giornale.dimensione > SOGLIA_MINIMA_GIORNALE &&
+		registro.giornale.dimensione > registro.checkpoint.dimensione)
+		salva_abbonati(registro.tabella, registro.nome_file);
+	return registro.tabella;
+}
+
+/* Funzione: modifica_lezioni_abbonato
+*
+* Aggiunge variazione alle lezioni rimanenti di un abbonato e annota la modifica nel giornale
+*
+* Descrizione:
+* Nel giornale viene scritto il nuovo numero di lezioni e non la variazione: riapplicare
+* più volte la stessa riga (per esempio dopo un'interruzione durante la compattazione)
+* produce sempre lo stesso risultato.
+* Se l'abbonato è nell'archivio binario, il record mappato viene aggiornato sul posto
+*
+* Parametri:
+* utente: abbonato del registro da modificare
+* variazione: lezioni da aggiungere (negativa per toglierle)
+*
+* Pre-condizione:
+* utente è stato ottenuto dalla tabella restituita da registro_abbonati
+*
+* Side-effect:
+* Aggiorna la data dell'ultima attività e aggiunge una riga al giornale
+*/
+void modifica_lezioni_abbonato(abbonato *utente, int variazione)
+{
+	utente->lezioni_rimanenti += variazione;
+	utente->ultima_attivita = time(NULL);
+	record_abbonato *r = registro.archivio ? cerca_archivio(registro.archivio, utente->nomeutente) : NULL;
+	if (r != NULL)
+		aggiorna_lezioni_archivio(r, utente->lezioni_rimanenti, utente->ultima_attivita);
+	annota("L;%s;%d;%lld\n", utente->nomeutente, utente->lezioni_rimanenti, (long long)utente->ultima_attivita);
+}
+
+/* Funzione: accesso_abbonato
+*
+* Registra l'accesso di un abbonato aggiornando la data dell'ultima attività
+*
+* Pre-condizione:
+* utente è stato ottenuto dalla tabella restituita da registro_abbonati
+*
+* Side-effect:
+* Aggiunge una riga al giornale
+*/
+void accesso_abbonato(abbonato *utente)
+{
+	utente->ultima_attivita = time(NULL);
+	annota("A;%s;%lld\n", utente->nomeutente, (long long)utente->ultima_attivita);
+}
+
+/* Funzione: cambia_password_abbonato
+*
+* Sostituisce la password di un abbonato e annota la modifica nel giornale
+*
+* Pre-condizione:
+* utente è stato ottenuto dalla tabella restituita da registro_abbonati,
+* password è una stringa non vuota senza spazi né punti e virgola
+*
+* Side-effect:
+* Aggiunge una riga al giornale
+*/
+void cambia_password_abbonato(abbonato *utente, const char *password)
+{
+	strncpy(utente->password, password, MAX_CARATTERI - 1);
+	utente->password[MAX_CARATTERI - 1] = '\0';
+	annota("P;%s;%s\n", utente->nomeutente, utente->password);
+}
+
+/* Funzione: aggiungi_abbonato_registro
+*
+* Inserisce un nuovo abbonato nel registro e annota l'inserimento nel giornale
+*
+* Parametri:
+* nuovo: abbonato da inserire (chiave uguale al nome utente)
+*
+* Pre-condizione:
+* Il registro è stato caricato con registro_abbonati
+*
+* Post-condizione:
+* Restituisce l'abbonato inserito, NULL se il nome utente era già presente o manca memoria
+*
+* Side-effect:
+* Aggiunge una riga al giornale
+*/
+abbonato *aggiungi_abbonato_registro(abbonato nuovo)
+{
+	if (cerca_hash(nuovo.chiave, registro.tabella) != NULL)
+		return NULL;
+
+	registro.tabella = inserisci_hash(nuovo, registro.tabella);
+	abbonato *inserito = cerca_hash(nuovo.chiave, registro.tabella);
+	if (inserito != NULL)
+		annota("N;%s;%s;%d;%lld\n", inserito->nomeutente, inserito->password,
+			inserito->lezioni_rimanenti, (long long)inserito->ultima_attivita);
+	return inserito;
+}
+
+/* Funzione: chiudi_registro_abbonati
+*
+* Libera la tabella condivisa degli abbonati
+*
+* Side-effect:
+* La prossima chiamata a registro_abbonati rileggerà il file
+*/
+void chiudi_registro_abbonati(void)
+{
+	distruggi_hash(registro.tabella);
+	chiudi_archivio(registro.archivio);
+	registro.tabella = NULL;
+	registro.archivio = NULL;
+	registro.collegato = 0;
+	registro.nome_file[0] = '\0';
+	registro.nome_giornale[0] = '\0';
+	registro.nome_archivio[0] = '\0';
+}
+
+/* Funzione: conta_righe
+*
+* Conta le righe del file e lo riporta all'inizio
+*
+* Pre-condizione:
+* file è aperto in lettura
+*
+* Post-condizione:
+* Restituisce il numero di caratteri '\n' presenti (più uno se l'ultima riga non termina con '\n')
+*/
+static int conta_righe(FILE *file)
+{
+	char blocco[4096];
+	size_t letti;
+	int righe = 0;
+	char ultimo = '\n';
+
+	while ((letti = fread(blocco, 1, sizeof(blocco), file)) > 0)
+	{
+		for (size_t i = 0; i < letti; i++)
+			if (blocco[i] == '\n')
+				righe++;
+		ultimo = blocco[letti - 1];
+	}
+	if (ultimo != '\n')
+		righe++;
+
+	rewind(file);
+	return righe;
+}
+
+/* Funzione: scrivi_abbonato
+*
+* Scrive su file la riga di un abbonato nel formato "nomeutente;password;lezioni_rimanenti;ultima_attivita"
+*/
+static void scrivi_abbonato(abbonato *corrente, void *file)
+{
+	fprintf(file, "%s;%s;%d;%lld\n", corrente->nomeutente, corrente->password, corrente->lezioni_rimanenti,
+		(long long)corrente->ultima_attivita);
+}
+
+/* Funzione: raccogli_inattivo
+*
+* Aggiunge all'elenco la chiave dell'abbonato se non ha lezioni rimanenti ed è inattivo da prima del limite
+*/
+static void raccogli_inattivo(abbonato *corrente, void *elenco)
+{
+	struct da_purgare *e = elenco;
+	if (e->numero < 0 || corrente->lezioni_rimanenti > 0 || corrente->ultima_attivita >= e->limite)
+		return;
+
+	if (e->numero == e->capacita)
+	{
+		int capacita = e->capacita ? e->capacita * 2 : 64;
+		char (*chiavi)[MAX_CARATTERI] = realloc(e->chiavi, capacita * sizeof(*chiavi));
+		if (chiavi == NULL)
 		{
-            		fprintf(file, "%s;%s;%d\n", corrente->nomeutente, corrente->password, corrente->lezioni_rimanenti);
-            		corrente = corrente->prossimo;
-        	}
-    	}
+			e->numero = -1;
+			return;
+		}
+		e->chiavi = chiavi;
+		e->capacita = capacita;
+	}
+	strncpy(e->chiavi[e->numero], corrente->chiave, MAX_CARATTERI - 1);
+	e->chiavi[e->numero][MAX_CARATTERI - 1] = '\0';
+	e->numero++;
+}
+
+/* Funzione: memorizza_stato
+*
+* Salva in stato i dati di stat del file indicato
+*/
+static void memorizza_stato(const char *nome_file, struct stato_file *stato)
+{
+	struct stat info;
+	stato->presente = stat(nome_file, &info) == 0;
+	if (!stato->presente)
+	{
+		stato->dimensione = 0;
+		return;
+	}
+
+	stato->dispositivo = info.st_dev;
+	stato->inode = info.st_ino;
+	stato->dimensione = info.st_size;
+	stato->modifica = info.st_mtim;
+}
+
+/* Funzione: stato_cambiato
+*
+* Verifica se il file è cambiato rispetto allo stato memorizzato
+*
+* Post-condizione:
+* Restituisce 1 se il file è comparso, scomparso o ha inode, dimensione o data di modifica diversi
+*/
+static int stato_cambiato(const char *nome_file, const struct stato_file *stato)
+{
+	struct stat info;
+	int presente = stat(nome_file, &info) == 0;
+	if (presente != stato->presente)
+		return 1;
+	if (!presente)
+		return 0;
+
+	return info.st_dev != stato->dispositivo || info.st_ino != stato->inode ||
+		info.st_size != stato->dimensione ||
+		info.st_mtim.tv_sec != stato->modifica.tv_sec || info.st_mtim.tv_nsec != stato->modifica.tv_nsec;
+}
+
+/* Funzione: nome_derivato
+*
+* Ricava dal nome del checkpoint quello di un file collegato
+* ("abbonati.txt" con ".journal" diventa "abbonati.journal")
+*
+* Pre-condizione:
+* derivato ha spazio per MASSIMO_NOME_FILE caratteri
+*/
+static void nome_derivato(const char *nome_file, const char *estensione, char *derivato)
+{
+	size_t lunghezza = strlen(nome_file);
+	if (lunghezza >= 4 && strcmp(nome_file + lunghezza - 4, ".txt") == 0)
+		lunghezza -= 4;
+	snprintf(derivato, MASSIMO_NOME_FILE, "%.*s%s", (int)lunghezza, nome_file, estensione);
+}
+
+/* Funzione: riscrivi_archivio
+*
+* Riscrive l'archivio binario del registro dalla tabella, che deve corrispondere al checkpoint, e lo riapre
+*
+* Descrizione:
+* Viene chiamata quando il checkpoint è stato appena letto o scritto e il giornale non è ancora
+* stato riapplicato, oppure è stato appena svuotato. Se il checkpoint non esiste non viene scritto nulla.
+* Il vecchio archivio viene chiuso solo alla fine: se la tabella ne prende ancora gli abbonati,
+* viene collegata al nuovo oppure, se non è stato possibile scriverlo, vi copia quelli rimasti
+*/
+static void riscrivi_archivio(void)
+{
+	archivio_abbonati vecchio = registro.archivio;
+	registro.archivio = NULL;
+	if (access(registro.nome_file, F_OK) == 0 &&
+		salva_archivio(registro.tabella, registro.nome_archivio, registro.nome_file) >= 0)
+		registro.archivio = apri_archivio(registro.nome_archivio);
+
+	// Il nuovo archivio contiene anche gli abbonati che la tabella non ha ancora copiato dal vecchio
+	if (registro.collegato && registro.archivio != NULL)
+		collega_riserva_hash(registro.tabella, riserva_archivio(registro.archivio));
+	else if (registro.collegato)
+	{
+		stacca_riserva_hash(registro.tabella);
+		registro.collegato = 0;
+	}
+	chiudi_archivio(vecchio);
+}
+
+/* Funzione: riapplica_giornale
+*
+* Applica alla tabella, in ordine, le modifiche annotate nel giornale
+*
+* Descrizione:
+* Ogni riga inizia con il tipo di modifica:
+* "L;nome;lezioni;attività" nuove lezioni rimanenti, "A;nome;attività" accesso,
+* "P;nome;password" nuova password, "N;nome;password;lezioni;attività" nuovo abbonato,
+* "R;nome" abbonato rimosso.
+* Ogni riga porta il nuovo valore e non la differenza, quindi riapplicare righe già contenute
+* nel checkpoint non cambia il risultato. Le righe incomplete (per esempio l'ultima, se il
+* programma è stato interrotto mentre la scriveva) e quelle su abbonati assenti vengono ignorate
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*/
+static void riapplica_giornale(tabella_hash h, const char *giornale)
+{
+	FILE *file = fopen(giornale, "r");
+	if (!file)
+		return;
+
+	char riga[200];
+	while (fgets(riga, sizeof(riga), file))
+	{
+		if (strchr(riga, '\n') == NULL)
+			break; // Riga troncata: è l'ultima scritta prima di un'interruzione
+
+		char *tipo = strtok(riga, ";\n");
+		char *nomeutente = strtok(NULL, ";\n");
+		if (tipo == NULL || nomeutente == NULL)
+			continue;
+
+		abbonato *utente = cerca_hash(nomeutente, h);
+		char *campo1 = strtok(NULL, ";\n");
+		char *campo2 = strtok(NULL, ";\n");
+		char *campo3 = strtok(NULL, ";\n");
+
+		switch (tipo[0])
+		{
+			case 'L':
+				if (utente && campo1 && campo2)
+				{
+					utente->lezioni_rimanenti = atoi(campo1);
+					utente->ultima_attivita = (time_t)atoll(campo2);
+				}
+				break;
+			case 'A':
+				if (utente && campo1)
+					utente->ultima_attivita = (time_t)atoll(campo1);
+				break;
+			case 'P':
+				if (utente && campo1)
+				{
+					strncpy(utente->password, campo1, MAX_CARATTERI - 1);
+					utente->password[MAX_CARATTERI - 1] = '\0';
+				}
+				break;
+			case 'N':
+				if (!campo1 || !campo2 || !campo3)
+					break;
+				if (utente == NULL)
+				{
+					abbonato nuovo;
+					strncpy(nuovo.nomeutente, nomeutente, MAX_CARATTERI - 1);
+					nuovo.nomeutente[MAX_CARATTERI - 1] = '\0';
+					strncpy(nuovo.password, campo1, MAX_CARATTERI - 1);
+					nuovo.password[MAX_CARATTERI - 1] = '\0';
+					nuovo.lezioni_rimanenti = atoi(campo2);
+					nuovo.ultima_attivita = (time_t)atoll(campo3);
+					nuovo.chiave = nuovo.nomeutente;
+					h = inserisci_hash(nuovo, h);
+					break;
+				}
+				strncpy(utente->password, campo1, MAX_CARATTERI - 1);
+				utente->password[MAX_CARATTERI - 1] = '\0';
+				utente->lezioni_rimanenti = atoi(campo2);
+				utente->ultima_attivita = (time_t)atoll(campo3);
+				break;
+			case 'R':
+				rimuovi_hash(nomeutente, h);
+				break;
+		}
+	}
 
 	fclose(file);
 }
+
+/* Funzione: annota
+*
+* Aggiunge una riga al giornale del registro e, se è diventato troppo grande, lo compatta
+*
+* Descrizione:
+* La riga viene scritta in coda al file: il costo non dipende dal numero di abbonati.
+* Quando il giornale supera sia SOGLIA_MINIMA_GIORNALE sia la dimensione del checkpoint,
+* salva_abbonati riscrive il checkpoint e svuota il giornale; la soglia proporzionale
+* al checkpoint mantiene costante il costo medio di ogni modifica.
+* Se il registro non è stato caricato non viene scritto nulla
+*/
+static void annota(const char *formato, ...)
+{
+	if (registro.tabella == NULL)
+		return;
+
+	// Se il giornale è stato modificato da fuori, la riga non va mescolata a dati che non conosciamo
+	int esterno = stato_cambiato(registro.nome_giornale, &registro.giornale);
+
+	FILE *file = fopen(registro.nome_giornale, "a");
+	if (!file)
+	{
+		printf("Errore nell'apertura del giornale degli abbonati.\n");
+		return;
+	}
+
+	va_list argomenti;
+	va_start(argomenti, formato);
+	vfprintf(file, formato, argomenti);
+	va_end(argomenti);
+	fclose(file);
+
+	if (esterno)
+		return; // Il prossimo registro_abbonati ricaricherà tutto
+	memorizza_stato(registro.nome_giornale, &registro.giornale);
+
+	if (registro.giornale.dimensione > SOGLIA_MINIMA_GIORNALE &&
+		registro.giornale.dimensione > registro.checkpoint.dimensione)
+		salva_abbonati(registro.tabella, registro.nome_file);
+}
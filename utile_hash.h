@@ -8,6 +8,7 @@
 #include "hash.h"
 #include "partecipante.h"
 
+
 /* Funzione: carica_abbonati
 *
 * Carica da file i dati degli abbonati e li inserisce in una nuova tabella hash
@@ -39,8 +40,130 @@ tabella_hash carica_abbonati(const char *nome_file);
 * h è una tabella hash valida e nome_file è un puntatore a stringa non nullo
 *
 * Side-effect:
-* Scrittura su file. Se il file non può essere aperto, viene stampato un messaggio di errore
+* Scrittura su file (tramite un file temporaneo rinominato a scrittura completata).
+* Se h è la tabella del registro viene riscritto anche l'archivio binario.
+* Se il file non può essere aperto, viene stampato un messaggio di errore.
+* Se h è la tabella del registro, il file diventa il nuovo checkpoint: il giornale delle modifiche
+* viene svuotato e il registro prende nota del nuovo stato dei file così da non ricaricarli inutilmente
 */
 void salva_abbonati(tabella_hash h, const char *nome_file);
 
+/* Funzione: purga_abbonati
+*
+* Rimuove dalla tabella gli abbonati senza lezioni rimanenti e inattivi da prima di limite
+*
+* Parametri:
+* h: tabella hash da cui rimuovere gli abbonati
+* limite: istante prima del quale un abbonato è considerato inattivo
+*
+* Pre-condizione:
+* h è una tabella hash valida
+*
+* Post-condizione:
+* Restituisce il numero di abbonati rimossi, -1 in caso di errore di allocazione
+*
+* Side-effect:
+* I puntatori agli abbonati rimossi non sono più validi. Le rimozioni dalla tabella del registro
+* vengono annotate nel giornale; per le altre tabelle il file va riscritto con salva_abbonati
+*/
+int purga_abbonati(tabella_hash h, time_t limite);
+
+/* Funzione: registro_abbonati
+*
+* Restituisce la tabella degli abbonati condivisa da tutto il programma
+*
+* Parametri:
+* nome_file: nome del file degli abbonati
+*
+* Pre-condizione:
+* nome_file è un puntatore a stringa non nullo
+*
+* Post-condizione:
+* Restituisce la tabella caricata da nome_file, con applicate le modifiche annotate nel giornale
+* (nome_file con estensione .journal). Se l'archivio binario (nome_file con estensione .bin)
+* è stato scritto dalla versione attuale di nome_file, la tabella parte vuota e prende dai record mappati
+* solo gli abbonati cercati; altrimenti l'archivio viene riscritto. I file vengono letti solo alla prima chiamata
+* o quando sono stati modificati da fuori (data di modifica, inode o dimensione diversi).
+* La tabella e i puntatori ad abbonati ottenuti da essa restano validi fino alla prossima chiamata
+* che ricarica il file o a chiudi_registro_abbonati: dopo ogni chiamata, anche fatta da altre funzioni,
+* chi li conserva deve usare la tabella restituita e ricercare l'abbonato per nome
+*
+* Side-effect:
+* Esegue stat sul file; se serve, lo rilegge e libera la tabella precedente.
+* L'archivio binario resta mappato fino a chiudi_registro_abbonati. Se la tabella è stata
+* caricata dal testo vi vengono attivati il filtro di Bloom (attiva_bloom_hash)
+* e l'indice a hash perfetto (costruisci_perfetto_hash)
+*/
+tabella_hash registro_abbonati(const char *nome_file);
+
+/* Funzione: modifica_lezioni_abbonato
+*
+* Aggiunge variazione alle lezioni rimanenti di un abbonato del registro
+*
+* Parametri:
+* utente: abbonato da modificare
+* variazione: lezioni da aggiungere (negativa per toglierle)
+*
+* Pre-condizione:
+* utente è stato ottenuto dalla tabella restituita da registro_abbonati
+*
+* Side-effect:
+* Aggiorna la data dell'ultima attività e aggiunge una riga al giornale, senza riscrivere
+* il file degli abbonati (tranne quando il giornale va compattato); aggiorna sul posto il record
+* dell'abbonato nell'archivio binario, se c'è
+*/
+void modifica_lezioni_abbonato(abbonato *utente, int variazione);
+
+/* Funzione: accesso_abbonato
+*
+* Registra l'accesso di un abbonato del registro aggiornando la data dell'ultima attività
+*
+* Pre-condizione:
+* utente è stato ottenuto dalla tabella restituita da registro_abbonati
+*
+* Side-effect:
+* Aggiunge una riga al giornale
+*/
+void accesso_abbonato(abbonato *utente);
+
+/* Funzione: cambia_password_abbonato
+*
+* Sostituisce la password di un abbonato del registro
+*
+* Pre-condizione:
+* utente è stato ottenuto dalla tabella restituita da registro_abbonati,
+* password è una stringa non vuota senza spazi né punti e virgola
+*
+* Side-effect:
+* Aggiunge una riga al giornale
+*/
+void cambia_password_abbonato(abbonato *utente, const char *password);
+
+/* Funzione: aggiungi_abbonato_registro
+*
+* Inserisce un nuovo abbonato nella tabella del registro
+*
+* Parametri:
+* nuovo: abbonato da inserire, con chiave uguale al nome utente
+*
+* Pre-condizione:
+* Il registro è stato caricato con registro_abbonati
+*
+* Post-condizione:
+* Restituisce l'abbonato inserito, NULL se il nome utente era già presente o manca memoria
+*
+* Side-effect:
+* Aggiunge una riga al giornale
+*/
+abbonato *aggiungi_abbonato_registro(abbonato nuovo);
+
+/* Funzione: chiudi_registro_abbonati
+*
+* Libera la tabella condivisa degli abbonati
+*
+* Side-effect:
+* La prossima chiamata a registro_abbonati rileggerà il file
+*/
+void chiudi_registro_abbonati(void);
+
 #endif